@@ -2,8 +2,9 @@
 
 #include <webgpu/webgpu.h>
 
-#include <vector>
+#include <map>
 #include <optional>
+#include <vector>
 
 namespace WebGPUlib
 {
@@ -16,10 +17,20 @@ class BindGroup
 {
 public:
     void bind( uint32_t binding, WGPUBuffer buffer, uint64_t offset, uint64_t size );
+    // The offset is relative to the start of the buffer, also for buffers that are allocated from a buffer arena.
     void bind( uint32_t binding, const Buffer& buffer, uint64_t offset = 0, std::optional<uint64_t> size = {} );
     void bind( uint32_t binding, const Sampler& sampler );
     void bind( uint32_t binding, const TextureView& textureView );
 
+    // Bind a buffer with a dynamic offset. The bind group entry always starts at the beginning of
+    // the buffer so the same WGPUBindGroup can be reused when only the offset changes.
+    // The binding must be declared with hasDynamicOffset in the bind group layout.
+    void bindDynamic( uint32_t binding, WGPUBuffer buffer, uint32_t dynamicOffset, uint64_t size );
+
+    // Get the dynamic offsets, sorted by binding number.
+    const std::vector<uint32_t>& getDynamicOffsets() const;
+
+    // Get a bind group for the layout. The bind group is owned by the device's bind group cache.
     WGPUBindGroup getWGPUBindGroup( WGPUBindGroupLayout layout ) const;
 
 protected:
@@ -28,6 +39,7 @@ protected:
 
 private:
     std::vector<WGPUBindGroupEntry> bindings;
-    mutable WGPUBindGroup           bindGroup = nullptr;
+    std::map<uint32_t, uint32_t>    dynamicOffsets;
+    mutable std::vector<uint32_t>   dynamicOffsetArray;
 };
 }  // namespace WebGPUlib
\ No newline at end of file
@@ -0,0 +1,75 @@
+#pragma once
+
+#include <webgpu/webgpu.h>
+
+#include <cstddef>
+#include <list>
+#include <unordered_map>
+#include <vector>
+
+namespace WebGPUlib
+{
+
+// Caches WGPUBindGroup objects keyed by the bind group layout and the bind group entries.
+// Bind groups that have not been used for a number of frames are released, and the
+// least recently used bind group is evicted when the cache is full.
+// Each cached bind group keeps a reference on its layout and resources until it is released.
+class BindGroupCache
+{
+public:
+    explicit BindGroupCache( std::size_t maxSize = 4096, uint64_t maxAge = 3 );
+    ~BindGroupCache();
+
+    BindGroupCache( const BindGroupCache& )                = delete;
+    BindGroupCache( BindGroupCache&& ) noexcept            = delete;
+    BindGroupCache& operator=( const BindGroupCache& )     = delete;
+    BindGroupCache& operator=( BindGroupCache&& ) noexcept = delete;
+
+    // Get a bind group for the layout and entries. The returned bind group is owned by the cache.
+    WGPUBindGroup getBindGroup( WGPUBindGroupLayout layout, const std::vector<WGPUBindGroupEntry>& entries );
+
+    // Release bind groups that were not used in the last maxAge frames.
+    void endFrame();
+
+    // Release all cached bind groups.
+    void clear();
+
+    std::size_t size() const noexcept
+    {
+        return lruList.size();
+    }
+
+    uint64_t getHitCount() const noexcept
+    {
+        return hitCount;
+    }
+
+    uint64_t getMissCount() const noexcept
+    {
+        return missCount;
+    }
+
+private:
+    struct Entry
+    {
+        WGPUBindGroupLayout             layout = nullptr;
+        std::vector<WGPUBindGroupEntry> entries;
+        std::size_t                     hash          = 0;
+        WGPUBindGroup                   bindGroup     = nullptr;
+        uint64_t                        lastUsedFrame = 0;
+    };
+
+    // Most recently used entries are at the front of the list.
+    using LRUList = std::list<Entry>;
+
+    void evict( LRUList::iterator it );
+
+    LRUList                                                 lruList;
+    std::unordered_multimap<std::size_t, LRUList::iterator> lookup;
+    std::size_t                                             maxSize;
+    uint64_t                                                maxAge;
+    uint64_t                                                currentFrame = 0;
+    uint64_t                                                hitCount     = 0;
+    uint64_t                                                missCount    = 0;
+};
+}  // namespace WebGPUlib
@@ -0,0 +1,36 @@
+#pragma once
+
+#include <glm/mat4x4.hpp>
+#include <glm/vec3.hpp>
+
+#include <cfloat>
+
+namespace WebGPUlib
+{
+
+// Axis-aligned bounding box. A default constructed bounding box is empty (invalid)
+// and grows as points or other bounding boxes are merged into it.
+struct BoundingBox
+{
+    BoundingBox() = default;
+    BoundingBox( const glm::vec3& min, const glm::vec3& max )
+    : min( min )
+    , max( max )
+    {}
+
+    // A bounding box is valid if it contains at least one point.
+    bool isValid() const;
+
+    glm::vec3 getCenter() const;
+    glm::vec3 getExtents() const;
+
+    void merge( const glm::vec3& point );
+    void merge( const BoundingBox& boundingBox );
+
+    // Compute the axis-aligned bounding box that encloses this bounding box after it is transformed.
+    BoundingBox transform( const glm::mat4& transform ) const;
+
+    glm::vec3 min { FLT_MAX };
+    glm::vec3 max { -FLT_MAX };
+};
+}  // namespace WebGPUlib
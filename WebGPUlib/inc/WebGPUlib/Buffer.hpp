@@ -2,6 +2,7 @@
 
 #include <webgpu/webgpu.h>
 #include <cstddef>
+#include <cstdint>
 
 
 namespace WebGPUlib
@@ -23,11 +24,19 @@ public:
         return buffer;
     }
 
+    // The offset of the buffer data in the WGPUBuffer.
+    // Only buffers that are allocated from a buffer arena have a non-zero offset.
+    uint64_t getOffset() const
+    {
+        return offset;
+    }
+
 protected:
-    Buffer( WGPUBuffer&& buffer );
+    Buffer( WGPUBuffer&& buffer, uint64_t offset = 0 );
     virtual ~Buffer();
 
 private:
     WGPUBuffer buffer = nullptr;
+    uint64_t   offset = 0;
 };
 }  // namespace WebGPUlib
\ No newline at end of file
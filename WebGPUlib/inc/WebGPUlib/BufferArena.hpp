@@ -0,0 +1,61 @@
+#pragma once
+
+#include "Defines.hpp"
+
+#include <webgpu/webgpu.h>
+
+#include <cstddef>
+#include <cstdint>
+#include <map>
+#include <optional>
+
+namespace WebGPUlib
+{
+
+// A large GPU buffer that is shared by many smaller buffers.
+// Free ranges are tracked in a first-fit free list that is coalesced when ranges are freed.
+class BufferArena
+{
+public:
+    BufferArena( WGPUBufferUsage usage, std::size_t size = _64MB, const char* label = nullptr );
+    ~BufferArena();
+
+    BufferArena( const BufferArena& )            = delete;
+    BufferArena( BufferArena&& )                 = delete;
+    BufferArena& operator=( const BufferArena& ) = delete;
+    BufferArena& operator=( BufferArena&& )      = delete;
+
+    // Allocate a range of the arena. The offset of the allocation is a multiple of the alignment.
+    // Returns an empty optional if there is no free range that is large enough.
+    std::optional<uint64_t> allocate( std::size_t sizeInBytes, std::size_t alignment );
+
+    // Return a range that was allocated with allocate to the arena.
+    void free( uint64_t offset, std::size_t sizeInBytes );
+
+    // Get a new reference to the arena buffer. The caller must release the reference.
+    WGPUBuffer referenceWGPUBuffer() const;
+
+    WGPUBuffer getWGPUBuffer() const noexcept
+    {
+        return buffer;
+    }
+
+    std::size_t getSize() const noexcept
+    {
+        return size;
+    }
+
+    std::size_t getUsedSize() const noexcept
+    {
+        return usedSize;
+    }
+
+private:
+    WGPUBuffer  buffer   = nullptr;
+    std::size_t size     = 0;
+    std::size_t usedSize = 0;
+
+    // Free ranges, keyed by offset.
+    std::map<uint64_t, std::size_t> freeRanges;
+};
+}  // namespace WebGPUlib
@@ -1,5 +1,7 @@
 #pragma once
 
+#include "UploadPagePool.hpp"
+
 #include <webgpu/webgpu.h>
 
 #include <vector>
@@ -28,6 +30,13 @@ public:
     void bindSampler( uint32_t groupIndex, uint32_t binding, const Sampler& sampler );
     void bindTexture( uint32_t groupIndex, uint32_t binding, const TextureView& texture );
 
+    // Bind a range of a buffer to a binding that is declared with hasDynamicOffset in the bind group layout.
+    // Binding the same buffer and size with a different dynamic offset reuses the bind group.
+    void bindBufferDynamic( uint32_t groupIndex, uint32_t binding, const Buffer& buffer, uint32_t dynamicOffset,
+                            uint64_t size );
+
+    // Dynamic buffers are allocated from an upload buffer and bound with a dynamic offset.
+    // The binding must be declared with hasDynamicOffset in the bind group layout.
     void bindDynamicUniformBuffer( uint32_t groupIndex, uint32_t binding, const void* data, std::size_t sizeInBytes );
     template<typename T>
     void bindDynamicUniformBuffer( uint32_t groupIndex, uint32_t binding, const T& data );
@@ -41,23 +50,93 @@ public:
         return commandEncoder;
     }
 
+    // The number of state changes that were issued to the encoder and the number of redundant
+    // state changes that were skipped because the state was already set.
+    struct Statistics
+    {
+        uint32_t pipelinesSet         = 0;
+        uint32_t pipelinesSkipped     = 0;
+        uint32_t bindGroupsSet        = 0;
+        uint32_t bindGroupsSkipped    = 0;
+        uint32_t vertexBuffersSet     = 0;
+        uint32_t vertexBuffersSkipped = 0;
+        uint32_t indexBuffersSet      = 0;
+        uint32_t indexBuffersSkipped  = 0;
+        uint32_t drawCount            = 0;  // Draws or dispatches.
+    };
+
+    const Statistics& getStatistics() const noexcept
+    {
+        return statistics;
+    }
+
 protected:
+    // A vertex or index buffer binding, used to skip redundant state changes.
+    struct BufferBinding
+    {
+        WGPUBuffer buffer = nullptr;
+        uint64_t   offset = 0;
+        uint64_t   size   = 0;
+
+        bool operator==( const BufferBinding& other ) const
+        {
+            return buffer == other.buffer && offset == other.offset && size == other.size;
+        }
+    };
+
     CommandBuffer( WGPUCommandEncoder&& commandEncoder );
     virtual ~CommandBuffer();
 
     friend class Queue;
     virtual WGPUCommandBuffer finish() = 0;
 
-    // Reset dynamic upload buffers.
+    // Write the dynamic upload buffers to the GPU.
+    // Must be called before the command buffer is submitted to the queue.
+    void flush();
+
+    // Return the pages used by the dynamic upload buffers to the upload page pool.
+    // Must be called after the command buffer has been submitted to the queue.
     void reset();
 
+    // Take the pages used by the dynamic upload buffers.
+    UploadPagePool::PageList releaseUploadPages();
+
     virtual void setBindGroup( uint32_t groupIndex, const BindGroup& bindGroup ) = 0;
-    std::shared_ptr<BindGroup> getBindGroup( uint32_t groupIndex );
 
+    // Get the bind group and mark it as changed.
+    BindGroup& getBindGroup( uint32_t groupIndex );
+
+    // Set the bind groups that have changed since they were last set.
     void commitBindGroups();
 
+    // Record that a bind group is set on the encoder.
+    // Returns false if the same bind group with the same dynamic offsets is already set.
+    bool updateBindGroupState( uint32_t groupIndex, WGPUBindGroup bindGroup,
+                               const std::vector<uint32_t>& dynamicOffsets );
+
+    // The bind groups have to be resolved again when the pipeline (and its bind group layouts) changes.
+    void invalidateBindGroups()
+    {
+        dirtyBindGroups = ~0u;
+    }
+
+    // Forget the bind groups that are set on the encoder (for example, after executing a render bundle).
+    void resetBindGroupState();
+
     WGPUCommandEncoder commandEncoder = nullptr;
     std::vector<std::shared_ptr<BindGroup>> bindGroups;
+
+    // A bind group that is set on the encoder, used to skip redundant state changes.
+    struct BindGroupState
+    {
+        WGPUBindGroup         bindGroup = nullptr;
+        std::vector<uint32_t> dynamicOffsets;
+    };
+
+    std::vector<BindGroupState> currentBindGroups;
+    uint32_t                    dirtyBindGroups = ~0u;  // One bit for each bind group that has changed.
+
+    Statistics statistics;
     std::unique_ptr<UploadBuffer>           uniformUploadBuffer;
     std::unique_ptr<UploadBuffer>           storageUploadBuffer;
 };
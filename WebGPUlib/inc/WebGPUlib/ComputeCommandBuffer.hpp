@@ -35,5 +35,6 @@ protected:
 private:
     WGPUComputePassEncoder passEncoder          = nullptr;
     ComputePipelineState*  currentPipelineState = nullptr;
+    WGPUComputePipeline    currentPipeline      = nullptr;
 };
 }  // namespace WebGPUlib
\ No newline at end of file
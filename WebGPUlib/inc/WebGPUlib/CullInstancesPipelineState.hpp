@@ -0,0 +1,81 @@
+#pragma once
+
+#include "ComputePipelineState.hpp"
+
+#include <glm/mat4x4.hpp>
+#include <glm/vec2.hpp>
+#include <glm/vec3.hpp>
+#include <glm/vec4.hpp>
+
+#include <cstdint>
+
+namespace WebGPUlib
+{
+// The culling phases. Must match the PHASE constants in CullInstances.wgsl.
+enum class CullPhase : uint32_t
+{
+    Frustum = 0,  // Frustum culling only.
+    Early   = 1,  // The instances that were visible in the previous frame.
+    Late    = 2,  // The instances that are not occluded by the Hi-Z pyramid and were not drawn in the early phase.
+};
+
+struct CullParameters
+{
+    glm::vec4 planes[6] {};  // The frustum planes in world space.
+    glm::mat4 viewProjection { 1 };
+    glm::vec2 depthSize { 0 };  // The size of the depth texture the Hi-Z pyramid was built from.
+    uint32_t  instanceCount = 0;
+    uint32_t  hiZMipCount   = 0;
+    CullPhase phase         = CullPhase::Frustum;
+    uint32_t  padding[3] {};
+};
+
+// An instance of a mesh in the scene. Must match the Instance struct in CullInstances.wgsl.
+struct CullInstance
+{
+    glm::mat4 model;
+    glm::mat4 modelIT;    // Inverse-transpose
+    glm::vec3 minBounds;  // World space bounds.
+    uint32_t  drawIndex;
+    glm::vec3 maxBounds;
+    uint32_t  padding;
+};
+
+// The arguments of an indexed indirect draw.
+struct DrawIndexedIndirectArguments
+{
+    uint32_t indexCount;
+    uint32_t instanceCount;
+    uint32_t firstIndex;
+    int32_t  baseVertex;
+    uint32_t firstInstance;
+};
+
+// Tests the bounds of all instances against the view frustum (and a Hi-Z pyramid) and writes the
+// matrices of the visible instances and the instance counts of the indirect draws.
+class CullInstancesPipelineState : public ComputePipelineState
+{
+public:
+    static constexpr uint32_t GroupSize = 64;
+
+    CullInstancesPipelineState();
+    ~CullInstancesPipelineState() override;
+
+    CullInstancesPipelineState( const CullInstancesPipelineState& )                = delete;
+    CullInstancesPipelineState( CullInstancesPipelineState&& ) noexcept            = delete;
+    CullInstancesPipelineState& operator=( const CullInstancesPipelineState& )     = delete;
+    CullInstancesPipelineState& operator=( CullInstancesPipelineState&& ) noexcept = delete;
+
+    WGPUBindGroupLayout getWGPUBindGroupLayout( uint32_t groupIndex ) override
+    {
+        // This pipeline only has a single bind group.
+        return bindGroupLayout;
+    }
+
+protected:
+    void bind( ComputeCommandBuffer& commandBuffer ) override;
+
+private:
+    WGPUBindGroupLayout bindGroupLayout = nullptr;
+};
+}  // namespace WebGPUlib
@@ -1,9 +1,12 @@
 #pragma once
 
+#include "Vertex.hpp"
+
 #include <filesystem>
 #include <webgpu/webgpu.h>
 
 #include <memory>
+#include <string>
 #include <vector>
 
 struct SDL_Window;
@@ -12,9 +15,12 @@ namespace WebGPUlib
 {
 
 class BindGroup;
+class BindGroupCache;
+class BufferArena;
 class Queue;
 class IndexBuffer;
 class Mesh;
+class RenderTarget;
 class Sampler;
 class Scene;
 class Surface;
@@ -23,6 +29,13 @@ class Texture;
 class UniformBuffer;
 class VertexBuffer;
 class GenerateMipsPipelineState;
+class GenerateMipsSinglePassPipelineState;
+class GPUProfiler;
+class TextureCache;
+struct TextureLoadOptions;
+struct CompressedImage;
+class ThreadPool;
+class UploadPagePool;
 
 class Device
 {
@@ -34,25 +47,75 @@ public:
     Device& operator=( Device&& )      = delete;
 
     static void    create( SDL_Window* window );
+    // Create a device without a window or surface. Rendering goes to an offscreen render target.
+    // Set forceFallbackAdapter to run on a software adapter (SwiftShader, lavapipe).
+    static void    createHeadless( uint32_t width, uint32_t height, bool forceFallbackAdapter = false );
     static void    destroy();
     static Device& get();
 
     // Get the device queue.
     std::shared_ptr<Queue> getQueue() const;
 
-    // Get the surface.
+    // Get the surface. Returns nullptr for a headless device.
     std::shared_ptr<Surface> getSurface() const;
 
-    std::shared_ptr<Mesh> createCube( float size = 1.0f, bool reverseWinding = false ) const;
-    std::shared_ptr<Mesh> createSphere( float radius = 0.5f, uint32_t tessellation = 16, bool reverseWinding = false );
+    // Get the offscreen render target. Returns nullptr if the device was created with a window.
+    std::shared_ptr<RenderTarget> getOffscreenRenderTarget() const;
+
+    // Get the color texture of the offscreen render target.
+    std::shared_ptr<Texture> getOffscreenColorTexture() const;
+
+    // Get the color format of the surface or the offscreen render target.
+    WGPUTextureFormat getColorFormat() const;
+
+    bool isHeadless() const noexcept
+    {
+        return offscreenRenderTarget != nullptr;
+    }
+
+    std::shared_ptr<Mesh>
+        createCube( float size = 1.0f, bool reverseWinding = false,
+                    VertexLayout vertexLayout = VertexLayout::PositionNormalTangentBitangentTexture ) const;
+    std::shared_ptr<Mesh>
+        createSphere( float radius = 0.5f, uint32_t tessellation = 16, bool reverseWinding = false,
+                      VertexLayout vertexLayout = VertexLayout::PositionNormalTangentBitangentTexture );
 
     std::shared_ptr<Texture> createTexture( const WGPUTextureDescriptor& textureDescriptor );
 
+    // Load a texture file. Textures that are still referenced are shared through the texture cache.
     std::shared_ptr<Texture> loadTexture( const std::filesystem::path& filePath );
+    std::shared_ptr<Texture> loadTexture( const std::filesystem::path& filePath, const TextureLoadOptions& options );
 
     void generateMips( Texture& texture );
 
+    // Generate the mips of multiple textures with a single compute pass and submit.
+    void generateMips( const std::vector<Texture*>& textures );
+
+    // Generate the mips of multiple textures with a single dispatch per texture.
+    // Textures that are larger than 4096x4096 use generateMips instead, as do all textures
+    // if the device does not support enough storage textures per shader stage.
+    // The last workgroup reads the texels written by the other workgroups, which the WGSL memory model does not
+    // guarantee to be visible, so this relies on implementation behaviour. Prefer generateMips.
+    void generateMipsSinglePass( const std::vector<Texture*>& textures );
+
+    bool isSinglePassMipsSupported() const noexcept
+    {
+        return singlePassMipsSupported;
+    }
+
+    // Check if the device supports BC compressed textures.
+    // If not, textures that are loaded with the compress option are uploaded uncompressed.
+    bool isTextureCompressionBCSupported() const noexcept
+    {
+        return textureCompressionBCSupported;
+    }
+
+    // Load a scene file. The texture load options are used for all textures of the scene
+    // (normal maps are always loaded with the normalMap option).
     std::shared_ptr<Scene> loadScene( const std::filesystem::path& filePath );
+    std::shared_ptr<Scene> loadScene(
+        const std::filesystem::path& filePath, const TextureLoadOptions& textureLoadOptions,
+        VertexLayout vertexLayout = VertexLayout::PositionNormalTangentBitangentTexture );
 
     template<typename T>
     std::shared_ptr<VertexBuffer> createVertexBuffer( const std::vector<T>& vertices ) const;
@@ -72,6 +135,10 @@ public:
     std::shared_ptr<StorageBuffer> createStorageBuffer( const std::vector<T>& data ) const;
     std::shared_ptr<StorageBuffer> createStorageBuffer( const void* data, std::size_t elementCount, std::size_t elementSize ) const;
 
+    // Create a storage buffer that can also be used as the argument buffer of indirect draws.
+    std::shared_ptr<StorageBuffer> createIndirectBuffer( const void* data, std::size_t elementCount,
+                                                         std::size_t elementSize ) const;
+
     std::shared_ptr<Sampler> createSampler( const WGPUSamplerDescriptor& samplerDescriptor ) const;
 
     std::shared_ptr<Texture> getDefaultWhiteTexture() const;
@@ -80,6 +147,41 @@ public:
 
     void poll( bool sleep = false );
 
+    // Wait until the GPU has finished all submitted work.
+    void waitIdle();
+
+    // Call once at the end of every frame to retire unused cached objects.
+    void endFrame();
+
+    BindGroupCache& getBindGroupCache() const noexcept
+    {
+        return *bindGroupCache;
+    }
+
+    // Get the upload page pool that is shared by all command buffers.
+    UploadPagePool& getUploadPagePool() const noexcept
+    {
+        return *uploadPagePool;
+    }
+
+    // Get the GPU profiler. The profiler is disabled if the device does not support timestamp queries.
+    GPUProfiler& getGPUProfiler() const noexcept
+    {
+        return *gpuProfiler;
+    }
+
+    // Get the cache of textures that were loaded from files.
+    TextureCache& getTextureCache() const noexcept
+    {
+        return *textureCache;
+    }
+
+    // Get the thread pool for CPU work like decoding textures. Tasks must not use the device.
+    ThreadPool& getThreadPool() const noexcept
+    {
+        return *threadPool;
+    }
+
     WGPUInstance getWGPUInstance() const noexcept
     {
         return instance;
@@ -92,9 +194,31 @@ public:
 
 private:
     friend struct std::default_delete<Device>;
-    Device( SDL_Window* window );
+    Device( SDL_Window* window, uint32_t width, uint32_t height, bool forceFallbackAdapter );
     ~Device();
 
+    void createOffscreenRenderTarget( uint32_t width, uint32_t height );
+
+    // Create a texture from RGBA8 pixels, upload the pixels, and generate the mips.
+    std::shared_ptr<Texture> createTextureFromPixels( const unsigned char* pixels, int width, int height,
+                                                      const std::string& label, const TextureLoadOptions& options );
+
+    // Create a vertex buffer for a mesh, converting the vertices to the requested vertex layout.
+    std::shared_ptr<VertexBuffer>
+        createMeshVertexBuffer( const std::vector<VertexPositionNormalTangentBitangentTexture>& vertices,
+                                VertexLayout                                                    vertexLayout ) const;
+
+    std::shared_ptr<StorageBuffer> createStorageBuffer( const void* data, std::size_t elementCount,
+                                                        std::size_t elementSize, WGPUBufferUsageFlags usage ) const;
+
+    // Create a block compressed texture and upload all of its mips.
+    std::shared_ptr<Texture> createCompressedTexture( const CompressedImage& image, const std::string& label );
+
+    // Allocate a range from one of the arenas, or create a new arena if none of the arenas has enough space.
+    std::pair<std::shared_ptr<BufferArena>, uint64_t>
+        allocateFromArena( std::vector<std::shared_ptr<BufferArena>>& arenas, WGPUBufferUsage usage,
+                           std::size_t sizeInBytes, std::size_t alignment, const char* label ) const;
+
     static void onDeviceLostCallback( WGPUDeviceLostReason reason, char const* message, void* userdata );
     static void onUncapturedErrorCallback( WGPUErrorType type, const char* message, void* userdata );
 
@@ -106,7 +230,31 @@ private:
     std::shared_ptr<Texture> whiteTexture = nullptr;
     std::shared_ptr<Texture> magentaTexture = nullptr;
 
+    std::shared_ptr<Texture>      offscreenColorTexture = nullptr;
+    std::shared_ptr<Texture>      offscreenDepthTexture = nullptr;
+    std::shared_ptr<RenderTarget> offscreenRenderTarget = nullptr;
+
     std::unique_ptr<GenerateMipsPipelineState> generateMipsPipelineState;
+    std::shared_ptr<Texture>                   generateMipsDummyTexture;
+    std::shared_ptr<Sampler>                   generateMipsSampler;
+    std::shared_ptr<UniformBuffer>             generateMipsUniformBuffer;
+
+    std::unique_ptr<GenerateMipsSinglePassPipelineState> generateMipsSinglePassPipelineState;
+    std::shared_ptr<Texture>                             generateMipsSinglePassDummyTexture;
+    std::shared_ptr<StorageBuffer>                       generateMipsSinglePassCounterBuffer;
+    std::shared_ptr<StorageBuffer>                       generateMipsSinglePassMip6Buffer;
+    std::shared_ptr<UniformBuffer>                       generateMipsSinglePassUniformBuffer;
+    bool                                                 singlePassMipsSupported       = false;
+    bool                                                 textureCompressionBCSupported = false;
+    std::unique_ptr<BindGroupCache>            bindGroupCache;
+    std::unique_ptr<UploadPagePool>            uploadPagePool;
+    std::unique_ptr<GPUProfiler>               gpuProfiler;
+    std::unique_ptr<ThreadPool>                threadPool;
+    std::unique_ptr<TextureCache>              textureCache;
+
+    // Vertex and index buffers are suballocated from a few large buffers.
+    mutable std::vector<std::shared_ptr<BufferArena>> vertexArenas;
+    mutable std::vector<std::shared_ptr<BufferArena>> indexArenas;
 };
 
 template<typename T>
@@ -0,0 +1,64 @@
+#pragma once
+
+#include "BoundingBox.hpp"
+
+#include <glm/mat4x4.hpp>
+#include <glm/vec4.hpp>
+
+#include <cstddef>
+#include <cstdint>
+
+namespace WebGPUlib
+{
+
+// View frustum defined by 6 planes that point into the frustum.
+class Frustum
+{
+public:
+    enum class Containment
+    {
+        Outside,
+        Intersects,
+        Inside,
+    };
+
+    Frustum() = default;
+
+    // Extract the frustum planes from a view-projection matrix with a depth range of [0, 1].
+    // Pass a projection matrix to get the frustum in view space, or a view-projection matrix
+    // to get the frustum in world space.
+    explicit Frustum( const glm::mat4& viewProjection );
+
+    Containment contains( const BoundingBox& boundingBox ) const;
+
+    bool intersects( const BoundingBox& boundingBox ) const
+    {
+        return contains( boundingBox ) != Containment::Outside;
+    }
+
+    // Test an array of bounding boxes against the frustum.
+    // visible[i] is set to 1 if boundingBoxes[i] intersects the frustum, and 0 otherwise.
+    // Four bounding boxes are tested at a time if SSE is available.
+    void cull( const BoundingBox* boundingBoxes, std::size_t count, uint8_t* visible ) const;
+
+    enum Plane
+    {
+        Left,
+        Right,
+        Bottom,
+        Top,
+        Near,
+        Far,
+        NumPlanes
+    };
+
+    const glm::vec4& getPlane( Plane plane ) const
+    {
+        return planes[plane];
+    }
+
+private:
+    // The plane equations (xyz: normal, w: distance).
+    glm::vec4 planes[NumPlanes] {};
+};
+}  // namespace WebGPUlib
@@ -0,0 +1,96 @@
+#pragma once
+
+#include <webgpu/webgpu.h>
+
+#include <array>
+#include <cstdint>
+#include <optional>
+#include <string>
+#include <vector>
+
+namespace WebGPUlib
+{
+class Queue;
+
+// Measures the GPU time of render and compute passes with timestamp queries.
+// Each frame uses its own query set and readback buffer from a small ring, so the
+// results can be read back a few frames later without waiting for the GPU.
+// The profiler is disabled if the device was not created with the timestamp query feature.
+class GPUProfiler
+{
+public:
+    // The GPU time of a single pass.
+    struct PassTiming
+    {
+        std::string name;
+        double      milliseconds = 0.0;
+    };
+
+    // The number of frames that can be in flight before the profiler skips a frame.
+    static constexpr uint32_t FrameCount = 4;
+
+    explicit GPUProfiler( WGPUDevice device, uint32_t maxPassesPerFrame = 32 );
+    ~GPUProfiler();
+
+    GPUProfiler( const GPUProfiler& )            = delete;
+    GPUProfiler( GPUProfiler&& )                 = delete;
+    GPUProfiler& operator=( const GPUProfiler& ) = delete;
+    GPUProfiler& operator=( GPUProfiler&& )      = delete;
+
+    bool isEnabled() const noexcept
+    {
+        return enabled;
+    }
+
+    // Allocate the timestamp queries for a pass in the current frame.
+    // Returns an empty optional if the profiler is disabled, the frame has no more free queries,
+    // or the results of the frame that previously used the queries have not been read back yet.
+    std::optional<WGPURenderPassTimestampWrites>  getRenderPassTimestampWrites( const char* passName );
+    std::optional<WGPUComputePassTimestampWrites> getComputePassTimestampWrites( const char* passName );
+
+    // Resolve the queries of the current frame and start reading them back.
+    // Call once at the end of every frame, after the frame has been submitted.
+    void endFrame( const Queue& queue );
+
+    // Get the pass timings of the most recent frame that has been read back.
+    const std::vector<PassTiming>& getPassTimings() const noexcept
+    {
+        return passTimings;
+    }
+
+    // The frame number of the pass timings. This lags a few frames behind the current frame.
+    uint64_t getPassTimingsFrameNumber() const noexcept
+    {
+        return passTimingsFrameNumber;
+    }
+
+    // Check if there are readback buffers waiting to be mapped.
+    bool hasPendingReadbacks() const noexcept;
+
+private:
+    struct Frame
+    {
+        GPUProfiler*             profiler       = nullptr;
+        WGPUQuerySet             querySet       = nullptr;
+        WGPUBuffer               resolveBuffer  = nullptr;
+        WGPUBuffer               readbackBuffer = nullptr;
+        std::vector<std::string> passNames;
+        uint64_t                 frameNumber = 0;
+        bool                     mapPending  = false;
+    };
+
+    // Allocate a begin and end query for a pass. Returns the index of the begin query.
+    std::optional<uint32_t> allocateQueries( const char* passName );
+
+    static void onReadbackMapped( WGPUBufferMapAsyncStatus status, void* userdata );
+
+    bool                          enabled           = false;
+    uint32_t                      maxPassesPerFrame = 0;
+    std::array<Frame, FrameCount> frames;
+    uint32_t                      currentFrame = 0;
+    uint64_t                      frameNumber  = 0;
+
+    std::vector<PassTiming> passTimings;
+    uint64_t                passTimingsFrameNumber = 0;
+};
+}  // namespace WebGPUlib
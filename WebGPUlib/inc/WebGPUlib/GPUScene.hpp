@@ -0,0 +1,130 @@
+#pragma once
+
+#include "CullInstancesPipelineState.hpp"
+
+#include <glm/mat4x4.hpp>
+
+#include <cstdint>
+#include <memory>
+#include <vector>
+
+namespace WebGPUlib
+{
+
+class Frustum;
+class HiZPyramid;
+class Mesh;
+class SceneGraph;
+class SceneNode;
+class StorageBuffer;
+class TextureView;
+class UniformBuffer;
+
+// The mesh instances of a scene graph in GPU buffers, for GPU driven culling and rendering.
+// There is one indexed indirect draw for each unique mesh in the scene graph. The culling pass writes the matrices
+// of the visible instances of each draw into its own region of the visible instance buffer, and the number of
+// visible instances into the arguments of the draw. The draws only need to be recorded again when the
+// instance buffers are rebuilt, not when the camera moves.
+// With occlusion culling, the early and the late phase each have their own draw arguments and visible instances,
+// and the draws are recorded once for each phase.
+class GPUScene
+{
+public:
+    // The instances of each draw start at a multiple of the minimum storage buffer offset alignment,
+    // so they can be bound with a dynamic offset (the first instance of an indirect draw must be 0).
+    static constexpr uint32_t InstanceOffsetAlignment = 256;
+
+    struct Draw
+    {
+        std::shared_ptr<Mesh> mesh;
+        uint64_t              indirectOffset;  // The offset of the draw arguments in the indirect buffer.
+        uint32_t              instanceOffset;  // The offset (in bytes) of the instances in the visible instance buffer.
+        uint32_t              instanceCount;   // The number of instances before culling.
+    };
+
+    GPUScene();
+    ~GPUScene();
+
+    GPUScene( const GPUScene& )            = delete;
+    GPUScene( GPUScene&& )                 = delete;
+    GPUScene& operator=( const GPUScene& ) = delete;
+    GPUScene& operator=( GPUScene&& )      = delete;
+
+    // Upload the instances in the subtree of the root node if its scene graph has changed since the last update.
+    // Call after SceneGraph::update. Returns true if the draws have changed, in which case draws that were
+    // recorded with them must be recorded again.
+    bool update( const SceneNode& root );
+
+    // Test all instances against the (world space) frustum on the GPU. The culling pass is submitted to the queue,
+    // so it runs before the draws in command buffers that are submitted after it.
+    // The visible instances are drawn with the draws of the early phase.
+    void cull( const Frustum& frustum );
+
+    // Two-phase occlusion culling. cullEarly culls the instances that were visible in the previous frame.
+    // Draw them with the draws of the early phase and build the Hi-Z pyramid from the depth buffer, then call
+    // cullLate to test all instances against the pyramid, and draw the instances that have become visible with
+    // the draws of the late phase.
+    void cullEarly( const Frustum& frustum );
+    void cullLate( const Frustum& frustum, const glm::mat4& viewProjection, const HiZPyramid& hiZPyramid );
+
+    const std::vector<Draw>& getDraws() const noexcept
+    {
+        return draws;
+    }
+
+    uint32_t getInstanceCount() const noexcept
+    {
+        return instanceCount;
+    }
+
+    // The arguments of the indirect draws.
+    const std::shared_ptr<StorageBuffer>& getIndirectBuffer( CullPhase phase = CullPhase::Early ) const noexcept
+    {
+        return indirectBuffers[getDrawSet( phase )];
+    }
+
+    // The matrices of the visible instances (a Matrices struct with the model and inverse-transpose model matrix).
+    const std::shared_ptr<StorageBuffer>& getVisibleInstanceBuffer( CullPhase phase = CullPhase::Early ) const noexcept
+    {
+        return visibleInstanceBuffers[getDrawSet( phase )];
+    }
+
+    // The size of the range of the visible instance buffer to bind for each draw.
+    uint64_t getInstanceBindingSize() const noexcept
+    {
+        return instanceBindingSize;
+    }
+
+private:
+    // The frustum culling and the early phase draw with the first set of buffers, the late phase with the second.
+    static constexpr std::size_t NumDrawSets = 2;
+
+    static std::size_t getDrawSet( CullPhase phase ) noexcept
+    {
+        return phase == CullPhase::Late ? 1 : 0;
+    }
+
+    // Run the culling shader.
+    void dispatch( const CullParameters& parameters, const TextureView& hiZView );
+
+    std::unique_ptr<CullInstancesPipelineState> cullInstancesPipelineState;
+
+    std::shared_ptr<UniformBuffer> parametersBuffer;
+    std::shared_ptr<StorageBuffer> instanceBuffer;
+    std::shared_ptr<StorageBuffer> drawBuffer;
+    std::shared_ptr<StorageBuffer> visibilityBuffer;  // The visibility of each instance in the previous frame.
+    std::shared_ptr<StorageBuffer> indirectBuffers[NumDrawSets];
+    std::shared_ptr<StorageBuffer> visibleInstanceBuffers[NumDrawSets];
+
+    std::vector<Draw>                         draws;
+    std::vector<DrawIndexedIndirectArguments> drawArguments;  // The draw arguments with an instance count of 0.
+    std::vector<CullInstance>                 instances;
+
+    uint32_t instanceCount       = 0;
+    uint64_t instanceBindingSize = 0;
+
+    const SceneNode*  rootNode          = nullptr;
+    const SceneGraph* sceneGraph        = nullptr;
+    uint64_t          sceneGraphVersion = 0;
+};
+}  // namespace WebGPUlib
@@ -0,0 +1,46 @@
+#pragma once
+
+#include "ComputePipelineState.hpp"
+
+#include <cstdint>
+
+namespace WebGPUlib
+{
+struct SinglePassMips
+{
+    uint32_t numMips = 0;
+    uint32_t padding[3] {};
+};
+
+// Generates the full mip chain of a texture (up to 4096x4096) with a single dispatch.
+// Requires a device that supports at least MaxMips storage textures per shader stage.
+class GenerateMipsSinglePassPipelineState : public ComputePipelineState
+{
+public:
+    // The maximum number of mips that are generated by a single dispatch.
+    static constexpr uint32_t MaxMips = 12;
+
+    // The size of the buffer that stores mip 6 (up to 64x64 packed RGBA8 texels).
+    static constexpr uint32_t Mip6BufferSize = 64 * 64 * sizeof( uint32_t );
+
+    GenerateMipsSinglePassPipelineState();
+    ~GenerateMipsSinglePassPipelineState() override;
+
+    GenerateMipsSinglePassPipelineState( const GenerateMipsSinglePassPipelineState& )                = delete;
+    GenerateMipsSinglePassPipelineState( GenerateMipsSinglePassPipelineState&& ) noexcept            = delete;
+    GenerateMipsSinglePassPipelineState& operator=( const GenerateMipsSinglePassPipelineState& )     = delete;
+    GenerateMipsSinglePassPipelineState& operator=( GenerateMipsSinglePassPipelineState&& ) noexcept = delete;
+
+    WGPUBindGroupLayout getWGPUBindGroupLayout( uint32_t groupIndex ) override
+    {
+        // This pipeline only has a single bind group.
+        return bindGroupLayout;
+    }
+
+protected:
+    void bind( ComputeCommandBuffer& commandBuffer ) override;
+
+private:
+    WGPUBindGroupLayout bindGroupLayout = nullptr;
+};
+}  // namespace WebGPUlib
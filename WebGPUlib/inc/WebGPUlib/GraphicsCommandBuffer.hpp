@@ -6,6 +6,7 @@ namespace WebGPUlib
 {
 class GraphicsPipelineState;
 class Mesh;
+class RenderBundle;
 
 class GraphicsCommandBuffer : public CommandBuffer
 {
@@ -16,9 +17,27 @@ public:
     GraphicsCommandBuffer& operator=( const GraphicsCommandBuffer& ) = delete;
     GraphicsCommandBuffer& operator=( GraphicsCommandBuffer&& )      = delete;
 
+    // Setting the pipeline that is already set is skipped.
     void setGraphicsPipeline( GraphicsPipelineState& pipeline );
 
-    void draw( const Mesh& mesh );
+    void draw( const Mesh& mesh, uint32_t instanceCount = 1, uint32_t firstInstance = 0 );
+
+    // Draw an indexed mesh with the DrawIndexedIndirectArguments at the offset in the indirect buffer.
+    // The first index and base vertex of the arguments must match the first index and base vertex of the mesh.
+    void drawIndirect( const Mesh& mesh, const Buffer& indirectBuffer, uint64_t indirectOffset = 0 );
+
+    // Upload the per-instance data to a dynamic storage buffer and draw an instance of the mesh for each element.
+    // The shader reads the data of an instance with @builtin(instance_index).
+    // The binding must be declared as a read-only storage buffer with hasDynamicOffset in the bind group layout.
+    template<typename T>
+    void drawInstanced( const Mesh& mesh, uint32_t groupIndex, uint32_t binding, const std::vector<T>& instances );
+
+    // Execute a prerecorded render bundle. Executing a bundle resets the pipeline, bind groups
+    // and vertex and index buffers, so the pipeline must be set again before drawing.
+    void executeBundle( const RenderBundle& bundle );
+
+    // Execute multiple prerecorded render bundles with a single call.
+    void executeBundles( const std::vector<std::shared_ptr<RenderBundle>>& bundles );
 
     WGPURenderPassEncoder getWGPUPassEncoder() const
     {
@@ -34,7 +53,32 @@ protected:
     WGPUCommandBuffer finish() override;
 
 private:
+    // Executing bundles resets the state of the render pass.
+    void resetState();
+
+    // Set the vertex and index buffers of a mesh.
+    void setMeshBuffers( const Mesh& mesh );
+    void setVertexBuffer( uint32_t slot, const BufferBinding& binding );
+    void setIndexBuffer( const BufferBinding& binding, WGPUIndexFormat indexFormat );
+
     WGPURenderPassEncoder  passEncoder          = nullptr;
     GraphicsPipelineState* currentPipelineState = nullptr;
+    WGPURenderPipeline     currentPipeline      = nullptr;
+
+    // Currently bound vertex and index buffers, used to skip redundant state changes.
+    std::vector<BufferBinding> currentVertexBuffers;
+    BufferBinding              currentIndexBuffer;
+    WGPUIndexFormat            currentIndexFormat = WGPUIndexFormat_Undefined;
 };
+
+template<typename T>
+void GraphicsCommandBuffer::drawInstanced( const Mesh& mesh, uint32_t groupIndex, uint32_t binding,
+                                           const std::vector<T>& instances )
+{
+    if ( instances.empty() )
+        return;
+
+    bindDynamicStorageBuffer( groupIndex, binding, instances );
+    draw( mesh, static_cast<uint32_t>( instances.size() ) );
+}
 }  // namespace WebGPUlib
\ No newline at end of file
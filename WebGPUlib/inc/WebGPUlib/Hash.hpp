@@ -31,6 +31,22 @@ struct hash<WGPUTextureViewDescriptor>
     }
 };
 
+template<>
+struct hash<WGPUBindGroupEntry>
+{
+    std::size_t operator()( const WGPUBindGroupEntry& bindGroupEntry ) const noexcept
+    {
+        std::size_t seed = 0;
+        hash_combine( seed, bindGroupEntry.binding );
+        hash_combine( seed, bindGroupEntry.buffer );
+        hash_combine( seed, bindGroupEntry.offset );
+        hash_combine( seed, bindGroupEntry.size );
+        hash_combine( seed, bindGroupEntry.sampler );
+        hash_combine( seed, bindGroupEntry.textureView );
+        return seed;
+    }
+};
+
 }  // namespace std
 
 inline bool operator<( const WGPUTextureViewDescriptor& lhs, const WGPUTextureViewDescriptor& rhs ) noexcept
@@ -65,4 +81,19 @@ inline bool operator==( const WGPUTextureViewDescriptor& lhs, const WGPUTextureV
         && lhs.mipLevelCount == rhs.mipLevelCount
         && lhs.baseArrayLayer == rhs.baseArrayLayer
         && lhs.arrayLayerCount == rhs.arrayLayerCount;
+}
+
+inline bool operator==( const WGPUBindGroupEntry& lhs, const WGPUBindGroupEntry& rhs ) noexcept
+{
+    return lhs.binding == rhs.binding
+        && lhs.buffer == rhs.buffer
+        && lhs.offset == rhs.offset
+        && lhs.size == rhs.size
+        && lhs.sampler == rhs.sampler
+        && lhs.textureView == rhs.textureView;
+}
+
+inline bool operator!=( const WGPUBindGroupEntry& lhs, const WGPUBindGroupEntry& rhs ) noexcept
+{
+    return !( lhs == rhs );
 }
\ No newline at end of file
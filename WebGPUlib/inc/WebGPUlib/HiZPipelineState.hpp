@@ -0,0 +1,59 @@
+#pragma once
+
+#include "ComputePipelineState.hpp"
+
+#include <cstdint>
+
+namespace WebGPUlib
+{
+struct HiZParameters
+{
+    uint32_t srcWidth  = 0;
+    uint32_t srcHeight = 0;
+    uint32_t dstWidth  = 0;
+    uint32_t dstHeight = 0;
+};
+
+// Downsamples a depth texture or a mip of a hierarchical-Z pyramid to the next mip of the pyramid.
+// Each texel of the pyramid (RG32Float) stores the minimum and maximum depth of the texels it covers.
+class HiZPipelineState : public ComputePipelineState
+{
+public:
+    static constexpr WGPUTextureFormat Format = WGPUTextureFormat_RG32Float;
+
+    // The texture that is downsampled by the pipeline (bound to binding 2).
+    enum class Source
+    {
+        Depth,              // A single sampled depth texture.
+        DepthMultisampled,  // A multisampled depth texture.
+        HiZ,                // The previous mip of the pyramid.
+        NumSources
+    };
+
+    explicit HiZPipelineState( Source source );
+    ~HiZPipelineState() override;
+
+    HiZPipelineState( const HiZPipelineState& )                = delete;
+    HiZPipelineState( HiZPipelineState&& ) noexcept            = delete;
+    HiZPipelineState& operator=( const HiZPipelineState& )     = delete;
+    HiZPipelineState& operator=( HiZPipelineState&& ) noexcept = delete;
+
+    WGPUBindGroupLayout getWGPUBindGroupLayout( uint32_t groupIndex ) override
+    {
+        // This pipeline only has a single bind group.
+        return bindGroupLayout;
+    }
+
+    Source getSource() const noexcept
+    {
+        return source;
+    }
+
+protected:
+    void bind( ComputeCommandBuffer& commandBuffer ) override;
+
+private:
+    Source              source;
+    WGPUBindGroupLayout bindGroupLayout = nullptr;
+};
+}  // namespace WebGPUlib
@@ -0,0 +1,81 @@
+#pragma once
+
+#include "HiZPipelineState.hpp"
+
+#include <cstdint>
+#include <memory>
+#include <vector>
+
+namespace WebGPUlib
+{
+
+class Texture;
+class TextureView;
+class UniformBuffer;
+
+// A hierarchical-Z pyramid for occlusion culling.
+// Mip 0 is half the size of the depth texture, and each mip stores the minimum (r) and maximum (g) depth
+// of the texels it covers, down to a single texel. Texel (x, y) of mip m covers the depth texels
+// (x, y) * 2^(m + 1) to (x + 1, y + 1) * 2^(m + 1) - 1, and the last row and column of a mip also cover
+// the remaining depth texels if the size of the depth texture is not a power of 2.
+class HiZPyramid
+{
+public:
+    // The uniform buffer offset alignment.
+    static constexpr uint32_t ParameterStride = 256;
+
+    HiZPyramid();
+    ~HiZPyramid();
+
+    HiZPyramid( const HiZPyramid& )            = delete;
+    HiZPyramid( HiZPyramid&& )                 = delete;
+    HiZPyramid& operator=( const HiZPyramid& ) = delete;
+    HiZPyramid& operator=( HiZPyramid&& )      = delete;
+
+    // Build the pyramid from a depth texture. The pyramid is created again if the size of the depth texture changes.
+    // The depth texture must be created with the TextureBinding usage and may be multisampled.
+    void build( Texture& depthTexture );
+
+    const std::shared_ptr<Texture>& getTexture() const noexcept
+    {
+        return texture;
+    }
+
+    // A view of all mips of the pyramid.
+    const std::shared_ptr<TextureView>& getView() const noexcept
+    {
+        return view;
+    }
+
+    uint32_t getMipCount() const noexcept
+    {
+        return static_cast<uint32_t>( mipViews.size() );
+    }
+
+    // The size of the depth texture the pyramid was built from.
+    uint32_t getDepthWidth() const noexcept
+    {
+        return depthWidth;
+    }
+
+    uint32_t getDepthHeight() const noexcept
+    {
+        return depthHeight;
+    }
+
+private:
+    void create( uint32_t depthWidth, uint32_t depthHeight );
+
+    HiZPipelineState& getPipelineState( HiZPipelineState::Source source );
+
+    std::unique_ptr<HiZPipelineState> pipelineStates[static_cast<std::size_t>( HiZPipelineState::Source::NumSources )];
+
+    std::shared_ptr<Texture>                  texture;
+    std::shared_ptr<TextureView>              view;
+    std::vector<std::shared_ptr<TextureView>> mipViews;
+    std::shared_ptr<UniformBuffer>            parametersBuffer;
+
+    uint32_t depthWidth  = 0;
+    uint32_t depthHeight = 0;
+};
+}  // namespace WebGPUlib
@@ -3,9 +3,12 @@
 #include "Buffer.hpp"
 
 #include <cstddef>
+#include <memory>
 
 namespace WebGPUlib
 {
+class BufferArena;
+
 class IndexBuffer : public Buffer
 {
 public:
@@ -36,12 +39,21 @@ public:
         return indexCount * indexStride;
     }
 
+    // The arena that this buffer is allocated from, or nullptr if the buffer is not allocated from an arena.
+    const std::shared_ptr<BufferArena>& getArena() const
+    {
+        return arena;
+    }
+
 protected:
-    IndexBuffer( WGPUBuffer&& buffer, std::size_t indexCount, std::size_t indexStride );
-    ~IndexBuffer() override = default;
+    IndexBuffer( WGPUBuffer&& buffer, std::size_t indexCount, std::size_t indexStride,
+                 std::shared_ptr<BufferArena> arena = nullptr, uint64_t offset = 0 );
+    ~IndexBuffer() override;
 
 private:
     std::size_t indexCount  = 0;
     std::size_t indexStride = 0;
+
+    std::shared_ptr<BufferArena> arena;
 };
 }  // namespace WebGPUlib
\ No newline at end of file
@@ -139,8 +139,15 @@ public:
     const MaterialProperties& getProperties() const noexcept;
     void                      setProperties( const MaterialProperties& properties ) noexcept;
 
+    // The version is incremented every time the material properties or textures change.
+    uint64_t getVersion() const noexcept
+    {
+        return version;
+    }
+
 private:
     std::unique_ptr<MaterialProperties>                       properties;
     std::unordered_map<TextureSlot, std::shared_ptr<Texture>> textures;
+    uint64_t                                                  version = 0;
 };
 }  // namespace WebGPUlib
\ No newline at end of file
@@ -1,5 +1,8 @@
 #pragma once
 
+#include "BoundingBox.hpp"
+
+#include <cstdint>
 #include <memory>
 #include <vector>
 
@@ -27,15 +30,28 @@ public:
     std::shared_ptr<VertexBuffer> getVertexBuffer( uint32_t slot ) const;
     const std::vector<std::shared_ptr<VertexBuffer>>& getVertexBuffers() const;
 
-    void                         setIndexBuffer( std::shared_ptr<IndexBuffer> indexBuffer );
-    std::shared_ptr<IndexBuffer> getIndexBuffer() const;
+    void                                setIndexBuffer( std::shared_ptr<IndexBuffer> indexBuffer );
+    const std::shared_ptr<IndexBuffer>& getIndexBuffer() const;
 
     void                      setMaterial( std::shared_ptr<Material> material );
     std::shared_ptr<Material> getMaterial() const;
 
+    // The axis-aligned bounding box of the mesh in object space.
+    void               setBoundingBox( const BoundingBox& boundingBox );
+    const BoundingBox& getBoundingBox() const;
+
+    // Meshes with a single vertex buffer that is allocated from a buffer arena are drawn
+    // with the arena bound at offset 0 and a base vertex (or first vertex) into the arena.
+    bool    usesBaseVertex() const;
+    int32_t getBaseVertex() const;
+
+    // The index of the first index of the mesh in the index buffer arena.
+    uint32_t getFirstIndex() const;
+
 private:
     std::vector<std::shared_ptr<VertexBuffer>> vertexBuffers;
     std::shared_ptr<IndexBuffer>               indexBuffer;
     std::shared_ptr<Material>                  material;
+    BoundingBox                                boundingBox;
 };
 }  // namespace WebGPUlib
\ No newline at end of file
@@ -0,0 +1,100 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <utility>
+#include <vector>
+
+namespace WebGPUlib
+{
+
+// The size of the simulated post-transform vertex cache (FIFO).
+constexpr uint32_t DefaultVertexCacheSize = 16;
+
+// Post-transform vertex cache statistics of an index buffer.
+// Statistics of multiple meshes can be combined by adding them.
+struct VertexCacheStatistics
+{
+    uint64_t vertexCount    = 0;  // The number of unique vertices that are referenced by the indices.
+    uint64_t triangleCount  = 0;
+    uint64_t transformCount = 0;  // The number of vertex shader invocations (cache misses).
+
+    // Average cache miss ratio: the number of transformed vertices per triangle (0.5 is optimal for large meshes).
+    float getACMR() const noexcept
+    {
+        return triangleCount ? static_cast<float>( transformCount ) / static_cast<float>( triangleCount ) : 0.0f;
+    }
+
+    // Average transformed vertex ratio: the number of times each vertex is transformed (1 is optimal).
+    float getATVR() const noexcept
+    {
+        return vertexCount ? static_cast<float>( transformCount ) / static_cast<float>( vertexCount ) : 0.0f;
+    }
+
+    VertexCacheStatistics& operator+=( const VertexCacheStatistics& other ) noexcept
+    {
+        vertexCount += other.vertexCount;
+        triangleCount += other.triangleCount;
+        transformCount += other.transformCount;
+        return *this;
+    }
+};
+
+// Simulate a FIFO post-transform vertex cache for a triangle list.
+VertexCacheStatistics analyzeVertexCache( const std::vector<uint32_t>& indices, std::size_t vertexCount,
+                                          uint32_t cacheSize = DefaultVertexCacheSize );
+
+// Reorder the triangles for the post-transform vertex cache (Tipsify, Sander et al. 2007).
+// Returns the index of the first triangle of each cluster: a new cluster starts whenever the
+// algorithm has to jump to a vertex that is not in the cache.
+std::vector<uint32_t> optimizeVertexCache( std::vector<uint32_t>& indices, std::size_t vertexCount,
+                                           uint32_t cacheSize = DefaultVertexCacheSize );
+
+// Reorder the clusters of a vertex cache optimized triangle list to reduce overdraw.
+// The clusters are split further where their ACMR drops below the ACMR of the mesh times the threshold,
+// and then sorted so that clusters that face away from the center of the mesh (and are likely to occlude
+// other clusters) are drawn first. The ACMR of the result is at most threshold times the input ACMR.
+void optimizeOverdraw( std::vector<uint32_t>& indices, const std::vector<uint32_t>& clusters, const void* positions,
+                       std::size_t vertexCount, std::size_t positionStride, float threshold = 1.05f,
+                       uint32_t cacheSize = DefaultVertexCacheSize );
+
+// Remap the vertices in the order that they are first referenced by the indices (for vertex fetch locality).
+// The indices are updated. Returns the remap table (old vertex index to new vertex index, or ~0u for
+// vertices that are not referenced) and the number of referenced vertices.
+std::pair<std::vector<uint32_t>, uint32_t> optimizeVertexFetchRemap( std::vector<uint32_t>& indices,
+                                                                      std::size_t            vertexCount );
+
+// Split a triangle list into consecutive ranges of triangles that reference at most maxVertexCount unique vertices,
+// so each range can be drawn with 16-bit indices. Returns the index of the first triangle of each range.
+// The triangle order is kept, so ranges of a vertex cache optimized mesh are spatially coherent.
+std::vector<uint32_t> partitionTriangles( const std::vector<uint32_t>& indices, std::size_t vertexCount,
+                                          uint32_t maxVertexCount = 65536 );
+
+template<typename Vertex>
+void optimizeVertexFetch( std::vector<Vertex>& vertices, std::vector<uint32_t>& indices )
+{
+    auto [remap, referencedVertexCount] = optimizeVertexFetchRemap( indices, vertices.size() );
+
+    std::vector<Vertex> remappedVertices( referencedVertexCount );
+    for ( std::size_t v = 0; v < vertices.size(); ++v )
+    {
+        if ( remap[v] != ~0u )
+            remappedVertices[remap[v]] = vertices[v];
+    }
+
+    vertices = std::move( remappedVertices );
+}
+
+// Run all of the optimizations on a mesh: vertex cache, overdraw, and vertex fetch.
+// The vertex type must have a glm::vec3 position member.
+template<typename Vertex>
+void optimizeMesh( std::vector<Vertex>& vertices, std::vector<uint32_t>& indices, float overdrawThreshold = 1.05f )
+{
+    if ( vertices.empty() || indices.empty() )
+        return;
+
+    auto clusters = optimizeVertexCache( indices, vertices.size() );
+    optimizeOverdraw( indices, clusters, &vertices[0].position, vertices.size(), sizeof( Vertex ), overdrawThreshold );
+    optimizeVertexFetch( vertices, indices );
+}
+}  // namespace WebGPUlib
@@ -4,6 +4,7 @@
 #include <webgpu/webgpu.h>
 
 #include <memory>
+#include <vector>
 
 namespace WebGPUlib
 {
@@ -13,6 +14,7 @@ class Texture;
 class CommandBuffer;
 class GraphicsCommandBuffer;
 class ComputeCommandBuffer;
+class RenderBundleCommandBuffer;
 
 enum class ClearFlags
 {
@@ -30,17 +32,30 @@ public:
     template<typename T>
     void writeBuffer( Buffer& buffer, const T& data ) const;
     void writeBuffer( WGPUBuffer buffer, const void* data, std::size_t size, uint64_t offset = 0 ) const;
+    // The offset is relative to the start of the buffer, also for buffers that are allocated from a buffer arena.
+    // Data that is not a multiple of 4 bytes is padded with zeros.
     void writeBuffer( const Buffer& buffer, const void* data, std::size_t size, uint64_t offset = 0 ) const;
 
     void writeTexture( Texture& texture, uint32_t mip, const void* data, std::size_t size ) const;
 
+    // Copy a texture mip back to the CPU. Blocks until the copy is complete.
+    // The returned pixels are tightly packed (no row padding).
+    std::vector<uint8_t> readTexture( const Texture& texture, uint32_t mip = 0 ) const;
+
+    // If a pass name is given, the GPU time of the pass is measured by the GPU profiler
+    // (if timestamp queries are supported by the device).
     std::shared_ptr<GraphicsCommandBuffer> createGraphicsCommandBuffer( const RenderTarget& renderTarget,
                                                                         ClearFlags       clearFlags = ClearFlags::All,
                                                                         const WGPUColor& clearColor = { 0, 0, 0, 0 },
                                                                         float            depth      = 1.0f,
-                                                                        uint32_t         stencil    = 0 ) const;
+                                                                        uint32_t         stencil    = 0,
+                                                                        const char*      passName   = nullptr ) const;
+
+    std::shared_ptr<ComputeCommandBuffer> createComputeCommandBuffer( const char* passName = nullptr );
 
-    std::shared_ptr<ComputeCommandBuffer> createComputeCommandBuffer();
+    // Create a command buffer that records a render bundle which can be executed
+    // in render passes that use the same attachment formats as the render target.
+    std::shared_ptr<RenderBundleCommandBuffer> createRenderBundleCommandBuffer( const RenderTarget& renderTarget ) const;
 
     void submit( CommandBuffer& commandBuffer );
 
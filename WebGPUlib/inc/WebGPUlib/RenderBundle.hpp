@@ -0,0 +1,65 @@
+#pragma once
+
+#include "UploadPagePool.hpp"
+
+#include <webgpu/webgpu.h>
+
+#include <memory>
+#include <utility>
+#include <vector>
+
+namespace WebGPUlib
+{
+class GraphicsPipelineState;
+class Material;
+class SceneNode;
+
+// A sequence of draw commands that is recorded once with a RenderBundleCommandBuffer
+// and executed in a graphics command buffer every frame.
+class RenderBundle
+{
+public:
+    RenderBundle( const RenderBundle& )                = delete;
+    RenderBundle( RenderBundle&& ) noexcept            = delete;
+    RenderBundle& operator=( const RenderBundle& )     = delete;
+    RenderBundle& operator=( RenderBundle&& ) noexcept = delete;
+
+    // Check if the recorded commands are still valid. A bundle becomes invalid when the transform
+    // of a scene node or a material that it depends on changes or is destroyed, when a
+    // pipeline state it uses is recreated, or when it is explicitly invalidated.
+    bool isValid() const;
+
+    // Mark the bundle as invalid. The bundle must be recorded again before it can be used.
+    void invalidate() noexcept
+    {
+        invalidated = true;
+    }
+
+    WGPURenderBundle getWGPURenderBundle() const noexcept
+    {
+        return renderBundle;
+    }
+
+protected:
+    friend class RenderBundleCommandBuffer;
+
+    struct Dependencies
+    {
+        std::vector<std::pair<std::weak_ptr<const SceneNode>, uint64_t>>          nodes;
+        std::vector<std::pair<std::weak_ptr<const Material>, uint64_t>>           materials;
+        std::vector<std::pair<const GraphicsPipelineState*, WGPURenderPipeline>> pipelines;
+    };
+
+    RenderBundle( WGPURenderBundle&& renderBundle, UploadPagePool::PageList&& pages, Dependencies&& dependencies );
+    virtual ~RenderBundle();
+
+private:
+    WGPURenderBundle renderBundle = nullptr;
+
+    // The upload pages that contain the dynamic buffer data of the bundle.
+    UploadPagePool::PageList pages;
+
+    Dependencies dependencies;
+    bool         invalidated = false;
+};
+}  // namespace WebGPUlib
@@ -0,0 +1,93 @@
+#pragma once
+
+#include "CommandBuffer.hpp"
+#include "RenderBundle.hpp"
+
+namespace WebGPUlib
+{
+class GraphicsPipelineState;
+class Material;
+class Mesh;
+class SceneNode;
+
+// Records draw commands into a render bundle instead of a render pass.
+// Dynamic buffer data is kept alive by the render bundle, so it is not
+// updated when the bundle is executed in later frames.
+class RenderBundleCommandBuffer : public CommandBuffer
+{
+public:
+    RenderBundleCommandBuffer()                                              = delete;
+    RenderBundleCommandBuffer( const RenderBundleCommandBuffer& )            = delete;
+    RenderBundleCommandBuffer( RenderBundleCommandBuffer&& )                 = delete;
+    RenderBundleCommandBuffer& operator=( const RenderBundleCommandBuffer& ) = delete;
+    RenderBundleCommandBuffer& operator=( RenderBundleCommandBuffer&& )      = delete;
+
+    // Only the pipeline is set, GraphicsPipelineState::bind is not called for render bundles.
+    // Setting the pipeline that is already set is skipped.
+    void setGraphicsPipeline( GraphicsPipelineState& pipeline );
+
+    void draw( const Mesh& mesh, uint32_t instanceCount = 1, uint32_t firstInstance = 0 );
+
+    // Draw an indexed mesh with the DrawIndexedIndirectArguments at the offset in the indirect buffer.
+    // The first index and base vertex of the arguments must match the first index and base vertex of the mesh.
+    void drawIndirect( const Mesh& mesh, const Buffer& indirectBuffer, uint64_t indirectOffset = 0 );
+
+    // Upload the per-instance data to a dynamic storage buffer and draw an instance of the mesh for each element.
+    // The shader reads the data of an instance with @builtin(instance_index).
+    // The binding must be declared as a read-only storage buffer with hasDynamicOffset in the bind group layout.
+    template<typename T>
+    void drawInstanced( const Mesh& mesh, uint32_t groupIndex, uint32_t binding, const std::vector<T>& instances );
+
+    // The bundle is invalidated when the transform of the node (or one of its parents) changes.
+    void addDependency( const std::shared_ptr<const SceneNode>& node );
+
+    // The bundle is invalidated when the material changes.
+    void addDependency( const std::shared_ptr<const Material>& material );
+
+    // Finish recording and create the render bundle.
+    // The command buffer can not be used to record commands afterwards.
+    std::shared_ptr<RenderBundle> finishBundle();
+
+    WGPURenderBundleEncoder getWGPURenderBundleEncoder() const
+    {
+        return bundleEncoder;
+    }
+
+protected:
+    RenderBundleCommandBuffer( WGPURenderBundleEncoder&& bundleEncoder );
+    ~RenderBundleCommandBuffer() override;
+
+    void setBindGroup( uint32_t groupIndex, const BindGroup& bindGroup ) override;
+
+    // Render bundles are not submitted to the queue. Use finishBundle instead.
+    WGPUCommandBuffer finish() override;
+
+private:
+    // Set the vertex and index buffers of a mesh.
+    void setMeshBuffers( const Mesh& mesh );
+    void setVertexBuffer( uint32_t slot, const BufferBinding& binding );
+    void setIndexBuffer( const BufferBinding& binding, WGPUIndexFormat indexFormat );
+
+    WGPURenderBundleEncoder bundleEncoder        = nullptr;
+    GraphicsPipelineState*  currentPipelineState = nullptr;
+    WGPURenderPipeline      currentPipeline      = nullptr;
+
+    // Currently bound vertex and index buffers, used to skip redundant state changes.
+    std::vector<BufferBinding> currentVertexBuffers;
+    BufferBinding              currentIndexBuffer;
+    WGPUIndexFormat            currentIndexFormat = WGPUIndexFormat_Undefined;
+
+    RenderBundle::Dependencies dependencies;
+};
+
+template<typename T>
+void RenderBundleCommandBuffer::drawInstanced( const Mesh& mesh, uint32_t groupIndex, uint32_t binding,
+                                               const std::vector<T>& instances )
+{
+    if ( instances.empty() )
+        return;
+
+    bindDynamicStorageBuffer( groupIndex, binding, instances );
+    draw( mesh, static_cast<uint32_t>( instances.size() ) );
+}
+}  // namespace WebGPUlib
@@ -0,0 +1,107 @@
+#pragma once
+
+#include "Material.hpp"
+
+#include <glm/mat4x4.hpp>
+
+#include <array>
+#include <cstdint>
+#include <memory>
+#include <unordered_map>
+#include <vector>
+
+namespace WebGPUlib
+{
+
+class Mesh;
+class SceneNode;
+class Texture;
+struct VisibleMesh;
+
+// A draw of a mesh with the transform of a scene node.
+struct DrawPacket
+{
+    uint64_t         sortKey;
+    const SceneNode* node;
+    const Mesh*      mesh;
+    uint32_t         material;    // Index of the material in the render queue.
+    uint32_t         textureSet;  // Index of the texture set in the render queue.
+};
+
+// Flattens the visible meshes into a list of draw packets that are sorted to minimize state changes.
+// The sort key is (from the most to the least significant bits):
+//   pipeline    (8 bits):  Set by the caller.
+//   texture set (16 bits): The textures of the material. Materials that share textures are drawn together.
+//   material    (16 bits): The material properties.
+//   depth       (24 bits): The view space depth of the mesh, so draws with the same state are drawn front to back.
+// Consecutive packets with the same material, texture set, or node can skip binding them again.
+class RenderQueue
+{
+public:
+    using TextureSet = std::array<std::shared_ptr<Texture>, static_cast<std::size_t>( TextureSlot::NumTextureSlots )>;
+
+    static constexpr uint32_t MaxPipelineCount = 1u << 8;
+    static constexpr uint32_t MaxMaterialCount = 1u << 16;
+
+    // Remove all draw packets. The view matrix is used to compute the depth of the draws.
+    void clear( const glm::mat4& viewMatrix );
+
+    // Add a draw packet for a visible mesh. The node and the mesh must stay alive until the queue is cleared.
+    void add( const VisibleMesh& visibleMesh, uint32_t pipeline = 0 );
+
+    // Sort the draw packets by their sort key (radix sort).
+    void sort();
+
+    const std::vector<DrawPacket>& getDrawPackets() const noexcept
+    {
+        return drawPackets;
+    }
+
+    const std::shared_ptr<Material>& getMaterial( uint32_t material ) const
+    {
+        return materials[material];
+    }
+
+    const TextureSet& getTextureSet( uint32_t textureSet ) const
+    {
+        return textureSets[textureSet];
+    }
+
+    std::size_t getMaterialCount() const noexcept
+    {
+        return materials.size();
+    }
+
+    std::size_t getTextureSetCount() const noexcept
+    {
+        return textureSets.size();
+    }
+
+private:
+    struct TextureSetHash
+    {
+        std::size_t operator()( const TextureSet& textureSet ) const noexcept;
+    };
+
+    struct MaterialEntry
+    {
+        uint32_t material;
+        uint32_t textureSet;
+    };
+
+    // Look up (or add) the material and its texture set.
+    MaterialEntry getMaterialEntry( const std::shared_ptr<Material>& material );
+
+    glm::mat4 viewMatrix { 1 };
+
+    std::vector<DrawPacket> drawPackets;
+
+    std::vector<std::shared_ptr<Material>>                   materials;
+    std::vector<TextureSet>                                  textureSets;
+    std::unordered_map<const Material*, MaterialEntry>       materialEntries;
+    std::unordered_map<TextureSet, uint32_t, TextureSetHash> textureSetIndices;
+
+    // Scratch buffer for the radix sort.
+    std::vector<DrawPacket> sortBuffer;
+};
+}  // namespace WebGPUlib
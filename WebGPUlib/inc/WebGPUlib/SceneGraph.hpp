@@ -0,0 +1,176 @@
+#pragma once
+
+#include "BoundingBox.hpp"
+
+#include <glm/mat4x4.hpp>
+
+#include <cstdint>
+#include <memory>
+#include <vector>
+
+namespace WebGPUlib
+{
+
+class Frustum;
+class Mesh;
+class SceneNode;
+struct VisibleMesh;
+
+// A flattened, data oriented store for a scene hierarchy.
+// The nodes are stored in parallel arrays in depth-first order: a parent is always stored before its children,
+// and the nodes and meshes of a subtree are stored in a contiguous range. World transforms and bounds are
+// updated in a linear sweep over the arrays instead of by traversing the nodes.
+// A SceneNode is a handle to a node in a scene graph. Nodes are added to a scene graph when they are created,
+// and move to the scene graph of their parent when they are attached to it. Nodes that are detached from their
+// parent (or outlive it) move to a new scene graph, so a scene graph only stores the tree of a single root node.
+class SceneGraph
+{
+public:
+    static constexpr uint32_t InvalidIndex = ~0u;
+
+    // The range of the meshes of a node in the mesh arrays.
+    struct MeshRange
+    {
+        uint32_t first = 0;
+        uint32_t count = 0;
+    };
+
+    SceneGraph()  = default;
+    ~SceneGraph() = default;
+
+    SceneGraph( const SceneGraph& )            = delete;
+    SceneGraph( SceneGraph&& )                 = delete;
+    SceneGraph& operator=( const SceneGraph& ) = delete;
+    SceneGraph& operator=( SceneGraph&& )      = delete;
+
+    // Recompute the world transforms of the nodes that have changed and the world bounds of all nodes.
+    // Nodes and meshes that were added or removed since the last update are sorted into depth-first order first.
+    void update();
+
+    // Incremented by update every time the transforms, bounds, or the node order have changed.
+    uint64_t getVersion() const noexcept
+    {
+        return version;
+    }
+
+    // Append the meshes in the subtree of a node that intersect the (world space) frustum to visibleMeshes.
+    // Subtrees that are completely outside the frustum are skipped and the meshes of subtrees that are
+    // completely inside the frustum are not tested. Call update first.
+    void cull( uint32_t node, const Frustum& frustum, std::vector<VisibleMesh>& visibleMeshes ) const;
+
+    // The arrays are only in depth-first order after update. Removed nodes have a null node handle
+    // until the next update.
+    std::size_t getNodeCount() const noexcept
+    {
+        return nodes.size();
+    }
+
+    const std::vector<uint32_t>& getParentIndices() const noexcept
+    {
+        return parents;
+    }
+
+    // The subtree of a node is stored in the range [node, subtreeEnds[node]).
+    const std::vector<uint32_t>& getSubtreeEnds() const noexcept
+    {
+        return subtreeEnds;
+    }
+
+    const std::vector<glm::mat4>& getLocalTransforms() const noexcept
+    {
+        return localTransforms;
+    }
+
+    const std::vector<glm::mat4>& getWorldTransforms() const noexcept
+    {
+        return worldTransforms;
+    }
+
+    const std::vector<glm::mat4>& getInverseWorldTransforms() const noexcept
+    {
+        return inverseWorldTransforms;
+    }
+
+    // The world space bounds of the subtree of each node.
+    const std::vector<BoundingBox>& getWorldBounds() const noexcept
+    {
+        return worldBounds;
+    }
+
+    const std::vector<MeshRange>& getMeshRanges() const noexcept
+    {
+        return meshRanges;
+    }
+
+    const std::vector<std::shared_ptr<Mesh>>& getMeshes() const noexcept
+    {
+        return meshes;
+    }
+
+    // The world space bounds of each mesh.
+    const std::vector<BoundingBox>& getMeshWorldBounds() const noexcept
+    {
+        return meshWorldBounds;
+    }
+
+private:
+    friend class SceneNode;
+
+    uint32_t addNode( SceneNode* node, const glm::mat4& localTransform, const glm::mat4& inverseLocalTransform,
+                      uint64_t transformVersion );
+    void     removeNode( uint32_t index );
+
+    void setParent( uint32_t index, uint32_t parent );
+    void setLocalTransform( uint32_t index, const glm::mat4& localTransform );
+
+    // Make sure the world transform of a node (and its parents) is up-to-date.
+    void updateWorldTransform( uint32_t index );
+
+    // Recompute the world transform of a node from the (up-to-date) world transform of its parent.
+    void computeWorldTransform( uint32_t index );
+
+    // Returns true if node is stored in the subtree of root (excluding root itself).
+    // Sorts the nodes first if nodes have been added or removed.
+    bool isInSubtree( const SceneNode* root, const SceneNode* node );
+
+    // Move the subtree of a node to another scene graph.
+    static void moveSubtree( SceneNode& node, const std::shared_ptr<SceneGraph>& target, uint32_t parent );
+
+    // Sort the nodes into depth-first order, remove the nodes that have been removed, and rebuild the mesh arrays.
+    void sortNodes();
+
+    bool needsUpdate( uint32_t index ) const
+    {
+        const uint32_t parent = parents[index];
+        return localDirty[index] ||
+               ( parent != InvalidIndex ? parentWorldVersions[index] != worldVersions[parent] : false );
+    }
+
+    // Node arrays.
+    std::vector<SceneNode*>  nodes;
+    std::vector<uint32_t>    parents;
+    std::vector<uint32_t>    subtreeEnds;  // One past the last node of the subtree.
+    std::vector<glm::mat4>   localTransforms;
+    std::vector<glm::mat4>   inverseLocalTransforms;
+    std::vector<glm::mat4>   worldTransforms;
+    std::vector<glm::mat4>   inverseWorldTransforms;
+    std::vector<uint64_t>    transformVersions;
+    std::vector<uint64_t>    worldVersions;        // Incremented when the world transform is recomputed.
+    std::vector<uint64_t>    parentWorldVersions;  // The world version of the parent when it was last used.
+    std::vector<uint8_t>     localDirty;
+    std::vector<uint8_t>     meshBoundsDirty;
+    std::vector<BoundingBox> worldBounds;
+    std::vector<MeshRange>   meshRanges;
+
+    // Mesh arrays.
+    std::vector<std::shared_ptr<Mesh>> meshes;
+    std::vector<BoundingBox>           meshWorldBounds;
+
+    // Set when nodes or meshes are added or removed.
+    bool sortDirty = false;
+    // Set when a transform or the hierarchy has changed.
+    bool boundsDirty = false;
+
+    uint64_t version = 0;
+};
+}  // namespace WebGPUlib
@@ -1,5 +1,8 @@
 #pragma once
 
+#include "BoundingBox.hpp"
+#include "SceneGraph.hpp"
+
 #include <glm/mat4x4.hpp>
 
 #include <memory>
@@ -9,12 +12,22 @@
 namespace WebGPUlib
 {
 
+class Frustum;
 class Mesh;
+struct VisibleMesh;
 
+// A handle to a node in a SceneGraph. The transforms and bounds of the node are stored in the scene graph,
+// the node only stores its name, its meshes, and the ownership of its children.
 class SceneNode : public std::enable_shared_from_this<SceneNode>
 {
 public:
     explicit SceneNode( const glm::mat4& localTransform = glm::mat4 { 1 } );
+    ~SceneNode();
+
+    SceneNode( const SceneNode& )            = delete;
+    SceneNode( SceneNode&& )                 = delete;
+    SceneNode& operator=( const SceneNode& ) = delete;
+    SceneNode& operator=( SceneNode&& )      = delete;
 
     void setName( const std::string& name );
     const std::string& getName() const;
@@ -24,10 +37,34 @@ public:
 
     const glm::mat4& getInverseLocalTransform() const;
 
-    glm::mat4 getWorldTransform() const;
+    // The version is incremented every time the local transform of the node changes.
+    uint64_t getTransformVersion() const
+    {
+        return sceneGraph->transformVersions[index];
+    }
+
+    // The world transform is cached and only recomputed when the local
+    // transform of this node or one of its parents has changed.
+    // The reference is only valid until nodes are added to or removed from the scene graph.
+    const glm::mat4& getWorldTransform() const;
+
+    const glm::mat4& getInverseWorldTransform() const;
 
-    glm::mat4 getInverseWorldTransform() const;
+    // Recompute the world transforms and world bounds of the dirty nodes in the scene graph of this node.
+    // Call once per frame on the root node before rendering.
+    void updateWorldTransforms();
 
+    // The world space bounding box of the meshes of this node and all of its children.
+    // Only valid after updateWorldTransforms has been called.
+    const BoundingBox& getWorldBounds() const;
+
+    // Append the meshes in this subtree that intersect the (world space) frustum to visibleMeshes.
+    // Subtrees that are completely outside the frustum are skipped and the meshes of subtrees that are
+    // completely inside the frustum are not tested. Call updateWorldTransforms first.
+    void cull( const Frustum& frustum, std::vector<VisibleMesh>& visibleMeshes ) const;
+
+    // Removing a child moves the last child into its slot, so the order of the children is not preserved.
+    // A removed child becomes the root of its own scene graph.
     void addChild( std::shared_ptr<SceneNode> child );
     void removeChild( std::shared_ptr<SceneNode> child );
     const std::vector<std::shared_ptr<SceneNode>>& getChildren() const;
@@ -38,18 +75,45 @@ public:
     void addMesh( std::shared_ptr<Mesh> mesh );
     const std::vector<std::shared_ptr<Mesh>>& getMeshes() const;
 
-protected:
-    glm::mat4 getParentWorldTransform() const;
+    // The scene graph that stores this node. Nodes move to the scene graph of their parent.
+    const std::shared_ptr<SceneGraph>& getSceneGraph() const
+    {
+        return sceneGraph;
+    }
+
+    // The index of this node in the arrays of the scene graph. Changes when the scene graph is updated.
+    uint32_t getIndex() const
+    {
+        return index;
+    }
 
 private:
+    friend class SceneGraph;
+
+    // Remove this node from the children of its parent. The node stays in the scene graph of the parent.
+    // The caller must hold a reference to this node, since the parent releases its reference.
+    void detachFromParent();
+
     std::string name;
 
-    // Local transformation of the node (relative to its parent)
-    glm::mat4 localTransform;
-    glm::mat4 inverseTransform;
+    std::shared_ptr<SceneGraph> sceneGraph;
+    uint32_t                    index = SceneGraph::InvalidIndex;
 
     std::weak_ptr<SceneNode>                parent;
+    std::size_t                             childIndex = 0;  // The index of this node in the children of its parent.
     std::vector<std::shared_ptr<SceneNode>> children;
     std::vector<std::shared_ptr<Mesh>>      meshes;
 };
+
+// A mesh that passed frustum culling and the node that it is rendered with.
+struct VisibleMesh
+{
+    std::shared_ptr<const SceneNode> node;
+    std::shared_ptr<Mesh>            mesh;
+
+    bool operator==( const VisibleMesh& other ) const
+    {
+        return node == other.node && mesh == other.mesh;
+    }
+};
 }  // namespace WebGPUlib
\ No newline at end of file
@@ -2,6 +2,7 @@
 
 #include <webgpu/webgpu.h>
 
+#include <memory>
 #include <unordered_map>
 
 namespace WebGPUlib
@@ -0,0 +1,98 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <filesystem>
+#include <memory>
+#include <string>
+#include <unordered_map>
+
+namespace WebGPUlib
+{
+class Texture;
+
+// Options that change the texture that is created when a texture file is loaded.
+// The same file loaded with different options results in different textures.
+struct TextureLoadOptions
+{
+    // Generate the full mip chain of the texture.
+    bool generateMips = true;
+
+    // Block compress the texture (BC1 or BC3, or BC5 for normal maps) if the device supports it.
+    // Compressed textures are cached on disk next to the texture file.
+    bool compress = false;
+
+    // The texture is a tangent-space normal map. Compressed normal maps only store the x and y components.
+    bool normalMap = false;
+
+    bool operator==( const TextureLoadOptions& other ) const noexcept
+    {
+        return generateMips == other.generateMips && compress == other.compress && normalMap == other.normalMap;
+    }
+};
+
+// Caches the textures that were loaded from files, keyed by the canonical file path and the load options.
+// The cache does not keep the textures alive: a texture is released when it is no longer referenced
+// (for example by a material), and loaded again the next time it is requested.
+class TextureCache
+{
+public:
+    struct Key
+    {
+        std::string        filePath;
+        TextureLoadOptions options;
+
+        bool operator==( const Key& other ) const noexcept
+        {
+            return filePath == other.filePath && options == other.options;
+        }
+    };
+
+    struct KeyHash
+    {
+        std::size_t operator()( const Key& key ) const noexcept;
+    };
+
+    TextureCache()  = default;
+    ~TextureCache() = default;
+
+    TextureCache( const TextureCache& )                = delete;
+    TextureCache( TextureCache&& ) noexcept            = delete;
+    TextureCache& operator=( const TextureCache& )     = delete;
+    TextureCache& operator=( TextureCache&& ) noexcept = delete;
+
+    // Get the cache key of a texture file. Paths that refer to the same file result in the same key.
+    static Key getKey( const std::filesystem::path& filePath, const TextureLoadOptions& options );
+
+    // Get a cached texture. Returns nullptr if the texture is not cached or it has been released.
+    std::shared_ptr<Texture> find( const Key& key );
+
+    // Add a texture that was just loaded to the cache.
+    void insert( const Key& key, const std::shared_ptr<Texture>& texture );
+
+    // Remove the entries of textures that have been released.
+    void purge();
+
+    std::size_t size() const noexcept
+    {
+        return textures.size();
+    }
+
+    // The number of texture loads that were avoided because the texture was already loaded.
+    uint64_t getHitCount() const noexcept
+    {
+        return hitCount;
+    }
+
+    // The number of textures that were loaded from a file.
+    uint64_t getMissCount() const noexcept
+    {
+        return missCount;
+    }
+
+private:
+    std::unordered_map<Key, std::weak_ptr<Texture>, KeyHash> textures;
+    uint64_t                                                 hitCount  = 0;
+    uint64_t                                                 missCount = 0;
+};
+}  // namespace WebGPUlib
@@ -0,0 +1,50 @@
+#pragma once
+
+#include <webgpu/webgpu.h>
+
+#include <cstddef>
+#include <cstdint>
+#include <filesystem>
+#include <vector>
+
+namespace WebGPUlib
+{
+
+// A block compressed (BC1, BC3, or BC5) image with its mip chain.
+struct CompressedImage
+{
+    WGPUTextureFormat                 format = WGPUTextureFormat_Undefined;
+    uint32_t                          width  = 0;
+    uint32_t                          height = 0;
+    std::vector<std::vector<uint8_t>> mips;
+
+    bool isValid() const noexcept
+    {
+        return format != WGPUTextureFormat_Undefined && !mips.empty();
+    }
+
+    // The total size of all mips in bytes.
+    std::size_t getSizeInBytes() const noexcept;
+};
+
+// Block compressed formats encode blocks of 4x4 texels, so the size of the image must be a multiple of 4.
+bool canCompressImage( uint32_t width, uint32_t height ) noexcept;
+
+// Compress RGBA8 pixels. Normal maps are compressed to BC5 (only x and y are stored),
+// opaque images to BC1, and images with alpha to BC3.
+// If generateMips is true, the mip chain is generated on the CPU before it is compressed.
+CompressedImage compressImage( const uint8_t* pixels, uint32_t width, uint32_t height, bool normalMap,
+                               bool generateMips );
+
+// Hash the contents of a file with 64-bit FNV-1a. The hash is stable, so it can be stored on disk.
+uint64_t hashFileContents( const void* data, std::size_t size ) noexcept;
+
+// Load a compressed image from a cache file. Fails if the cache file was created from different file contents,
+// or if it has a different number of mips than requested (the full mip chain if generateMips is true, otherwise 1).
+bool loadCompressedImage( const std::filesystem::path& cacheFilePath, uint64_t contentHash, bool generateMips,
+                          CompressedImage& image );
+
+// Save a compressed image to a cache file.
+bool saveCompressedImage( const std::filesystem::path& cacheFilePath, uint64_t contentHash,
+                          const CompressedImage& image );
+}  // namespace WebGPUlib
@@ -18,6 +18,11 @@ public:
         return textureView;
     }
 
+    WGPUTexture getWGPUTexture() const
+    {
+        return texture;
+    }
+
     const WGPUTextureViewDescriptor& getWGPUTextureViewDescriptor() const
     {
         return textureViewDescriptor;
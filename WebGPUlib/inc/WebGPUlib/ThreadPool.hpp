@@ -0,0 +1,75 @@
+#pragma once
+
+#include <condition_variable>
+#include <cstddef>
+#include <deque>
+#include <functional>
+#include <future>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <type_traits>
+#include <vector>
+
+namespace WebGPUlib
+{
+
+// A fixed size pool of worker threads for CPU work (like decoding images).
+// Tasks must not call into WebGPU; GPU objects are created on the thread that owns the device.
+class ThreadPool
+{
+public:
+    // Create a pool with the given number of worker threads.
+    // If the thread count is 0, tasks are executed immediately on the calling thread.
+    explicit ThreadPool( std::size_t threadCount = std::thread::hardware_concurrency() );
+    ~ThreadPool();
+
+    ThreadPool( const ThreadPool& )            = delete;
+    ThreadPool( ThreadPool&& )                 = delete;
+    ThreadPool& operator=( const ThreadPool& ) = delete;
+    ThreadPool& operator=( ThreadPool&& )      = delete;
+
+    // Queue a task for execution on one of the worker threads.
+    // The returned future receives the result (or exception) of the task.
+    template<typename F>
+    std::future<std::invoke_result_t<F>> submit( F&& task );
+
+    std::size_t getThreadCount() const noexcept
+    {
+        return threads.size();
+    }
+
+private:
+    void workerThread();
+
+    std::vector<std::thread>          threads;
+    std::deque<std::function<void()>> tasks;
+    std::mutex                        mutex;
+    std::condition_variable           condition;
+    bool                              stopping = false;
+};
+
+template<typename F>
+std::future<std::invoke_result_t<F>> ThreadPool::submit( F&& task )
+{
+    using R = std::invoke_result_t<F>;
+
+    // std::function must be copyable, so the packaged task is stored in a shared pointer.
+    auto packagedTask = std::make_shared<std::packaged_task<R()>>( std::forward<F>( task ) );
+    auto future       = packagedTask->get_future();
+
+    if ( threads.empty() )
+    {
+        ( *packagedTask )();
+        return future;
+    }
+
+    {
+        std::lock_guard lock { mutex };
+        tasks.emplace_back( [packagedTask] { ( *packagedTask )(); } );
+    }
+    condition.notify_one();
+
+    return future;
+}
+}  // namespace WebGPUlib
@@ -0,0 +1,161 @@
+#pragma once
+
+#include <webgpu/webgpu.h>
+
+#include <cstddef>
+#include <deque>
+#include <memory>
+#include <vector>
+
+namespace WebGPUlib
+{
+class Queue;
+
+// A device-owned pool of upload pages that is shared by all command buffers.
+// Pages are returned to the pool when the command buffer that used them is submitted
+// and become available again once the GPU has finished the submitted work.
+class UploadPagePool
+{
+public:
+    // Upload statistics for a single frame.
+    struct Statistics
+    {
+        // The number of allocations that were written to upload pages.
+        uint64_t allocationCount = 0;
+        // The number of queue writes that were used to flush the upload pages.
+        uint64_t queueWriteCount = 0;
+        // The number of bytes that were written to the queue.
+        uint64_t bytesWritten = 0;
+    };
+
+    // Allocations are written to a CPU-side copy of the page
+    // which is written to the GPU buffer with a single queue write.
+    struct Page
+    {
+        Page( WGPUBufferUsage usage, std::size_t sizeInBytes );
+        ~Page();
+
+        Page( const Page& )            = delete;
+        Page( Page&& )                 = delete;
+        Page& operator=( const Page& ) = delete;
+        Page& operator=( Page&& )      = delete;
+
+        // Check to see if this page has sufficient storage to satisfy the requested allocation.
+        bool hasSpace( std::size_t sizeInBytes, std::size_t alignment ) const;
+
+        // Allocate memory in the page and return the offset of the allocation.
+        // The size of the allocation must not exceed the size of a single page.
+        std::size_t allocate( std::size_t sizeInBytes, std::size_t alignment );
+
+        // Get a pointer to the CPU-side copy of the page at the given offset.
+        void* getCPUAddress( std::size_t offset ) noexcept
+        {
+            return shadow.data() + offset;
+        }
+
+        // Write the allocations made since the last flush to the GPU buffer.
+        // Returns the number of bytes that were written.
+        std::size_t flush( const Queue& queue );
+
+        // Reset the page for reuse.
+        void reset();
+
+        WGPUBuffer getWGPUBuffer() const noexcept
+        {
+            return buffer;
+        }
+
+        WGPUBufferUsage getUsage() const noexcept
+        {
+            return usage;
+        }
+
+        std::size_t getPageSize() const noexcept
+        {
+            return pageSize;
+        }
+
+        // The number of allocations since the last flush.
+        std::size_t getPendingAllocationCount() const noexcept
+        {
+            return pendingAllocationCount;
+        }
+
+    private:
+        WGPUBuffer           buffer   = nullptr;
+        WGPUBufferUsage      usage    = WGPUBufferUsage_None;
+        std::size_t          pageSize = 0;
+        std::size_t          offset   = 0;
+        std::vector<uint8_t> shadow;
+
+        // The range of the page that has not been written to the GPU buffer.
+        std::size_t dirtyBegin             = 0;
+        std::size_t dirtyEnd               = 0;
+        std::size_t pendingAllocationCount = 0;
+    };
+
+    using PageList = std::vector<std::shared_ptr<Page>>;
+
+    UploadPagePool()  = default;
+    ~UploadPagePool() = default;
+
+    UploadPagePool( const UploadPagePool& )            = delete;
+    UploadPagePool( UploadPagePool&& )                 = delete;
+    UploadPagePool& operator=( const UploadPagePool& ) = delete;
+    UploadPagePool& operator=( UploadPagePool&& )      = delete;
+
+    // Get a free page with the requested usage and size, or create a new page if there are no free pages.
+    std::shared_ptr<Page> requestPage( WGPUBufferUsage usage, std::size_t pageSize );
+
+    // Return pages that were used by submitted work. The pages are recycled once
+    // the queue reports that all work submitted so far has completed.
+    void retirePages( const Queue& queue, PageList&& pages );
+
+    // Write the CPU-side copy of the pages to the GPU. Must be called before submitting
+    // the command buffer that uses the pages.
+    void flushPages( const Queue& queue, const PageList& pages );
+
+    // Call once at the end of every frame to update the frame statistics.
+    void endFrame();
+
+    // Get the upload statistics of the last completed frame.
+    const Statistics& getFrameStatistics() const noexcept
+    {
+        return frameStatistics;
+    }
+
+    // Check if there are pages waiting for the GPU to finish.
+    bool hasPendingPages() const noexcept
+    {
+        return !pendingPages.empty();
+    }
+
+    // The total number of pages that have been created by the pool.
+    std::size_t getCreatedPageCount() const noexcept
+    {
+        return createdPageCount;
+    }
+
+    std::size_t getFreePageCount() const noexcept
+    {
+        return freePages.size();
+    }
+
+private:
+    struct PendingPages
+    {
+        uint64_t fenceValue = 0;
+        PageList pages;
+    };
+
+    static void onSubmittedWorkDone( WGPUQueueWorkDoneStatus status, void* userdata );
+
+    PageList                 freePages;
+    std::deque<PendingPages> pendingPages;
+    uint64_t                 submittedFenceValue = 0;
+    uint64_t                 completedFenceValue = 0;
+    std::size_t              createdPageCount    = 0;
+    Statistics               currentStatistics;
+    Statistics               frameStatistics;
+};
+}  // namespace WebGPUlib
@@ -4,8 +4,17 @@
 
 #include <glm/vec3.hpp>
 
+#include <cstdint>
+
 namespace WebGPUlib
 {
+// The vertex layout of meshes that are created or loaded by the device.
+enum class VertexLayout
+{
+    PositionNormalTangentBitangentTexture,  // VertexPositionNormalTangentBitangentTexture (60 bytes).
+    PositionPackedNormalTangentTexture,     // VertexPositionPackedNormalTangentTexture (24 bytes).
+};
+
 struct VertexPositionNormalTexture
 {
     VertexPositionNormalTexture() = default;
@@ -44,4 +53,23 @@ struct VertexPositionNormalTangentBitangentTexture
 
     static WGPUVertexAttribute attributes[5];
 };
+
+// A compact vertex for imported meshes.
+// The normal is octahedral encoded (Snorm16x2), the tangent stores the handedness of the
+// bitangent in w (Snorm8x4), and the texture coordinates are half floats (Float16x2).
+// The bitangent is reconstructed in the shader as cross( normal, tangent.xyz ) * tangent.w.
+struct VertexPositionPackedNormalTangentTexture
+{
+    VertexPositionPackedNormalTangentTexture() = default;
+    explicit VertexPositionPackedNormalTangentTexture( const VertexPositionNormalTangentBitangentTexture& vertex );
+
+    glm::vec3 position;
+    uint32_t  normal   = 0;
+    uint32_t  tangent  = 0;
+    uint32_t  texCoord = 0;
+
+    static WGPUVertexAttribute attributes[4];
+};
+
+static_assert( sizeof( VertexPositionPackedNormalTangentTexture ) == 24 );
 }  // namespace WebGPUlib
\ No newline at end of file
@@ -3,9 +3,12 @@
 #include "Buffer.hpp"
 
 #include <cstddef>
+#include <memory>
 
 namespace WebGPUlib
 {
+class BufferArena;
+
 class VertexBuffer : public Buffer
 {
 public:
@@ -30,12 +33,21 @@ public:
         return vertexCount * vertexStride;
     }
 
+    // The arena that this buffer is allocated from, or nullptr if the buffer is not allocated from an arena.
+    const std::shared_ptr<BufferArena>& getArena() const
+    {
+        return arena;
+    }
+
 protected:
-    VertexBuffer( WGPUBuffer&& buffer, std::size_t vertexCount, std::size_t vertexStride );
-    ~VertexBuffer() override = default;
+    VertexBuffer( WGPUBuffer&& buffer, std::size_t vertexCount, std::size_t vertexStride,
+                  std::shared_ptr<BufferArena> arena = nullptr, uint64_t offset = 0 );
+    ~VertexBuffer() override;
 
 private:
     std::size_t vertexCount  = 0;
     std::size_t vertexStride = 0;
+
+    std::shared_ptr<BufferArena> arena;
 };
 }  // namespace WebGPUlib
\ No newline at end of file
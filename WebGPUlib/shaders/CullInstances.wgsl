@@ -0,0 +1,178 @@
+R"(
+
+// GPU driven frustum and occlusion culling.
+// Every invocation tests the world space bounds of one instance against the view frustum.
+// Visible instances are appended to the instance list of their draw, and the instance count
+// of the indirect draw arguments of the draw is incremented.
+//
+// Occlusion culling uses two phases, so objects that become visible are drawn in the same frame:
+//   Early: Draw the instances that were visible in the previous frame (and are inside the frustum).
+//          A hierarchical-Z pyramid is built from the depth buffer after they are drawn.
+//   Late:  Test all instances against the pyramid, draw the visible instances that were not drawn
+//          in the early phase, and store the visibility of all instances for the next frame.
+
+const PHASE_FRUSTUM = 0u; // Frustum culling only.
+const PHASE_EARLY   = 1u;
+const PHASE_LATE    = 2u;
+
+struct Parameters
+{
+    planes         : array<vec4f, 6>, // The frustum planes (xyz: normal, w: distance) pointing into the frustum.
+    viewProjection : mat4x4f,
+    depthSize      : vec2f,           // The size of the depth texture the Hi-Z pyramid was built from.
+    instanceCount  : u32,
+    hiZMipCount    : u32,
+    phase          : u32,
+};
+
+struct Instance
+{
+    model     : mat4x4f,
+    modelIT   : mat4x4f, // Inverse-transpose
+    minBounds : vec3f,   // World space bounds.
+    drawIndex : u32,
+    maxBounds : vec3f,
+    padding   : u32,
+};
+
+// The arguments of wgpuRenderPassEncoderDrawIndexedIndirect.
+struct DrawIndexedIndirect
+{
+    indexCount    : u32,
+    instanceCount : atomic<u32>, // Reset to 0 before culling.
+    firstIndex    : u32,
+    baseVertex    : i32,
+    firstInstance : u32,
+};
+
+struct Matrices
+{
+    model   : mat4x4f,
+    modelIT : mat4x4f,
+};
+
+// The first instance of each draw in the visible instance list.
+struct Draw
+{
+    instanceOffset : u32,
+};
+
+@group(0) @binding(0) var<uniform> params : Parameters;
+@group(0) @binding(1) var<storage, read> instances : array<Instance>;
+@group(0) @binding(2) var<storage, read> draws : array<Draw>;
+@group(0) @binding(3) var<storage, read_write> drawArguments : array<DrawIndexedIndirect>;
+@group(0) @binding(4) var<storage, read_write> visibleInstances : array<Matrices>;
+@group(0) @binding(5) var<storage, read_write> visibility : array<u32>; // Written in the late phase.
+@group(0) @binding(6) var hiZ : texture_2d<f32>; // Only used in the late phase.
+
+// Returns true if the axis aligned bounding box intersects the frustum.
+fn isVisible( minBounds : vec3f, maxBounds : vec3f ) -> bool
+{
+    for ( var i = 0u; i < 6u; i++ )
+    {
+        let plane = params.planes[i];
+
+        // The corner of the box that is furthest in the direction of the plane normal.
+        let p = select( minBounds, maxBounds, plane.xyz >= vec3f( 0.0 ) );
+        if ( dot( plane.xyz, p ) + plane.w < 0.0 )
+        {
+            return false;
+        }
+    }
+
+    return true;
+}
+
+// Returns true if the bounding box is behind the depth in the Hi-Z pyramid.
+fn isOccluded( minBounds : vec3f, maxBounds : vec3f ) -> bool
+{
+    // The screen space rectangle and the nearest depth of the box.
+    var minUV    = vec2f( 1.0 );
+    var maxUV    = vec2f( 0.0 );
+    var minDepth = 1.0;
+
+    for ( var i = 0u; i < 8u; i++ )
+    {
+        let corner = select( minBounds, maxBounds, vec3<bool>( ( i & 1u ) != 0u, ( i & 2u ) != 0u, ( i & 4u ) != 0u ) );
+        let clip   = params.viewProjection * vec4f( corner, 1.0 );
+
+        // Boxes that cross the near plane are always visible.
+        if ( clip.w <= 0.0 )
+        {
+            return false;
+        }
+
+        let ndc = clip.xyz / clip.w;
+        let uv  = ndc.xy * vec2f( 0.5, -0.5 ) + 0.5;
+
+        minUV    = min( minUV, uv );
+        maxUV    = max( maxUV, uv );
+        minDepth = min( minDepth, ndc.z );
+    }
+
+    minUV = clamp( minUV, vec2f( 0.0 ), vec2f( 1.0 ) );
+    maxUV = clamp( maxUV, vec2f( 0.0 ), vec2f( 1.0 ) );
+
+    // The rectangle in depth texels.
+    let minTexel = vec2u( minUV * params.depthSize );
+    let maxTexel = vec2u( maxUV * params.depthSize );
+
+    // Choose the mip where the rectangle covers at most 2x2 texels.
+    // A texel of mip m covers 2^(m + 1) depth texels in each dimension.
+    let size = vec2f( maxTexel - minTexel + 1u );
+    let mip  = u32( clamp( ceil( log2( max( size.x, size.y ) ) ) - 1.0, 0.0, f32( params.hiZMipCount - 1u ) ) );
+
+    let mipSize  = textureDimensions( hiZ, mip );
+    let mipFirst = min( minTexel >> vec2u( mip + 1u ), mipSize - 1u );
+    let mipLast  = min( maxTexel >> vec2u( mip + 1u ), mipSize - 1u );
+
+    // The farthest depth of the occluders in the rectangle.
+    var maxDepth = 0.0;
+    for ( var y = mipFirst.y; y <= mipLast.y; y++ )
+    {
+        for ( var x = mipFirst.x; x <= mipLast.x; x++ )
+        {
+            maxDepth = max( maxDepth, textureLoad( hiZ, vec2u( x, y ), mip ).g );
+        }
+    }
+
+    return minDepth > maxDepth;
+}
+
+@compute @workgroup_size( 64 )
+fn main( @builtin(global_invocation_id) id : vec3u )
+{
+    let instanceIndex = id.x;
+    if ( instanceIndex >= params.instanceCount )
+    {
+        return;
+    }
+
+    let instance = instances[instanceIndex];
+    var visible  = isVisible( instance.minBounds, instance.maxBounds );
+
+    if ( params.phase == PHASE_EARLY )
+    {
+        visible = visible && visibility[instanceIndex] != 0u;
+    }
+    else if ( params.phase == PHASE_LATE )
+    {
+        visible = visible && !isOccluded( instance.minBounds, instance.maxBounds );
+
+        // Instances that were visible in the previous frame have already been drawn in the early phase.
+        let wasVisible = visibility[instanceIndex] != 0u;
+        visibility[instanceIndex] = select( 0u, 1u, visible );
+        visible = visible && !wasVisible;
+    }
+
+    if ( !visible )
+    {
+        return;
+    }
+
+    let drawIndex = instance.drawIndex;
+    let slot      = atomicAdd( &drawArguments[drawIndex].instanceCount, 1u );
+
+    visibleInstances[draws[drawIndex].instanceOffset + slot] = Matrices( instance.model, instance.modelIT );
+}
+)"
@@ -0,0 +1,208 @@
+R"(
+
+// Single pass downsampler.
+// Generates up to 12 mips of a texture (up to 4096x4096) with a single dispatch.
+// Every workgroup downsamples a 64x64 tile of mip 0 to a single texel (mips 1-6).
+// The last workgroup to finish (determined with a global atomic counter) then
+// downsamples mip 6 (up to 64x64 texels) to a single texel (mips 7-12).
+// Each mip texel is the average of a 2x2 block of texels in the previous mip.
+// NOTE: WGSL atomics are relaxed and storageBarrier only orders memory within a workgroup, so nothing in the
+// memory model guarantees that the last workgroup sees the mip 6 texels of the other workgroups. This relies on
+// the behaviour of current implementations, which is why Device::generateMips (a dispatch per mip) is the default.
+
+struct Parameters
+{
+    numMips : u32, // The number of mips to generate (not including mip 0).
+};
+
+struct Counter
+{
+    value : atomic<u32>, // The number of workgroups that have finished mips 1-6.
+};
+
+@group(0) @binding(0) var<uniform> params : Parameters;
+
+// The source mip level to downscale.
+@group(0) @binding(1) var srcMip : texture_2d<f32>;
+
+// Unused mips are bound to placeholder textures.
+@group(0) @binding(2) var dstMip1 : texture_storage_2d<rgba8unorm, write>;
+@group(0) @binding(3) var dstMip2 : texture_storage_2d<rgba8unorm, write>;
+@group(0) @binding(4) var dstMip3 : texture_storage_2d<rgba8unorm, write>;
+@group(0) @binding(5) var dstMip4 : texture_storage_2d<rgba8unorm, write>;
+@group(0) @binding(6) var dstMip5 : texture_storage_2d<rgba8unorm, write>;
+@group(0) @binding(7) var dstMip6 : texture_storage_2d<rgba8unorm, write>;
+@group(0) @binding(8) var dstMip7 : texture_storage_2d<rgba8unorm, write>;
+@group(0) @binding(9) var dstMip8 : texture_storage_2d<rgba8unorm, write>;
+@group(0) @binding(10) var dstMip9 : texture_storage_2d<rgba8unorm, write>;
+@group(0) @binding(11) var dstMip10 : texture_storage_2d<rgba8unorm, write>;
+@group(0) @binding(12) var dstMip11 : texture_storage_2d<rgba8unorm, write>;
+@group(0) @binding(13) var dstMip12 : texture_storage_2d<rgba8unorm, write>;
+
+// The counter is reset by the last workgroup, so it is 0 at the start of every dispatch.
+@group(0) @binding(14) var<storage, read_write> counter : Counter;
+
+// Mip 6 is also stored in a buffer, so the last workgroup can read the texels written by the other workgroups.
+// The texels are packed (RGBA8 unorm, the same as the mip texture) and accessed with atomics, which makes
+// stale reads less likely in practice but is not a guarantee (see above).
+@group(0) @binding(15) var<storage, read_write> mip6 : array<atomic<u32>>;
+
+// The texels of the current mip of the tile. Stored with a stride of 16 texels.
+var<workgroup> gs_Color : array<vec4f, 256>;
+var<workgroup> gs_IsLastWorkgroup : u32;
+
+// Get the dimensions of a mip of the texture.
+fn mipSize( level : u32 ) -> vec2u
+{
+    return max( textureDimensions( srcMip ) >> vec2u( level ), vec2u( 1u ) );
+}
+
+// Load a texel of mip 0 (stage 0) or mip 6 (stage 1). Coordinates are clamped to the size of the mip.
+fn loadColor( base : u32, coord : vec2u ) -> vec4f
+{
+    let c = min( coord, mipSize( base ) - 1u );
+
+    if ( base == 0u )
+    {
+        return textureLoad( srcMip, c, 0 );
+    }
+
+    return unpack4x8unorm( atomicLoad( &mip6[c.y * mipSize( 6u ).x + c.x] ) );
+}
+
+fn storeColor( level : u32, coord : vec2u, color : vec4f )
+{
+    if ( level > params.numMips || any( coord >= mipSize( level ) ) )
+    {
+        return;
+    }
+
+    switch level {
+        case 1u: { textureStore( dstMip1, coord, color ); }
+        case 2u: { textureStore( dstMip2, coord, color ); }
+        case 3u: { textureStore( dstMip3, coord, color ); }
+        case 4u: { textureStore( dstMip4, coord, color ); }
+        case 5u: { textureStore( dstMip5, coord, color ); }
+        case 6u: { textureStore( dstMip6, coord, color ); }
+        case 7u: { textureStore( dstMip7, coord, color ); }
+        case 8u: { textureStore( dstMip8, coord, color ); }
+        case 9u: { textureStore( dstMip9, coord, color ); }
+        case 10u: { textureStore( dstMip10, coord, color ); }
+        case 11u: { textureStore( dstMip11, coord, color ); }
+        case 12u: { textureStore( dstMip12, coord, color ); }
+        default: {}
+    }
+}
+
+// Downsample a 64x64 tile of mip `base` to a single texel (mips base + 1 to base + 6).
+// The texel of the last mip is left in gs_Color[0].
+// If the previous mip has an odd size, the last row or column is repeated.
+fn downsampleTile( base : u32, tile : vec2u, localId : vec2u, localIndex : u32 )
+{
+    // Each thread downsamples a 4x4 block of the source mip to a 2x2 block of mip base + 1.
+    let srcCoord = tile * 64u + localId * 4u;
+    var colors : array<vec4f, 4>;
+
+    for ( var i = 0u; i < 4u; i++ )
+    {
+        let offset = vec2u( i & 1u, i >> 1u );
+        let c      = srcCoord + offset * 2u;
+
+        colors[i] = 0.25f * ( loadColor( base, c ) + loadColor( base, c + vec2u( 1u, 0u ) ) +
+                              loadColor( base, c + vec2u( 0u, 1u ) ) + loadColor( base, c + vec2u( 1u, 1u ) ) );
+
+        storeColor( base + 1u, tile * 32u + localId * 2u + offset, colors[i] );
+    }
+
+    // And then to a single texel of mip base + 2.
+    let size1 = mipSize( base + 1u );
+    let coord1 = tile * 32u + localId * 2u;
+    if ( coord1.x + 1u >= size1.x )
+    {
+        colors[1] = colors[0];
+        colors[3] = colors[2];
+    }
+    if ( coord1.y + 1u >= size1.y )
+    {
+        colors[2] = colors[0];
+        colors[3] = colors[1];
+    }
+
+    var color = 0.25f * ( colors[0] + colors[1] + colors[2] + colors[3] );
+    storeColor( base + 2u, tile * 16u + localId, color );
+    gs_Color[localIndex] = color;
+
+    // Mips base + 3 to base + 6 are downsampled in workgroup memory (8x8, 4x4, 2x2, and 1x1 texels per tile).
+    for ( var level = 3u; level <= 6u; level++ )
+    {
+        workgroupBarrier();
+
+        let size     = 16u >> ( level - 2u );
+        let isActive = all( localId < vec2u( size ) );
+
+        if ( isActive )
+        {
+            let prevSize  = mipSize( base + level - 1u );
+            let prevCoord = tile * ( size * 2u ) + localId * 2u;
+            let dx        = select( 1u, 0u, prevCoord.x + 1u >= prevSize.x );
+            let dy        = select( 16u, 0u, prevCoord.y + 1u >= prevSize.y );
+            let i         = localId.y * 32u + localId.x * 2u;
+
+            color = 0.25f * ( gs_Color[i] + gs_Color[i + dx] + gs_Color[i + dy] + gs_Color[i + dx + dy] );
+            storeColor( base + level, tile * size + localId, color );
+        }
+
+        workgroupBarrier();
+
+        if ( isActive )
+        {
+            gs_Color[localId.y * 16u + localId.x] = color;
+        }
+    }
+}
+
+@compute @workgroup_size(16, 16, 1)
+fn main( @builtin(local_invocation_id) localId : vec3u,
+         @builtin(local_invocation_index) localIndex : u32,
+         @builtin(workgroup_id) groupId : vec3u,
+         @builtin(num_workgroups) numWorkgroups : vec3u )
+{
+    // Mips 1-6 of the tile of this workgroup.
+    downsampleTile( 0u, groupId.xy, localId.xy, localIndex );
+
+    if ( params.numMips <= 6u )
+    {
+        return;
+    }
+
+    // Workgroups outside of mip 6 only exist because the texture size is not a multiple of 64.
+    let size6 = mipSize( 6u );
+    if ( localIndex == 0u && all( groupId.xy < size6 ) )
+    {
+        atomicStore( &mip6[groupId.y * size6.x + groupId.x], pack4x8unorm( gs_Color[0] ) );
+    }
+
+    // Order the mip 6 store before the counter increment within the workgroup. This does not order it
+    // for other workgroups (see above).
+    storageBarrier();
+
+    if ( localIndex == 0u )
+    {
+        let finished = atomicAdd( &counter.value, 1u ) + 1u;
+        gs_IsLastWorkgroup = select( 0u, 1u, finished == numWorkgroups.x * numWorkgroups.y );
+    }
+
+    if ( workgroupUniformLoad( &gs_IsLastWorkgroup ) == 0u )
+    {
+        return;
+    }
+
+    // The last workgroup generates mips 7-12 from mip 6.
+    downsampleTile( 6u, vec2u( 0u ), localId.xy, localIndex );
+
+    if ( localIndex == 0u )
+    {
+        atomicStore( &counter.value, 0u );
+    }
+}
+)"
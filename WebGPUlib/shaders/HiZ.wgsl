@@ -0,0 +1,108 @@
+R"(
+
+// Builds a hierarchical-Z pyramid from a depth texture.
+// Each texel of the pyramid stores the minimum (r) and maximum (g) depth of the texels it covers.
+// Mip 0 of the pyramid is half the size of the depth texture, and each dispatch downsamples one mip.
+// If a dimension of the source is odd, the last texel of the destination also covers the last texel
+// of the source, so the pyramid stays conservative for any size.
+
+struct Parameters
+{
+    srcSize : vec2u, // The size of the source mip (or depth texture).
+    dstSize : vec2u, // The size of the destination mip.
+};
+
+@group(0) @binding(0) var<uniform> params : Parameters;
+
+@group(0) @binding(1) var dstMip : texture_storage_2d<rg32float, write>;
+
+// Each entry point only uses one of the sources, so they can share a binding.
+@group(0) @binding(2) var srcDepth : texture_depth_2d;
+@group(0) @binding(2) var srcDepthMultisampled : texture_depth_multisampled_2d;
+@group(0) @binding(2) var srcMip : texture_2d<f32>;
+
+// The last texel of the source that is covered by a texel of the destination.
+fn footprintEnd( dst : vec2u ) -> vec2u
+{
+    let end   = dst * 2u + 1u;
+    let extra = ( dst == params.dstSize - 1u ) & ( ( params.srcSize & vec2u( 1u ) ) == vec2u( 1u ) );
+    return min( select( end, end + 1u, extra ), params.srcSize - 1u );
+}
+
+@compute @workgroup_size( 8, 8 )
+fn downsampleDepth( @builtin(global_invocation_id) id : vec3u )
+{
+    if ( any( id.xy >= params.dstSize ) )
+    {
+        return;
+    }
+
+    let first = id.xy * 2u;
+    let last  = footprintEnd( id.xy );
+
+    var result = vec2f( 1.0, 0.0 );
+    for ( var y = first.y; y <= last.y; y++ )
+    {
+        for ( var x = first.x; x <= last.x; x++ )
+        {
+            let depth = textureLoad( srcDepth, vec2u( x, y ), 0 );
+            result    = vec2f( min( result.x, depth ), max( result.y, depth ) );
+        }
+    }
+
+    textureStore( dstMip, id.xy, vec4f( result, 0.0, 0.0 ) );
+}
+
+@compute @workgroup_size( 8, 8 )
+fn downsampleDepthMultisampled( @builtin(global_invocation_id) id : vec3u )
+{
+    if ( any( id.xy >= params.dstSize ) )
+    {
+        return;
+    }
+
+    let first       = id.xy * 2u;
+    let last        = footprintEnd( id.xy );
+    let sampleCount = textureNumSamples( srcDepthMultisampled );
+
+    // All samples of a texel are reduced, since any of them may be covered by an occluder.
+    var result = vec2f( 1.0, 0.0 );
+    for ( var y = first.y; y <= last.y; y++ )
+    {
+        for ( var x = first.x; x <= last.x; x++ )
+        {
+            for ( var s = 0u; s < sampleCount; s++ )
+            {
+                let depth = textureLoad( srcDepthMultisampled, vec2u( x, y ), s );
+                result    = vec2f( min( result.x, depth ), max( result.y, depth ) );
+            }
+        }
+    }
+
+    textureStore( dstMip, id.xy, vec4f( result, 0.0, 0.0 ) );
+}
+
+@compute @workgroup_size( 8, 8 )
+fn downsampleHiZ( @builtin(global_invocation_id) id : vec3u )
+{
+    if ( any( id.xy >= params.dstSize ) )
+    {
+        return;
+    }
+
+    let first = id.xy * 2u;
+    let last  = footprintEnd( id.xy );
+
+    var result = vec2f( 1.0, 0.0 );
+    for ( var y = first.y; y <= last.y; y++ )
+    {
+        for ( var x = first.x; x <= last.x; x++ )
+        {
+            let minMax = textureLoad( srcMip, vec2u( x, y ), 0 ).rg;
+            result     = vec2f( min( result.x, minMax.x ), max( result.y, minMax.y ) );
+        }
+    }
+
+    textureStore( dstMip, id.xy, vec4f( result, 0.0, 0.0 ) );
+}
+)"
@@ -1,4 +1,5 @@
 #include <WebGPUlib/BindGroup.hpp>
+#include <WebGPUlib/BindGroupCache.hpp>
 #include <WebGPUlib/Buffer.hpp>
 #include <WebGPUlib/Device.hpp>
 #include <WebGPUlib/Sampler.hpp>
@@ -6,12 +7,8 @@
 
 using namespace WebGPUlib;
 
-BindGroup::BindGroup() = default;
-BindGroup::~BindGroup()
-{
-    if ( bindGroup )
-        wgpuBindGroupRelease( bindGroup );
-}
+BindGroup::BindGroup()  = default;
+BindGroup::~BindGroup() = default;
 
 void BindGroup::bind( uint32_t binding, WGPUBuffer buffer, uint64_t offset, uint64_t size )
 {
@@ -25,11 +22,13 @@ void BindGroup::bind( uint32_t binding, WGPUBuffer buffer, uint64_t offset, uint
     entry.size    = size;
 
     bindings[binding] = entry;
+    dynamicOffsets.erase( binding );
 }
 
 void BindGroup::bind( uint32_t binding, const Buffer& buffer, uint64_t offset, std::optional<uint64_t> size )
 {
-    bind( binding, buffer.getWGPUBuffer(), offset, size ? *size : buffer.getSize() );
+    // Buffers that are allocated from a buffer arena start at an offset in the WGPUBuffer.
+    bind( binding, buffer.getWGPUBuffer(), buffer.getOffset() + offset, size ? *size : buffer.getSize() );
 }
 
 void BindGroup::bind( uint32_t binding, const Sampler& sampler )
@@ -42,6 +41,7 @@ void BindGroup::bind( uint32_t binding, const Sampler& sampler )
     entry.sampler = sampler.getWGPUSampler();
 
     bindings[binding] = entry;
+    dynamicOffsets.erase( binding );
 }
 
 void BindGroup::bind( uint32_t binding, const TextureView& textureView )
@@ -54,21 +54,37 @@ void BindGroup::bind( uint32_t binding, const TextureView& textureView )
     entry.textureView = textureView.getWGPUTextureView();
 
     bindings[binding] = entry;
+    dynamicOffsets.erase( binding );
 }
 
-WGPUBindGroup BindGroup::getWGPUBindGroup( WGPUBindGroupLayout layout ) const
+void BindGroup::bindDynamic( uint32_t binding, WGPUBuffer buffer, uint32_t dynamicOffset, uint64_t size )
 {
-    if ( bindGroup )
-        wgpuBindGroupRelease( bindGroup );
+    if ( bindings.size() <= binding )
+        bindings.resize( binding + 1, {} );
+
+    WGPUBindGroupEntry entry {};
+    entry.binding = binding;
+    entry.buffer  = buffer;
+    entry.offset  = 0;
+    entry.size    = size;
+
+    bindings[binding]       = entry;
+    dynamicOffsets[binding] = dynamicOffset;
+}
 
-    WGPUBindGroupDescriptor bindGroupDescriptor {};
-    bindGroupDescriptor.layout     = layout;
-    bindGroupDescriptor.entryCount = bindings.size();
-    bindGroupDescriptor.entries    = bindings.data();
+const std::vector<uint32_t>& BindGroup::getDynamicOffsets() const
+{
+    dynamicOffsetArray.clear();
 
-    auto device = Device::get().getWGPUDevice();
+    for ( const auto& [binding, offset]: dynamicOffsets )
+    {
+        dynamicOffsetArray.push_back( offset );
+    }
 
-    bindGroup = wgpuDeviceCreateBindGroup( device, &bindGroupDescriptor );
+    return dynamicOffsetArray;
+}
 
-    return bindGroup;
+WGPUBindGroup BindGroup::getWGPUBindGroup( WGPUBindGroupLayout layout ) const
+{
+    return Device::get().getBindGroupCache().getBindGroup( layout, bindings );
 }
\ No newline at end of file
@@ -0,0 +1,156 @@
+#include <WebGPUlib/BindGroupCache.hpp>
+#include <WebGPUlib/Device.hpp>
+#include <WebGPUlib/Hash.hpp>
+
+#include <iterator>
+
+#ifdef WEBGPU_BACKEND_DAWN
+void wgpuBindGroupLayoutReference( WGPUBindGroupLayout bindGroupLayout )
+{
+    wgpuBindGroupLayoutAddRef( bindGroupLayout );
+}
+
+void wgpuSamplerReference( WGPUSampler sampler )
+{
+    wgpuSamplerAddRef( sampler );
+}
+
+// Defined in BufferArena.cpp and TextureView.cpp.
+void wgpuBufferReference( WGPUBuffer buffer );
+void wgpuTextureViewReference( WGPUTextureView textureView );
+#endif
+
+using namespace WebGPUlib;
+
+// Cached entries hold a reference on the layout and the resources of their key, so a released handle can't be
+// reused for a new object (with the same address) while an entry still refers to it.
+static void addRef( WGPUBindGroupLayout layout, const std::vector<WGPUBindGroupEntry>& entries )
+{
+    wgpuBindGroupLayoutReference( layout );
+    for ( const auto& entry: entries )
+    {
+        if ( entry.buffer )
+            wgpuBufferReference( entry.buffer );
+        if ( entry.sampler )
+            wgpuSamplerReference( entry.sampler );
+        if ( entry.textureView )
+            wgpuTextureViewReference( entry.textureView );
+    }
+}
+
+static void release( WGPUBindGroupLayout layout, const std::vector<WGPUBindGroupEntry>& entries )
+{
+    wgpuBindGroupLayoutRelease( layout );
+    for ( const auto& entry: entries )
+    {
+        if ( entry.buffer )
+            wgpuBufferRelease( entry.buffer );
+        if ( entry.sampler )
+            wgpuSamplerRelease( entry.sampler );
+        if ( entry.textureView )
+            wgpuTextureViewRelease( entry.textureView );
+    }
+}
+
+BindGroupCache::BindGroupCache( std::size_t maxSize, uint64_t maxAge )
+: maxSize { maxSize }
+, maxAge { maxAge }
+{}
+
+BindGroupCache::~BindGroupCache()
+{
+    clear();
+}
+
+WGPUBindGroup BindGroupCache::getBindGroup( WGPUBindGroupLayout layout, const std::vector<WGPUBindGroupEntry>& entries )
+{
+    std::size_t hash = 0;
+    std::hash_combine( hash, layout );
+    for ( const auto& entry: entries )
+    {
+        std::hash_combine( hash, entry );
+    }
+
+    // Look for a bind group with the same layout and entries.
+    auto range = lookup.equal_range( hash );
+    for ( auto it = range.first; it != range.second; ++it )
+    {
+        auto& cached = *it->second;
+        if ( cached.layout == layout && cached.entries == entries )
+        {
+            // Move the entry to the front of the LRU list.
+            lruList.splice( lruList.begin(), lruList, it->second );
+            cached.lastUsedFrame = currentFrame;
+            ++hitCount;
+
+            return cached.bindGroup;
+        }
+    }
+
+    ++missCount;
+
+    WGPUBindGroupDescriptor bindGroupDescriptor {};
+    bindGroupDescriptor.layout     = layout;
+    bindGroupDescriptor.entryCount = entries.size();
+    bindGroupDescriptor.entries    = entries.data();
+
+    WGPUBindGroup bindGroup = wgpuDeviceCreateBindGroup( Device::get().getWGPUDevice(), &bindGroupDescriptor );
+
+    // Make room for the new entry.
+    if ( lruList.size() >= maxSize && !lruList.empty() )
+    {
+        evict( std::prev( lruList.end() ) );
+    }
+
+    addRef( layout, entries );
+
+    lruList.push_front( { layout, entries, hash, bindGroup, currentFrame } );
+    lookup.emplace( hash, lruList.begin() );
+
+    return bindGroup;
+}
+
+void BindGroupCache::endFrame()
+{
+    ++currentFrame;
+
+    // The least recently used entries are at the back of the list.
+    while ( !lruList.empty() && lruList.back().lastUsedFrame + maxAge < currentFrame )
+    {
+        evict( std::prev( lruList.end() ) );
+    }
+}
+
+void BindGroupCache::clear()
+{
+    for ( auto& entry: lruList )
+    {
+        if ( entry.bindGroup )
+            wgpuBindGroupRelease( entry.bindGroup );
+
+        release( entry.layout, entry.entries );
+    }
+
+    lruList.clear();
+    lookup.clear();
+}
+
+void BindGroupCache::evict( LRUList::iterator it )
+{
+    auto range = lookup.equal_range( it->hash );
+    for ( auto l = range.first; l != range.second; ++l )
+    {
+        if ( l->second == it )
+        {
+            lookup.erase( l );
+            break;
+        }
+    }
+
+    if ( it->bindGroup )
+        wgpuBindGroupRelease( it->bindGroup );
+
+    release( it->layout, it->entries );
+
+    lruList.erase( it );
+}
@@ -0,0 +1,61 @@
+#include <WebGPUlib/BoundingBox.hpp>
+
+#include <glm/common.hpp>
+
+using namespace WebGPUlib;
+
+bool BoundingBox::isValid() const
+{
+    return min.x <= max.x && min.y <= max.y && min.z <= max.z;
+}
+
+glm::vec3 BoundingBox::getCenter() const
+{
+    return ( min + max ) * 0.5f;
+}
+
+glm::vec3 BoundingBox::getExtents() const
+{
+    return ( max - min ) * 0.5f;
+}
+
+void BoundingBox::merge( const glm::vec3& point )
+{
+    min = glm::min( min, point );
+    max = glm::max( max, point );
+}
+
+void BoundingBox::merge( const BoundingBox& boundingBox )
+{
+    if ( !boundingBox.isValid() )
+        return;
+
+    min = glm::min( min, boundingBox.min );
+    max = glm::max( max, boundingBox.max );
+}
+
+BoundingBox BoundingBox::transform( const glm::mat4& transform ) const
+{
+    if ( !isValid() )
+        return {};
+
+    // Transform the box one axis at a time instead of transforming all 8 corners.
+    // Source: Jim Arvo, "Transforming Axis-Aligned Bounding Boxes", Graphics Gems (1990).
+    glm::vec3 translation { transform[3] };
+
+    BoundingBox result { translation, translation };
+
+    for ( int i = 0; i < 3; ++i )
+    {
+        for ( int j = 0; j < 3; ++j )
+        {
+            float a = transform[i][j] * min[i];
+            float b = transform[i][j] * max[i];
+
+            result.min[j] += glm::min( a, b );
+            result.max[j] += glm::max( a, b );
+        }
+    }
+
+    return result;
+}
@@ -0,0 +1,97 @@
+#include <WebGPUlib/BufferArena.hpp>
+#include <WebGPUlib/Device.hpp>
+#include <WebGPUlib/Helpers.hpp>
+
+#ifdef WEBGPU_BACKEND_DAWN
+void wgpuBufferReference( WGPUBuffer buffer )
+{
+    wgpuBufferAddRef( buffer );
+}
+#endif
+
+using namespace WebGPUlib;
+
+BufferArena::BufferArena( WGPUBufferUsage usage, std::size_t _size, const char* label )
+: size { AlignUp( _size, 4 ) }
+{
+    WGPUBufferDescriptor bufferDescriptor {};
+    bufferDescriptor.label = label;
+    bufferDescriptor.size  = size;
+    bufferDescriptor.usage = usage | WGPUBufferUsage_CopyDst;
+
+    buffer = wgpuDeviceCreateBuffer( Device::get().getWGPUDevice(), &bufferDescriptor );
+
+    freeRanges[0] = size;
+}
+
+BufferArena::~BufferArena()
+{
+    if ( buffer )
+        wgpuBufferRelease( buffer );
+}
+
+std::optional<uint64_t> BufferArena::allocate( std::size_t sizeInBytes, std::size_t alignment )
+{
+    // Queue writes require the size to be a multiple of 4 bytes.
+    sizeInBytes = AlignUp( sizeInBytes, 4 );
+
+    for ( auto it = freeRanges.begin(); it != freeRanges.end(); ++it )
+    {
+        uint64_t    rangeOffset = it->first;
+        std::size_t rangeSize   = it->second;
+
+        // The alignment is not required to be a power of 2 (for example, the vertex stride).
+        uint64_t alignedOffset = ( rangeOffset + alignment - 1 ) / alignment * alignment;
+        if ( alignedOffset + sizeInBytes > rangeOffset + rangeSize )
+            continue;
+
+        freeRanges.erase( it );
+
+        // Return the unused parts of the range to the free list.
+        if ( alignedOffset > rangeOffset )
+            freeRanges[rangeOffset] = alignedOffset - rangeOffset;
+
+        uint64_t end = alignedOffset + sizeInBytes;
+        if ( end < rangeOffset + rangeSize )
+            freeRanges[end] = rangeOffset + rangeSize - end;
+
+        usedSize += sizeInBytes;
+
+        return alignedOffset;
+    }
+
+    return {};
+}
+
+void BufferArena::free( uint64_t offset, std::size_t sizeInBytes )
+{
+    sizeInBytes = AlignUp( sizeInBytes, 4 );
+    usedSize -= sizeInBytes;
+
+    auto it = freeRanges.emplace( offset, sizeInBytes ).first;
+
+    // Merge with the next range.
+    auto next = std::next( it );
+    if ( next != freeRanges.end() && it->first + it->second == next->first )
+    {
+        it->second += next->second;
+        freeRanges.erase( next );
+    }
+
+    // Merge with the previous range.
+    if ( it != freeRanges.begin() )
+    {
+        auto prev = std::prev( it );
+        if ( prev->first + prev->second == it->first )
+        {
+            prev->second += it->second;
+            freeRanges.erase( it );
+        }
+    }
+}
+
+WGPUBuffer BufferArena::referenceWGPUBuffer() const
+{
+    wgpuBufferReference( buffer );
+    return buffer;
+}
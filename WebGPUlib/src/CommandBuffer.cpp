@@ -2,10 +2,13 @@
 #include "WebGPUlib/Queue.hpp"
 
 #include <WebGPUlib/BindGroup.hpp>
+#include <WebGPUlib/Buffer.hpp>
 #include <WebGPUlib/CommandBuffer.hpp>
 #include <WebGPUlib/Device.hpp>
 #include <WebGPUlib/UploadBuffer.hpp>
 
+#include <cstring>
+
 #ifdef WEBGPU_BACKEND_DAWN
 void wgpuCommandEncoderReference( WGPUCommandEncoder encoder )
 {
@@ -27,47 +30,83 @@ struct MakeUploadBuffer : UploadBuffer
     {}
 };
 
-std::shared_ptr<BindGroup> CommandBuffer::getBindGroup( uint32_t groupIndex )
+BindGroup& CommandBuffer::getBindGroup( uint32_t groupIndex )
 {
     if ( bindGroups.size() <= groupIndex )
         bindGroups.resize( groupIndex + 1, nullptr );
 
-    auto bindGroup = bindGroups[groupIndex];
+    auto& bindGroup = bindGroups[groupIndex];
     if ( !bindGroup )
-    {
-        bindGroup              = std::make_shared<MakeBindGroup>();
-        bindGroups[groupIndex] = bindGroup;
-    }
+        bindGroup = std::make_shared<MakeBindGroup>();
+
+    dirtyBindGroups |= 1u << groupIndex;
 
-    return bindGroup;
+    return *bindGroup;
 }
 
 void CommandBuffer::commitBindGroups()
 {
+    // Bind groups that did not change since they were last set do not need to be looked up in the bind group cache.
     for ( uint32_t i = 0; i < bindGroups.size(); ++i )
     {
-        if ( auto& bindGroup = bindGroups[i] )
-            setBindGroup( i, *bindGroup );
+        if ( bindGroups[i] && ( dirtyBindGroups & ( 1u << i ) ) )
+            setBindGroup( i, *bindGroups[i] );
+    }
+
+    dirtyBindGroups = 0;
+}
+
+bool CommandBuffer::updateBindGroupState( uint32_t groupIndex, WGPUBindGroup bindGroup,
+                                          const std::vector<uint32_t>& dynamicOffsets )
+{
+    if ( currentBindGroups.size() <= groupIndex )
+        currentBindGroups.resize( groupIndex + 1 );
+
+    auto& current = currentBindGroups[groupIndex];
+    if ( current.bindGroup == bindGroup && current.dynamicOffsets == dynamicOffsets )
+    {
+        ++statistics.bindGroupsSkipped;
+        return false;
     }
+
+    current.bindGroup      = bindGroup;
+    current.dynamicOffsets = dynamicOffsets;
+    ++statistics.bindGroupsSet;
+
+    return true;
+}
+
+void CommandBuffer::resetBindGroupState()
+{
+    currentBindGroups.clear();
+    invalidateBindGroups();
 }
 
 void CommandBuffer::bindBuffer( uint32_t groupIndex, uint32_t binding, const Buffer& buffer, uint64_t offset,
                                 std::optional<uint64_t> size )
 {
-    auto bindGroup = getBindGroup( groupIndex );
-    bindGroup->bind( binding, buffer, offset, size );
+    auto& bindGroup = getBindGroup( groupIndex );
+    bindGroup.bind( binding, buffer, offset, size );
+}
+
+void CommandBuffer::bindBufferDynamic( uint32_t groupIndex, uint32_t binding, const Buffer& buffer,
+                                       uint32_t dynamicOffset, uint64_t size )
+{
+    auto& bindGroup = getBindGroup( groupIndex );
+    bindGroup.bindDynamic( binding, buffer.getWGPUBuffer(), static_cast<uint32_t>( buffer.getOffset() ) + dynamicOffset,
+                           size );
 }
 
 void CommandBuffer::bindSampler( uint32_t groupIndex, uint32_t binding, const Sampler& sampler )
 {
-    auto bindGroup = getBindGroup( groupIndex );
-    bindGroup->bind( binding, sampler );
+    auto& bindGroup = getBindGroup( groupIndex );
+    bindGroup.bind( binding, sampler );
 }
 
 void CommandBuffer::bindTexture( uint32_t groupIndex, uint32_t binding, const TextureView& texture )
 {
-    auto bindGroup = getBindGroup( groupIndex );
-    bindGroup->bind( binding, texture );
+    auto& bindGroup = getBindGroup( groupIndex );
+    bindGroup.bind( binding, texture );
 }
 
 void CommandBuffer::bindDynamicUniformBuffer( uint32_t groupIndex, uint32_t binding, const void* data,
@@ -75,12 +114,10 @@ void CommandBuffer::bindDynamicUniformBuffer( uint32_t groupIndex, uint32_t bind
 {
     auto allocation = uniformUploadBuffer->allocate( sizeInBytes, 256 );
 
-    auto queue = Device::get().getQueue();
-
-    queue->writeBuffer( allocation.buffer, data, sizeInBytes, allocation.offset );
+    std::memcpy( allocation.data, data, sizeInBytes );
 
-    auto bindGroup = getBindGroup( groupIndex );
-    bindGroup->bind( binding, allocation.buffer, allocation.offset, sizeInBytes );
+    auto& bindGroup = getBindGroup( groupIndex );
+    bindGroup.bindDynamic( binding, allocation.buffer, static_cast<uint32_t>( allocation.offset ), sizeInBytes );
 }
 
 void CommandBuffer::bindDynamicStorageBuffer( uint32_t groupIndex, uint32_t binding, const void* data,
@@ -89,12 +126,10 @@ void CommandBuffer::bindDynamicStorageBuffer( uint32_t groupIndex, uint32_t bind
     auto sizeInBytes = elementCount * elementSize;
     auto allocation  = storageUploadBuffer->allocate( sizeInBytes, 256 );
 
-    auto queue = Device::get().getQueue();
-
-    queue->writeBuffer( allocation.buffer, data, sizeInBytes, allocation.offset );
+    std::memcpy( allocation.data, data, sizeInBytes );
 
-    auto bindGroup = getBindGroup( groupIndex );
-    bindGroup->bind( binding, allocation.buffer, allocation.offset, sizeInBytes );
+    auto& bindGroup = getBindGroup( groupIndex );
+    bindGroup.bindDynamic( binding, allocation.buffer, static_cast<uint32_t>( allocation.offset ), sizeInBytes );
 }
 
 CommandBuffer::CommandBuffer(
@@ -111,8 +146,25 @@ CommandBuffer::~CommandBuffer()
         wgpuCommandEncoderRelease( commandEncoder );
 }
 
+void CommandBuffer::flush()
+{
+    auto queue = Device::get().getQueue();
+
+    uniformUploadBuffer->flush( *queue );
+    storageUploadBuffer->flush( *queue );
+}
+
 void CommandBuffer::reset()
 {
-    uniformUploadBuffer->reset();
-    storageUploadBuffer->reset();
+    auto& device = Device::get();
+    device.getUploadPagePool().retirePages( *device.getQueue(), releaseUploadPages() );
+}
+
+UploadPagePool::PageList CommandBuffer::releaseUploadPages()
+{
+    auto pages        = uniformUploadBuffer->releasePages();
+    auto storagePages = storageUploadBuffer->releasePages();
+    pages.insert( pages.end(), storagePages.begin(), storagePages.end() );
+
+    return pages;
 }
@@ -9,15 +9,27 @@ using namespace WebGPUlib;
 
 void ComputeCommandBuffer::setComputePipeline( ComputePipelineState& pipeline )
 {
+    if ( currentPipelineState == &pipeline && currentPipeline == pipeline.getWGPUComputePipeline() )
+    {
+        ++statistics.pipelinesSkipped;
+        return;
+    }
+
     // Keep track of the currently bound pipeline
     currentPipelineState = &pipeline;
+    currentPipeline      = pipeline.getWGPUComputePipeline();
 
     pipeline.bind( *this );
+    ++statistics.pipelinesSet;
+
+    // The bind groups are resolved with the bind group layouts of the pipeline.
+    invalidateBindGroups();
 }
 
 void ComputeCommandBuffer::dispatch( uint32_t x, uint32_t y, uint32_t z )
 {
     commitBindGroups();
+    ++statistics.drawCount;
 
     wgpuComputePassEncoderDispatchWorkgroups( passEncoder, x, y, z );
 }
@@ -39,7 +51,11 @@ void ComputeCommandBuffer::setBindGroup( uint32_t groupIndex, const BindGroup& _
     {
         auto bindGroupLayout = currentPipelineState->getWGPUBindGroupLayout( groupIndex );
         auto bindGroup       = _bindGroup.getWGPUBindGroup( bindGroupLayout );
-        wgpuComputePassEncoderSetBindGroup( passEncoder, groupIndex, bindGroup, 0, nullptr );
+        auto& dynamicOffsets = _bindGroup.getDynamicOffsets();
+
+        if ( updateBindGroupState( groupIndex, bindGroup, dynamicOffsets ) )
+            wgpuComputePassEncoderSetBindGroup( passEncoder, groupIndex, bindGroup, dynamicOffsets.size(),
+                                                dynamicOffsets.data() );
     }
     else
     {
@@ -54,11 +70,11 @@ WGPUCommandBuffer ComputeCommandBuffer::finish()
     wgpuComputePassEncoderEnd( passEncoder );
 
     currentPipelineState = nullptr;
+    currentPipeline      = nullptr;
+    resetBindGroupState();
  
     WGPUCommandBufferDescriptor commandBufferDesc {};
     commandBufferDesc.label = "Compute Command Buffer";
 
-    reset();
-
     return wgpuCommandEncoderFinish( commandEncoder, &commandBufferDesc );
 }
@@ -0,0 +1,110 @@
+#include <WebGPUlib/ComputeCommandBuffer.hpp>
+#include <WebGPUlib/CullInstancesPipelineState.hpp>
+#include <WebGPUlib/Device.hpp>
+
+#include <iterator>
+
+using namespace WebGPUlib;
+
+CullInstancesPipelineState::CullInstancesPipelineState()
+{
+    // Load the shader module.
+    const char* shaderCode = {
+#include "../shaders/CullInstances.wgsl"
+    };
+
+    auto device = Device::get().getWGPUDevice();
+
+    // Load the compute shader module.
+    WGPUShaderModuleWGSLDescriptor shaderCodeDesc {};
+    shaderCodeDesc.chain.next  = nullptr;
+    shaderCodeDesc.chain.sType = WGPUSType_ShaderModuleWGSLDescriptor;
+    shaderCodeDesc.code        = shaderCode;
+
+    WGPUShaderModuleDescriptor shaderModuleDesc {};
+    shaderModuleDesc.nextInChain  = &shaderCodeDesc.chain;
+    shaderModuleDesc.label        = "Cull Instances Shader Module";
+    WGPUShaderModule shaderModule = wgpuDeviceCreateShaderModule( device, &shaderModuleDesc );
+
+    // Setup the binding layout for the culling compute shader.
+    //@group(0) @binding(0) var<uniform> params : Parameters;
+    //@group(0) @binding(1) var<storage, read> instances : array<Instance>;
+    //@group(0) @binding(2) var<storage, read> draws : array<Draw>;
+    //@group(0) @binding(3) var<storage, read_write> drawArguments : array<DrawIndexedIndirect>;
+    //@group(0) @binding(4) var<storage, read_write> visibleInstances : array<Matrices>;
+    //@group(0) @binding(5) var<storage, read_write> visibility : array<u32>;
+    //@group(0) @binding(6) var hiZ : texture_2d<f32>;
+    WGPUBindGroupLayoutEntry bindGroupLayoutEntries[7] {};
+    bindGroupLayoutEntries[0].binding               = 0;
+    bindGroupLayoutEntries[0].visibility            = WGPUShaderStage_Compute;
+    bindGroupLayoutEntries[0].buffer.type           = WGPUBufferBindingType_Uniform;
+    bindGroupLayoutEntries[0].buffer.minBindingSize = sizeof( CullParameters );
+
+    bindGroupLayoutEntries[1].binding               = 1;
+    bindGroupLayoutEntries[1].visibility            = WGPUShaderStage_Compute;
+    bindGroupLayoutEntries[1].buffer.type           = WGPUBufferBindingType_ReadOnlyStorage;
+    bindGroupLayoutEntries[1].buffer.minBindingSize = sizeof( CullInstance );
+
+    bindGroupLayoutEntries[2].binding               = 2;
+    bindGroupLayoutEntries[2].visibility            = WGPUShaderStage_Compute;
+    bindGroupLayoutEntries[2].buffer.type           = WGPUBufferBindingType_ReadOnlyStorage;
+    bindGroupLayoutEntries[2].buffer.minBindingSize = sizeof( uint32_t );
+
+    bindGroupLayoutEntries[3].binding               = 3;
+    bindGroupLayoutEntries[3].visibility            = WGPUShaderStage_Compute;
+    bindGroupLayoutEntries[3].buffer.type           = WGPUBufferBindingType_Storage;
+    bindGroupLayoutEntries[3].buffer.minBindingSize = sizeof( DrawIndexedIndirectArguments );
+
+    bindGroupLayoutEntries[4].binding               = 4;
+    bindGroupLayoutEntries[4].visibility            = WGPUShaderStage_Compute;
+    bindGroupLayoutEntries[4].buffer.type           = WGPUBufferBindingType_Storage;
+    bindGroupLayoutEntries[4].buffer.minBindingSize = 2 * sizeof( glm::mat4 );
+
+    bindGroupLayoutEntries[5].binding               = 5;
+    bindGroupLayoutEntries[5].visibility            = WGPUShaderStage_Compute;
+    bindGroupLayoutEntries[5].buffer.type           = WGPUBufferBindingType_Storage;
+    bindGroupLayoutEntries[5].buffer.minBindingSize = sizeof( uint32_t );
+
+    bindGroupLayoutEntries[6].binding               = 6;
+    bindGroupLayoutEntries[6].visibility            = WGPUShaderStage_Compute;
+    bindGroupLayoutEntries[6].texture.sampleType    = WGPUTextureSampleType_UnfilterableFloat;
+    bindGroupLayoutEntries[6].texture.viewDimension = WGPUTextureViewDimension_2D;
+
+    WGPUBindGroupLayoutDescriptor bindGroupLayoutDesc {};
+    bindGroupLayoutDesc.label      = "Cull Instances Bind Group Layout";
+    bindGroupLayoutDesc.entryCount = std::size( bindGroupLayoutEntries );
+    bindGroupLayoutDesc.entries    = bindGroupLayoutEntries;
+    bindGroupLayout                = wgpuDeviceCreateBindGroupLayout( device, &bindGroupLayoutDesc );
+
+    // Setup the pipeline layout.
+    WGPUPipelineLayoutDescriptor pipelineLayoutDesc {};
+    pipelineLayoutDesc.label                = "Cull Instances Pipeline Layout";
+    pipelineLayoutDesc.bindGroupLayoutCount = 1;
+    pipelineLayoutDesc.bindGroupLayouts     = &bindGroupLayout;
+    WGPUPipelineLayout pipelineLayout       = wgpuDeviceCreatePipelineLayout( device, &pipelineLayoutDesc );
+
+    // Setup the pipeline state.
+    WGPUComputePipelineDescriptor pipelineDesc {};
+    pipelineDesc.label              = "Cull Instances Pipeline";
+    pipelineDesc.layout             = pipelineLayout;
+    pipelineDesc.compute.module     = shaderModule;
+    pipelineDesc.compute.entryPoint = "main";
+    pipeline                        = wgpuDeviceCreateComputePipeline( device, &pipelineDesc );
+
+    // We are done with the shader module.
+    wgpuShaderModuleRelease( shaderModule );
+    // We are done with the pipeline layout.
+    wgpuPipelineLayoutRelease( pipelineLayout );
+}
+
+CullInstancesPipelineState::~CullInstancesPipelineState()
+{
+    if ( bindGroupLayout )
+        wgpuBindGroupLayoutRelease( bindGroupLayout );
+}
+
+void CullInstancesPipelineState::bind( ComputeCommandBuffer& commandBuffer )
+{
+    auto passEncoder = commandBuffer.getWGPUPassEncoder();
+    wgpuComputePassEncoderSetPipeline( passEncoder, pipeline );
+}
@@ -1,18 +1,29 @@
 #include <WebGPUlib/BindGroup.hpp>
+#include <WebGPUlib/BindGroupCache.hpp>
+#include <WebGPUlib/BufferArena.hpp>
 #include <WebGPUlib/ComputeCommandBuffer.hpp>
 #include <WebGPUlib/Device.hpp>
 #include <WebGPUlib/GenerateMipsPipelineState.hpp>
+#include <WebGPUlib/GenerateMipsSinglePassPipelineState.hpp>
+#include <WebGPUlib/GPUProfiler.hpp>
+#include <WebGPUlib/Helpers.hpp>
 #include <WebGPUlib/IndexBuffer.hpp>
 #include <WebGPUlib/Material.hpp>
 #include <WebGPUlib/Mesh.hpp>
+#include <WebGPUlib/MeshOptimizer.hpp>
 #include <WebGPUlib/Queue.hpp>
+#include <WebGPUlib/RenderTarget.hpp>
 #include <WebGPUlib/Sampler.hpp>
 #include <WebGPUlib/Scene.hpp>
 #include <WebGPUlib/SceneNode.hpp>
 #include <WebGPUlib/StorageBuffer.hpp>
 #include <WebGPUlib/Surface.hpp>
 #include <WebGPUlib/Texture.hpp>
+#include <WebGPUlib/TextureCache.hpp>
+#include <WebGPUlib/TextureCompression.hpp>
+#include <WebGPUlib/ThreadPool.hpp>
 #include <WebGPUlib/UniformBuffer.hpp>
+#include <WebGPUlib/UploadPagePool.hpp>
 #include <WebGPUlib/Vertex.hpp>
 #include <WebGPUlib/VertexBuffer.hpp>
 
@@ -35,9 +46,15 @@
 #include <sdl2webgpu.h>
 #include <stb_image.h>
 
+#include <algorithm>
 #include <cassert>
+#include <chrono>
+#include <cmath>
+#include <cstring>
 #include <filesystem>
+#include <fstream>
 #include <iostream>
+#include <numeric>
 
 constexpr float _PI     = 3.141592654f;
 constexpr float _2PI    = 6.283185307f;
@@ -73,6 +90,97 @@ constexpr T DivideByMultiple( T value, size_t alignment )
     return static_cast<T>( ( value + alignment - 1 ) / alignment );
 }
 
+// Frees the pixels that were allocated by stb_image.
+struct ImageDeleter
+{
+    void operator()( unsigned char* pixels ) const
+    {
+        stbi_image_free( pixels );
+    }
+};
+
+// An image file that was decoded on the CPU.
+// The image is either block compressed (with its mips), or RGBA8 pixels.
+struct DecodedImage
+{
+    std::string                                   filePath;
+    int                                           width  = 0;
+    int                                           height = 0;
+    std::unique_ptr<unsigned char[], ImageDeleter> pixels;
+    CompressedImage                               compressed;
+    bool                                          isCached = false;  // The compressed image was loaded from the cache.
+    const char*                                   error    = nullptr;
+};
+
+// Decode an image file. If compress is true, the image is block compressed.
+// Compressed images are cached in a file next to the image file, keyed by the contents of the image file.
+// This does not use the device, so it is safe to call from a worker thread.
+DecodedImage decodeImage( const fs::path& _filePath, const TextureLoadOptions& options, bool compress )
+{
+    DecodedImage image;
+
+    image.filePath = _filePath.string();
+    // Replace double backslashes in the file path.
+    // This is required on POSIX systems (like Emscripten).
+    std::replace( image.filePath.begin(), image.filePath.end(), '\\', '/' );
+
+    if ( !fs::exists( image.filePath ) || !fs::is_regular_file( image.filePath ) )
+    {
+        image.error = "File not found or is not a regular file";
+        return image;
+    }
+
+    int channels;
+
+    if ( !compress )
+    {
+        image.pixels.reset(
+            stbi_load( image.filePath.c_str(), &image.width, &image.height, &channels, STBI_rgb_alpha ) );
+
+        if ( !image.pixels )
+            image.error = "Failed to load texture";
+
+        return image;
+    }
+
+    // The file contents are needed to compute the hash, so the image is decoded from memory.
+    std::ifstream        file( image.filePath, std::ios::binary );
+    std::vector<uint8_t> fileContents { std::istreambuf_iterator<char>( file ), std::istreambuf_iterator<char>() };
+
+    const uint64_t contentHash   = hashFileContents( fileContents.data(), fileContents.size() );
+    const auto     cacheFilePath = image.filePath + ( options.normalMap ? ".bc5tex" : ".bctex" );
+
+    if ( loadCompressedImage( cacheFilePath, contentHash, options.generateMips, image.compressed ) )
+    {
+        image.width    = static_cast<int>( image.compressed.width );
+        image.height   = static_cast<int>( image.compressed.height );
+        image.isCached = true;
+        return image;
+    }
+
+    image.pixels.reset( stbi_load_from_memory( fileContents.data(), static_cast<int>( fileContents.size() ),
+                                               &image.width, &image.height, &channels, STBI_rgb_alpha ) );
+
+    if ( !image.pixels )
+    {
+        image.error = "Failed to load texture";
+        return image;
+    }
+
+    // Images that can't be compressed are uploaded as RGBA8.
+    if ( !canCompressImage( image.width, image.height ) )
+        return image;
+
+    image.compressed = compressImage( image.pixels.get(), image.width, image.height, options.normalMap,
+                                      options.generateMips );
+    image.pixels.reset();
+
+    if ( !saveCompressedImage( cacheFilePath, contentHash, image.compressed ) )
+        std::cerr << "WARNING: Failed to write compressed texture cache: " << cacheFilePath << std::endl;
+
+    return image;
+}
+
 std::unique_ptr<Device> pDevice { nullptr };
 
 struct MakeQueue : Queue
@@ -91,15 +199,19 @@ struct MakeSurface : Surface
 
 struct MakeVertexBuffer : VertexBuffer
 {
-    MakeVertexBuffer( WGPUBuffer&& buffer, std::size_t vertexCount, std::size_t vertexStride )
-    : VertexBuffer( std::move( buffer ), vertexCount, vertexStride )  // NOLINT(performance-move-const-arg)
+    MakeVertexBuffer( WGPUBuffer&& buffer, std::size_t vertexCount, std::size_t vertexStride,
+                      std::shared_ptr<BufferArena> arena, uint64_t offset )
+    : VertexBuffer( std::move( buffer ),  // NOLINT(performance-move-const-arg)
+                    vertexCount, vertexStride, std::move( arena ), offset )
     {}
 };
 
 struct MakeIndexBuffer : IndexBuffer
 {
-    MakeIndexBuffer( WGPUBuffer&& buffer, std::size_t indexCount, std::size_t indexStride )
-    : IndexBuffer( std::move( buffer ), indexCount, indexStride )  // NOLINT(performance-move-const-arg)
+    MakeIndexBuffer( WGPUBuffer&& buffer, std::size_t indexCount, std::size_t indexStride,
+                     std::shared_ptr<BufferArena> arena, uint64_t offset )
+    : IndexBuffer( std::move( buffer ),  // NOLINT(performance-move-const-arg)
+                   indexCount, indexStride, std::move( arena ), offset )
     {}
 };
 
@@ -134,7 +246,14 @@ struct MakeTexture : Texture
 void Device::create( SDL_Window* window )
 {
     assert( !pDevice );
-    pDevice = std::unique_ptr<Device>( new Device( window ) );
+    assert( window );
+    pDevice = std::unique_ptr<Device>( new Device( window, 0, 0, false ) );
+}
+
+void Device::createHeadless( uint32_t width, uint32_t height, bool forceFallbackAdapter )
+{
+    assert( !pDevice );
+    pDevice = std::unique_ptr<Device>( new Device( nullptr, width, height, forceFallbackAdapter ) );
 }
 
 void Device::destroy()
@@ -148,7 +267,7 @@ Device& Device::get()
     return *pDevice;
 }
 
-Device::Device( SDL_Window* window )
+Device::Device( SDL_Window* window, uint32_t width, uint32_t height, bool forceFallbackAdapter )
 {
 #ifdef WEBGPU_BACKEND_EMSCRIPTEN
     // For some reason, the instance descriptor must be null when using emscripten.
@@ -189,8 +308,9 @@ Device::Device( SDL_Window* window )
     } adapterData;
 
     WGPURequestAdapterOptions requestAdapterOptions {};
-    requestAdapterOptions.backendType     = WGPUBackendType_Undefined;
-    requestAdapterOptions.powerPreference = WGPUPowerPreference_HighPerformance;
+    requestAdapterOptions.backendType          = WGPUBackendType_Undefined;
+    requestAdapterOptions.powerPreference      = WGPUPowerPreference_HighPerformance;
+    requestAdapterOptions.forceFallbackAdapter = forceFallbackAdapter;
 
     wgpuInstanceRequestAdapter(
         instance, &requestAdapterOptions,
@@ -220,12 +340,32 @@ Device::Device( SDL_Window* window )
     assert( adapterData.done );
     adapter = adapterData.adapter;
 
-    // Create a minimal device with no special features and default limits.
+    // Timestamp queries are used by the GPU profiler if the adapter supports them.
+    std::vector<WGPUFeatureName> requiredFeatures;
+    if ( wgpuAdapterHasFeature( adapter, WGPUFeatureName_TimestampQuery ) )
+        requiredFeatures.push_back( WGPUFeatureName_TimestampQuery );
+
+    // Block compressed textures are used if the adapter supports them.
+    if ( wgpuAdapterHasFeature( adapter, WGPUFeatureName_TextureCompressionBC ) )
+        requiredFeatures.push_back( WGPUFeatureName_TextureCompressionBC );
+
+    // The single pass mip generator writes to more storage textures than the default limit allows.
+    WGPUSupportedLimits supportedLimits {};
+    wgpuAdapterGetLimits( adapter, &supportedLimits );
+
+    // Setting all bits marks every limit as undefined (WGPU_LIMIT_U32_UNDEFINED and WGPU_LIMIT_U64_UNDEFINED),
+    // so the default is used for all limits that are not explicitly set.
+    WGPURequiredLimits requiredLimits {};
+    std::memset( &requiredLimits.limits, 0xFF, sizeof( requiredLimits.limits ) );
+    if ( supportedLimits.limits.maxStorageTexturesPerShaderStage >= GenerateMipsSinglePassPipelineState::MaxMips )
+        requiredLimits.limits.maxStorageTexturesPerShaderStage = GenerateMipsSinglePassPipelineState::MaxMips;
+
+    // Create a device with the optional features and limits.
     WGPUDeviceDescriptor deviceDescriptor {};
     deviceDescriptor.label                    = "WebGPUlib";  // You can use anything here.
-    deviceDescriptor.requiredFeatureCount     = 0;            // We don't require any extra features.
-    deviceDescriptor.requiredFeatures         = nullptr;
-    deviceDescriptor.requiredLimits           = nullptr;  // We don't require any specific limits.
+    deviceDescriptor.requiredFeatureCount     = requiredFeatures.size();
+    deviceDescriptor.requiredFeatures         = requiredFeatures.data();
+    deviceDescriptor.requiredLimits           = &requiredLimits;
     deviceDescriptor.defaultQueue.nextInChain = nullptr;
     deviceDescriptor.defaultQueue.label       = "Queue";  // You can use anything here.
     deviceDescriptor.deviceLostCallback       = onDeviceLostCallback;
@@ -273,42 +413,63 @@ Device::Device( SDL_Window* window )
     // Set the uncaptured error callback.
     wgpuDeviceSetUncapturedErrorCallback( device, onUncapturedErrorCallback, nullptr );
 
-    // Configure the surface.
-    WGPUSurface _surface = SDL_GetWGPUSurface( instance, window );
+    WGPUSupportedLimits deviceLimits {};
+    wgpuDeviceGetLimits( device, &deviceLimits );
+    singlePassMipsSupported =
+        deviceLimits.limits.maxStorageTexturesPerShaderStage >= GenerateMipsSinglePassPipelineState::MaxMips;
+    textureCompressionBCSupported = wgpuDeviceHasFeature( device, WGPUFeatureName_TextureCompressionBC ) != 0;
+
+    bindGroupCache = std::make_unique<BindGroupCache>();
+    uploadPagePool = std::make_unique<UploadPagePool>();
+    gpuProfiler    = std::make_unique<GPUProfiler>( device );
+    textureCache   = std::make_unique<TextureCache>();
+
+#ifdef __EMSCRIPTEN__
+    // Without pthreads support, tasks are executed on the main thread.
+    threadPool = std::make_unique<ThreadPool>( 0 );
+#else
+    threadPool = std::make_unique<ThreadPool>();
+#endif
 
-    if ( !_surface )
+    if ( window )
     {
-        std::cerr << "Failed to get the surface." << std::endl;
-        return;
-    }
+        // Configure the surface.
+        WGPUSurface _surface = SDL_GetWGPUSurface( instance, window );
+
+        if ( !_surface )
+        {
+            std::cerr << "Failed to get the surface." << std::endl;
+            return;
+        }
 
-    int windowWidth, windowHeight;
-    SDL_GetWindowSize( window, &windowWidth, &windowHeight );
-
-    WGPUSurfaceCapabilities surfaceCapabilities {};
-    wgpuSurfaceGetCapabilities( _surface, adapter, &surfaceCapabilities );
-    WGPUTextureFormat surfaceFormat = surfaceCapabilities.formats[0];
-
-    // Set the surface configuration.
-    WGPUSurfaceConfiguration surfaceConfiguration {};
-    surfaceConfiguration.device          = device;
-    surfaceConfiguration.format          = surfaceFormat;
-    surfaceConfiguration.usage           = WGPUTextureUsage_RenderAttachment;
-    surfaceConfiguration.viewFormatCount = 0;
-    surfaceConfiguration.viewFormats     = nullptr;
-    surfaceConfiguration.alphaMode       = WGPUCompositeAlphaMode_Auto;
-    surfaceConfiguration.width           = windowWidth;
-    surfaceConfiguration.height          = windowHeight;
+        int windowWidth, windowHeight;
+        SDL_GetWindowSize( window, &windowWidth, &windowHeight );
+
+        WGPUSurfaceCapabilities surfaceCapabilities {};
+        wgpuSurfaceGetCapabilities( _surface, adapter, &surfaceCapabilities );
+        WGPUTextureFormat surfaceFormat = surfaceCapabilities.formats[0];
+
+        // Set the surface configuration.
+        WGPUSurfaceConfiguration surfaceConfiguration {};
+        surfaceConfiguration.device          = device;
+        surfaceConfiguration.format          = surfaceFormat;
+        surfaceConfiguration.usage           = WGPUTextureUsage_RenderAttachment;
+        surfaceConfiguration.viewFormatCount = 0;
+        surfaceConfiguration.viewFormats     = nullptr;
+        surfaceConfiguration.alphaMode       = WGPUCompositeAlphaMode_Auto;
+        surfaceConfiguration.width           = windowWidth;
+        surfaceConfiguration.height          = windowHeight;
 #ifdef __EMSCRIPTEN__
-    surfaceConfiguration.presentMode = WGPUPresentMode_Fifo;  // This must be Fifo on Emscripten.
+        surfaceConfiguration.presentMode = WGPUPresentMode_Fifo;  // This must be Fifo on Emscripten.
 #else
-    surfaceConfiguration.presentMode = WGPUPresentMode_Mailbox;
+        surfaceConfiguration.presentMode = WGPUPresentMode_Mailbox;
 #endif
 
-    wgpuSurfaceConfigure( _surface, &surfaceConfiguration );
+        wgpuSurfaceConfigure( _surface, &surfaceConfiguration );
 
-    surface = std::make_shared<MakeSurface>( std::move( _surface ),  // NOLINT(performance-move-const-arg)
-                                             surfaceConfiguration, window );
+        surface = std::make_shared<MakeSurface>( std::move( _surface ),  // NOLINT(performance-move-const-arg)
+                                                 surfaceConfiguration, window );
+    }
 
     // Get the device queue.
     WGPUQueue _queue = wgpuDeviceGetQueue( device );
@@ -340,12 +501,46 @@ Device::Device( SDL_Window* window )
 
     uint32_t magenta = 0xffff00ff;
     queue->writeTexture( *magentaTexture, 0, &magenta, sizeof( magenta ) );
+
+    // Without a window, render to an offscreen render target instead.
+    if ( !window )
+    {
+        createOffscreenRenderTarget( width, height );
+    }
 }
 
 Device::~Device()
 {
+    offscreenRenderTarget.reset();
+    offscreenColorTexture.reset();
+    offscreenDepthTexture.reset();
     surface.reset();
+
+    // Wait for the GPU to release the upload pages before destroying the pool.
+    while ( queue && uploadPagePool && uploadPagePool->hasPendingPages() )
+        poll( true );
+
+    // Wait for the profiler readbacks to complete before destroying the readback buffers.
+    while ( queue && gpuProfiler && gpuProfiler->hasPendingReadbacks() )
+        poll( true );
+
     queue.reset();
+    generateMipsPipelineState.reset();
+    generateMipsDummyTexture.reset();
+    generateMipsSampler.reset();
+    generateMipsUniformBuffer.reset();
+    generateMipsSinglePassPipelineState.reset();
+    generateMipsSinglePassDummyTexture.reset();
+    generateMipsSinglePassCounterBuffer.reset();
+    generateMipsSinglePassMip6Buffer.reset();
+    generateMipsSinglePassUniformBuffer.reset();
+    bindGroupCache.reset();
+    uploadPagePool.reset();
+    gpuProfiler.reset();
+    threadPool.reset();
+    textureCache.reset();
+    vertexArenas.clear();
+    indexArenas.clear();
 
     if ( device )
         wgpuDeviceRelease( device );
@@ -367,6 +562,74 @@ std::shared_ptr<Surface> Device::getSurface() const
     return surface;
 }
 
+std::shared_ptr<RenderTarget> Device::getOffscreenRenderTarget() const
+{
+    return offscreenRenderTarget;
+}
+
+std::shared_ptr<Texture> Device::getOffscreenColorTexture() const
+{
+    return offscreenColorTexture;
+}
+
+WGPUTextureFormat Device::getColorFormat() const
+{
+    if ( surface )
+        return surface->getSurfaceFormat();
+
+    if ( offscreenColorTexture )
+        return offscreenColorTexture->getWGPUTextureDescriptor().format;
+
+    return WGPUTextureFormat_Undefined;
+}
+
+void Device::createOffscreenRenderTarget( uint32_t width, uint32_t height )
+{
+    // The color texture can be resolved into and copied back to the CPU.
+    WGPUTextureFormat colorFormat = WGPUTextureFormat_RGBA8Unorm;
+
+    WGPUTextureDescriptor colorTextureDesc {};
+    colorTextureDesc.label           = "Offscreen Color Texture";
+    colorTextureDesc.usage           = WGPUTextureUsage_RenderAttachment | WGPUTextureUsage_CopySrc;
+    colorTextureDesc.dimension       = WGPUTextureDimension_2D;
+    colorTextureDesc.size            = { width, height, 1 };
+    colorTextureDesc.format          = colorFormat;
+    colorTextureDesc.mipLevelCount   = 1;
+    colorTextureDesc.sampleCount     = 1;
+    colorTextureDesc.viewFormatCount = 1;
+    colorTextureDesc.viewFormats     = &colorFormat;
+    offscreenColorTexture            = createTexture( colorTextureDesc );
+
+    WGPUTextureFormat depthFormat = WGPUTextureFormat_Depth32Float;
+
+    WGPUTextureDescriptor depthTextureDesc {};
+    depthTextureDesc.label           = "Offscreen Depth Texture";
+    depthTextureDesc.usage           = WGPUTextureUsage_RenderAttachment;
+    depthTextureDesc.dimension       = WGPUTextureDimension_2D;
+    depthTextureDesc.size            = { width, height, 1 };
+    depthTextureDesc.format          = depthFormat;
+    depthTextureDesc.mipLevelCount   = 1;
+    depthTextureDesc.sampleCount     = 1;
+    depthTextureDesc.viewFormatCount = 1;
+    depthTextureDesc.viewFormats     = &depthFormat;
+    offscreenDepthTexture            = createTexture( depthTextureDesc );
+
+    WGPUTextureViewDescriptor depthViewDesc {};
+    depthViewDesc.label           = "Offscreen Depth Texture View";
+    depthViewDesc.format          = depthFormat;
+    depthViewDesc.dimension       = WGPUTextureViewDimension_2D;
+    depthViewDesc.baseMipLevel    = 0;
+    depthViewDesc.mipLevelCount   = 1;
+    depthViewDesc.baseArrayLayer  = 0;
+    depthViewDesc.arrayLayerCount = 1;
+    depthViewDesc.aspect          = WGPUTextureAspect_DepthOnly;
+
+    offscreenRenderTarget = std::make_shared<RenderTarget>();
+    offscreenRenderTarget->attachTexture( AttachmentPoint::Color0, offscreenColorTexture->getView() );
+    offscreenRenderTarget->attachTexture( AttachmentPoint::DepthStencil,
+                                          offscreenDepthTexture->getView( &depthViewDesc ) );
+}
+
 static void reverseWinding( std::vector<VertexPositionNormalTangentBitangentTexture>& vertices,
                             std::vector<uint16_t>&                                    indices )
 {
@@ -382,7 +645,66 @@ static void reverseWinding( std::vector<VertexPositionNormalTangentBitangentText
     }
 }
 
-std::shared_ptr<Mesh> Device::createCube( float size, bool _reverseWinding ) const
+// Compute per-vertex tangents and bitangents from the texture coordinates of the triangles.
+static void computeTangents( std::vector<VertexPositionNormalTangentBitangentTexture>& vertices,
+                             const std::vector<uint16_t>&                              indices )
+{
+    assert( ( indices.size() % 3 ) == 0 );
+
+    for ( auto& vertex: vertices )
+    {
+        vertex.tangent   = glm::vec3 { 0 };
+        vertex.bitangent = glm::vec3 { 0 };
+    }
+
+    for ( std::size_t i = 0; i < indices.size(); i += 3 )
+    {
+        auto& v0 = vertices[indices[i + 0]];
+        auto& v1 = vertices[indices[i + 1]];
+        auto& v2 = vertices[indices[i + 2]];
+
+        const glm::vec3 e1 = v1.position - v0.position;
+        const glm::vec3 e2 = v2.position - v0.position;
+
+        const float du1 = v1.texCoord.x - v0.texCoord.x;
+        const float dv1 = v1.texCoord.y - v0.texCoord.y;
+        const float du2 = v2.texCoord.x - v0.texCoord.x;
+        const float dv2 = v2.texCoord.y - v0.texCoord.y;
+
+        const float det = du1 * dv2 - du2 * dv1;
+        if ( std::abs( det ) < 1e-12f )
+            continue;  // Degenerate texture coordinates.
+
+        const float     r = 1.0f / det;
+        const glm::vec3 t = ( e1 * dv2 - e2 * dv1 ) * r;
+        const glm::vec3 b = ( e2 * du1 - e1 * du2 ) * r;
+
+        for ( auto* v: { &v0, &v1, &v2 } )
+        {
+            v->tangent += t;
+            v->bitangent += b;
+        }
+    }
+}
+
+std::shared_ptr<VertexBuffer>
+    Device::createMeshVertexBuffer( const std::vector<VertexPositionNormalTangentBitangentTexture>& vertices,
+                                    VertexLayout                                                    vertexLayout ) const
+{
+    switch ( vertexLayout )
+    {
+    case VertexLayout::PositionPackedNormalTangentTexture:
+    {
+        std::vector<VertexPositionPackedNormalTangentTexture> packedVertices { vertices.begin(), vertices.end() };
+        return createVertexBuffer( packedVertices );
+    }
+    case VertexLayout::PositionNormalTangentBitangentTexture:
+    default:
+        return createVertexBuffer( vertices );
+    }
+}
+
+std::shared_ptr<Mesh> Device::createCube( float size, bool _reverseWinding, VertexLayout vertexLayout ) const
 {
     float s = size * 0.5f;
 
@@ -431,13 +753,19 @@ std::shared_ptr<Mesh> Device::createCube( float size, bool _reverseWinding ) con
     if ( _reverseWinding )
         reverseWinding( vertices, indices );
 
-    auto vertexBuffer = createVertexBuffer( vertices );
+    computeTangents( vertices, indices );
+
+    auto vertexBuffer = createMeshVertexBuffer( vertices, vertexLayout );
     auto indexBuffer  = createIndexBuffer( indices );
 
-    return std::make_shared<Mesh>( vertexBuffer, indexBuffer );
+    auto mesh = std::make_shared<Mesh>( vertexBuffer, indexBuffer );
+    mesh->setBoundingBox( { glm::vec3 { -s }, glm::vec3 { s } } );
+
+    return mesh;
 }
 
-std::shared_ptr<Mesh> Device::createSphere( float radius, uint32_t tessellation, bool _reverseWinding )
+std::shared_ptr<Mesh> Device::createSphere( float radius, uint32_t tessellation, bool _reverseWinding,
+                                            VertexLayout vertexLayout )
 {
     if ( tessellation < 3 )
         throw std::out_of_range( "tessellation parameter out of range" );
@@ -500,10 +828,15 @@ std::shared_ptr<Mesh> Device::createSphere( float radius, uint32_t tessellation,
     if ( _reverseWinding )
         reverseWinding( vertices, indices );
 
-    auto vertexBuffer = createVertexBuffer( vertices );
+    computeTangents( vertices, indices );
+
+    auto vertexBuffer = createMeshVertexBuffer( vertices, vertexLayout );
     auto indexBuffer  = createIndexBuffer( indices );
 
-    return std::make_shared<Mesh>( vertexBuffer, indexBuffer );
+    auto mesh = std::make_shared<Mesh>( vertexBuffer, indexBuffer );
+    mesh->setBoundingBox( { glm::vec3 { -radius }, glm::vec3 { radius } } );
+
+    return mesh;
 }
 
 std::shared_ptr<Texture> Device::createTexture( const WGPUTextureDescriptor& textureDescriptor )
@@ -514,32 +847,76 @@ std::shared_ptr<Texture> Device::createTexture( const WGPUTextureDescriptor& tex
                                           textureDescriptor );
 }
 
-std::shared_ptr<Texture> Device::loadTexture( const std::filesystem::path& _filePath )
+std::shared_ptr<Texture> Device::loadTexture( const std::filesystem::path& filePath )
 {
-    auto filePath = _filePath.string();
-    // Replace double backslashes in the file path.
-    // This is required on POSIX systems (like Emscripten).
-    std::replace( filePath.begin(), filePath.end(), '\\', '/' );
+    return loadTexture( filePath, TextureLoadOptions {} );
+}
+
+std::shared_ptr<Texture> Device::loadTexture( const std::filesystem::path& filePath, const TextureLoadOptions& options )
+{
+    auto key = TextureCache::getKey( filePath, options );
+
+    if ( auto texture = textureCache->find( key ) )
+        return texture;
 
-    if ( !std::filesystem::exists( filePath ) || !std::filesystem::is_regular_file( filePath ) )
+    DecodedImage image = decodeImage( filePath, options, options.compress && textureCompressionBCSupported );
+
+    if ( image.error )
     {
-        std::cerr << "ERROR: File not found or is not a regular file: " << filePath << std::endl;
+        std::cerr << "ERROR: " << image.error << ": " << image.filePath << std::endl;
         return nullptr;
     }
 
-    // Load the texture
-    int            width, height, channels;
-    unsigned char* data = stbi_load( filePath.c_str(), &width, &height, &channels, STBI_rgb_alpha );
+    std::shared_ptr<Texture> tex;
+    if ( image.compressed.isValid() )
+    {
+        tex = createCompressedTexture( image.compressed, filePath.filename().string() );
+    }
+    else
+    {
+        tex = createTextureFromPixels( image.pixels.get(), image.width, image.height, filePath.filename().string(),
+                                       options );
+
+        if ( options.generateMips )
+            generateMips( *tex );
+    }
+
+    textureCache->insert( key, tex );
+
+    std::cout << "INFO: Loaded texture: " << image.filePath << std::endl;
+
+    return tex;
+}
 
-    if ( !data )
+std::shared_ptr<Texture> Device::createCompressedTexture( const CompressedImage& image, const std::string& label )
+{
+    WGPUTextureDescriptor textureDesc {};
+    textureDesc.label         = label.c_str();
+    textureDesc.dimension     = WGPUTextureDimension_2D;
+    textureDesc.format        = image.format;
+    textureDesc.size          = { image.width, image.height, 1u };
+    textureDesc.sampleCount   = 1;
+    textureDesc.mipLevelCount = static_cast<uint32_t>( image.mips.size() );
+    // Block compressed textures can't be used as storage textures, so the mips are generated on the CPU.
+    textureDesc.usage = WGPUTextureUsage_TextureBinding | WGPUTextureUsage_CopyDst;
+
+    WGPUTexture texture = wgpuDeviceCreateTexture( device, &textureDesc );
+
+    auto tex =
+        std::make_shared<MakeTexture>( std::move( texture ), textureDesc );  // NOLINT(performance-move-const-arg)
+
+    for ( uint32_t mip = 0; mip < textureDesc.mipLevelCount; ++mip )
     {
-        std::cerr << "ERROR: Failed to load texture: " << filePath << std::endl;
-        return nullptr;
+        queue->writeTexture( *tex, mip, image.mips[mip].data(), image.mips[mip].size() );
     }
 
-    const WGPUExtent3D textureSize { static_cast<uint32_t>( width ), static_cast<uint32_t>( height ), 1u };
+    return tex;
+}
 
-    std::string label = _filePath.filename().string();
+std::shared_ptr<Texture> Device::createTextureFromPixels( const unsigned char* pixels, int width, int height,
+                                                          const std::string& label, const TextureLoadOptions& options )
+{
+    const WGPUExtent3D textureSize { static_cast<uint32_t>( width ), static_cast<uint32_t>( height ), 1u };
 
     // Create the texture object.
     WGPUTextureDescriptor textureDesc {};
@@ -549,9 +926,11 @@ std::shared_ptr<Texture> Device::loadTexture( const std::filesystem::path& _file
     textureDesc.size        = textureSize;
     textureDesc.sampleCount = 1;
     textureDesc.mipLevelCount =
-        static_cast<uint32_t>(
-            std::floor( std::log2( std::max( static_cast<float>( width ), static_cast<float>( height ) ) ) ) ) +
-        1u;
+        options.generateMips
+            ? static_cast<uint32_t>(
+                  std::floor( std::log2( std::max( static_cast<float>( width ), static_cast<float>( height ) ) ) ) ) +
+                  1u
+            : 1u;
     textureDesc.usage = WGPUTextureUsage_TextureBinding | WGPUTextureUsage_StorageBinding | WGPUTextureUsage_CopyDst;
 
     WGPUTexture texture = wgpuDeviceCreateTexture( device, &textureDesc );
@@ -560,111 +939,156 @@ std::shared_ptr<Texture> Device::loadTexture( const std::filesystem::path& _file
         std::make_shared<MakeTexture>( std::move( texture ), textureDesc );  // NOLINT(performance-move-const-arg)
 
     // Copy mip level 0.
-    queue->writeTexture( *tex, 0, data, ( static_cast<std::size_t>( width ) * height * 4u ) );
-
-    stbi_image_free( data );
-
-    generateMips( *tex );
-
-    std::cout << "INFO: Loaded texture: " << filePath << std::endl;
+    queue->writeTexture( *tex, 0, pixels, ( static_cast<std::size_t>( width ) * height * 4u ) );
 
     return tex;
 }
 
 void Device::generateMips( Texture& texture )
 {
+    generateMips( std::vector<Texture*> { &texture } );
+}
+
+void Device::generateMips( const std::vector<Texture*>& textures )
+{
+    // Each pass generates up to 4 mips of a texture and uses its own slice of the uniform buffer.
+    // The minimum uniform buffer offset alignment is 256 bytes.
+    constexpr uint32_t MipBufferStride = 256;
+
+    // Compute the mip info for all the passes of all the textures up front,
+    // so that it can be uploaded with a single write.
+    struct MipPass
+    {
+        Texture* texture;
+        Mip      mip;
+        uint32_t dstWidth;
+        uint32_t dstHeight;
+    };
+    std::vector<MipPass> passes;
+
+    for ( auto* texture: textures )
+    {
+        if ( !texture )
+            continue;
+
+        auto desc = texture->getWGPUTextureDescriptor();
+
+        for ( uint32_t srcMip = 0; srcMip + 1 < desc.mipLevelCount; )
+        {
+            uint32_t srcWidth  = desc.size.width >> srcMip;
+            uint32_t srcHeight = desc.size.height >> srcMip;
+            uint32_t dstWidth  = srcWidth >> 1u;
+            uint32_t dstHeight = srcHeight >> 1u;
+
+            Mip mip {};
+            // 0b00(0): Both width and height are even.
+            // 0b01(1): Width is odd, height is even.
+            // 0b10(2): Width is even, height is odd.
+            // 0b11(3): Both width and height are odd.
+            mip.dimensions = ( srcHeight & 1 ) << 1 | ( srcWidth & 1 );
+
+            // The number of times we can half the size of the texture and get
+            // exactly a 50% reduction in size.
+            // A 1 bit in the width or height indicates an odd dimension.
+            // The case where either the width or the height is exactly 1 is handled
+            // as a special case (as the dimension does not require reduction).
+            int mipCount =
+                bitScanForward( ( dstWidth == 1 ? dstHeight : dstWidth ) | ( dstHeight == 1 ? dstWidth : dstHeight ) );
+
+            // Maximum number of mips to generate is 4.
+            mipCount = std::min( mipCount + 1, 4 );
+
+            // Clamp to total number of mips left over.
+            mipCount = ( srcMip + mipCount ) >= desc.mipLevelCount ?
+                           static_cast<int>( desc.mipLevelCount - srcMip ) - 1 :
+                           mipCount;
+
+            // Dimensions should not reduce to 0.
+            // This can happen if the width and height are not the same.
+            dstWidth  = std::max( 1u, dstWidth );
+            dstHeight = std::max( 1u, dstHeight );
+
+            mip.srcMipLevel = srcMip;
+            mip.numMips     = mipCount;
+            mip.texelSize   = { 1.0f / static_cast<float>( dstWidth ), 1.0f / static_cast<float>( dstHeight ) };
+
+            passes.push_back( { texture, mip, dstWidth, dstHeight } );
+
+            srcMip += mipCount;
+        }
+    }
+
+    if ( passes.empty() )
+        return;
+
+    // The helper resources are created once and reused for all textures.
     if ( !generateMipsPipelineState )
+    {
         generateMipsPipelineState = std::make_unique<GenerateMipsPipelineState>();
 
-    auto desc = texture.getWGPUTextureDescriptor();
+        // Create a placeholder texture to pad any unused mips during mipmap generation.
+        WGPUTextureDescriptor dummyTextureDesc {};
+        dummyTextureDesc.label         = "Mip map placeholder texture";
+        dummyTextureDesc.usage         = WGPUTextureUsage_StorageBinding;
+        dummyTextureDesc.dimension     = WGPUTextureDimension_2D;
+        dummyTextureDesc.size          = { 16, 16, 1 };
+        dummyTextureDesc.format        = WGPUTextureFormat_RGBA8Unorm;
+        dummyTextureDesc.mipLevelCount = 4;
+        dummyTextureDesc.sampleCount   = 1;
+        generateMipsDummyTexture       = createTexture( dummyTextureDesc );
+
+        // Create a sampler
+        WGPUSamplerDescriptor linearClampSamplerDesc {};
+        linearClampSamplerDesc.label         = "Linear Clamp Sampler";
+        linearClampSamplerDesc.addressModeU  = WGPUAddressMode_ClampToEdge;
+        linearClampSamplerDesc.addressModeV  = WGPUAddressMode_ClampToEdge;
+        linearClampSamplerDesc.addressModeW  = WGPUAddressMode_ClampToEdge;
+        linearClampSamplerDesc.magFilter     = WGPUFilterMode_Linear;
+        linearClampSamplerDesc.minFilter     = WGPUFilterMode_Linear;
+        linearClampSamplerDesc.mipmapFilter  = WGPUMipmapFilterMode_Linear;
+        linearClampSamplerDesc.lodMinClamp   = 0.0f;
+        linearClampSamplerDesc.lodMaxClamp   = FLT_MAX;
+        linearClampSamplerDesc.compare       = WGPUCompareFunction_Undefined;
+        linearClampSamplerDesc.maxAnisotropy = 1;
+        generateMipsSampler                  = createSampler( linearClampSamplerDesc );
+    }
+
+    // Upload the mip info of all passes.
+    std::vector<uint8_t> mipData( passes.size() * MipBufferStride );
+    for ( std::size_t i = 0; i < passes.size(); ++i )
+    {
+        std::memcpy( mipData.data() + i * MipBufferStride, &passes[i].mip, sizeof( Mip ) );
+    }
 
-    auto commandBuffer = queue->createComputeCommandBuffer();
+    // The uniform buffer only grows. Previous submissions have already read their mip info
+    // since writes to the queue are ordered with submits.
+    if ( !generateMipsUniformBuffer || generateMipsUniformBuffer->getSize() < mipData.size() )
+        generateMipsUniformBuffer = createUniformBuffer( nullptr, mipData.size() );
 
-    commandBuffer->setComputePipeline( *generateMipsPipelineState );
+    queue->writeBuffer( *generateMipsUniformBuffer, mipData.data(), mipData.size() );
 
-    // Setup a temporary uniform buffer for uploading the mip info.
-    auto uniformBuffer = createUniformBuffer( nullptr, 4096u );  // 4k should be more than enough?
-
-    // Create a dummy texture to pad any unused mips.
-    // Create a placeholder texture to use during mipmap generation.
-    WGPUTextureDescriptor dummyTextureDesc {};
-    dummyTextureDesc.label         = "Mip map placeholder texture";
-    dummyTextureDesc.usage         = WGPUTextureUsage_StorageBinding;
-    dummyTextureDesc.dimension     = WGPUTextureDimension_2D;
-    dummyTextureDesc.size          = { 16, 16, 1 };
-    dummyTextureDesc.format        = WGPUTextureFormat_RGBA8Unorm;
-    dummyTextureDesc.mipLevelCount = 4;
-    dummyTextureDesc.sampleCount   = 1;
-    auto dummyTexture              = createTexture( dummyTextureDesc );
-
-    // Create a sampler
-    WGPUSamplerDescriptor linearClampSamplerDesc {};
-    linearClampSamplerDesc.label         = "Linear Clamp Sampler";
-    linearClampSamplerDesc.addressModeU  = WGPUAddressMode_ClampToEdge;
-    linearClampSamplerDesc.addressModeV  = WGPUAddressMode_ClampToEdge;
-    linearClampSamplerDesc.addressModeW  = WGPUAddressMode_ClampToEdge;
-    linearClampSamplerDesc.magFilter     = WGPUFilterMode_Linear;
-    linearClampSamplerDesc.minFilter     = WGPUFilterMode_Linear;
-    linearClampSamplerDesc.mipmapFilter  = WGPUMipmapFilterMode_Linear;
-    linearClampSamplerDesc.lodMinClamp   = 0.0f;
-    linearClampSamplerDesc.lodMaxClamp   = FLT_MAX;
-    linearClampSamplerDesc.compare       = WGPUCompareFunction_Undefined;
-    linearClampSamplerDesc.maxAnisotropy = 1;
-    auto sampler                         = createSampler( linearClampSamplerDesc );
+    // Record the passes of all textures into a single compute pass.
+    auto commandBuffer = queue->createComputeCommandBuffer( "Generate Mips" );
+
+    commandBuffer->setComputePipeline( *generateMipsPipelineState );
 
     // Bind the sampler
-    commandBuffer->bindSampler( 0, 6, *sampler );
+    commandBuffer->bindSampler( 0, 6, *generateMipsSampler );
 
-    for ( uint32_t srcMip = 0, pass = 0; srcMip < desc.mipLevelCount - 1; ++pass )
+    for ( std::size_t pass = 0; pass < passes.size(); ++pass )
     {
-        uint32_t srcWidth  = desc.size.width >> srcMip;
-        uint32_t srcHeight = desc.size.height >> srcMip;
-        uint32_t dstWidth  = srcWidth >> 1u;
-        uint32_t dstHeight = srcHeight >> 1u;
-
-        Mip mip {};
-        // 0b00(0): Both width and height are even.
-        // 0b01(1): Width is odd, height is even.
-        // 0b10(2): Width is even, height is odd.
-        // 0b11(3): Both width and height are odd.
-        mip.dimensions = ( srcHeight & 1 ) << 1 | ( srcWidth & 1 );
-
-        // The number of times we can half the size of the texture and get
-        // exactly a 50% reduction in size.
-        // A 1 bit in the width or height indicates an odd dimension.
-        // The case where either the width or the height is exactly 1 is handled
-        // as a special case (as the dimension does not require reduction).
-        int mipCount =
-            bitScanForward( ( dstWidth == 1 ? dstHeight : dstWidth ) | ( dstHeight == 1 ? dstWidth : dstHeight ) );
-
-        // Maximum number of mips to generate is 4.
-        mipCount = std::min( mipCount + 1, 4 );
-
-        // Clamp to total number of mips left over.
-        mipCount = ( srcMip + mipCount ) >= desc.mipLevelCount ? static_cast<int>( desc.mipLevelCount - srcMip ) - 1 :
-                                                                 mipCount;
-
-        // Dimensions should not reduce to 0.
-        // This can happen if the width and height are not the same.
-        dstWidth  = std::max( 1u, dstWidth );
-        dstHeight = std::max( 1u, dstHeight );
-
-        mip.srcMipLevel = srcMip;
-        mip.numMips     = mipCount;
-        mip.texelSize   = { 1.0f / static_cast<float>( dstWidth ), 1.0f / static_cast<float>( dstHeight ) };
-
-        // Write the mip info to the buffer.
-        uint32_t bufferOffset = 256 * pass;
-        queue->writeBuffer( *uniformBuffer, &mip, sizeof( Mip ), bufferOffset );
-
-        commandBuffer->bindBuffer( 0, 0, *uniformBuffer, bufferOffset, sizeof( Mip ) );
+        auto&       texture = *passes[pass].texture;
+        const auto& mip     = passes[pass].mip;
+        auto        desc    = texture.getWGPUTextureDescriptor();
+
+        commandBuffer->bindBuffer( 0, 0, *generateMipsUniformBuffer, pass * MipBufferStride, sizeof( Mip ) );
 
         // Setup a texture view for the source texture.
         WGPUTextureViewDescriptor srcTextureViewDesc {};
         srcTextureViewDesc.label           = "Generate Mip Source Texture";
         srcTextureViewDesc.format          = desc.format;
         srcTextureViewDesc.dimension       = WGPUTextureViewDimension_2D;
-        srcTextureViewDesc.baseMipLevel    = srcMip;
+        srcTextureViewDesc.baseMipLevel    = mip.srcMipLevel;
         srcTextureViewDesc.mipLevelCount   = 1;
         srcTextureViewDesc.baseArrayLayer  = 0;
         srcTextureViewDesc.arrayLayerCount = 1;
@@ -674,13 +1098,13 @@ void Device::generateMips( Texture& texture )
         commandBuffer->bindTexture( 0, 1, *srcTextureView );
 
         uint32_t dstMip = 0;
-        for ( ; dstMip < mipCount; ++dstMip )
+        for ( ; dstMip < mip.numMips; ++dstMip )
         {
             WGPUTextureViewDescriptor dstMipViewDesc {};
             dstMipViewDesc.label           = "Generate Mip Destination Texture";
             dstMipViewDesc.format          = desc.format;
             dstMipViewDesc.dimension       = WGPUTextureViewDimension_2D;
-            dstMipViewDesc.baseMipLevel    = srcMip + dstMip + 1;
+            dstMipViewDesc.baseMipLevel    = mip.srcMipLevel + dstMip + 1;
             dstMipViewDesc.mipLevelCount   = 1;
             dstMipViewDesc.baseArrayLayer  = 0;
             dstMipViewDesc.arrayLayerCount = 1;
@@ -702,21 +1126,315 @@ void Device::generateMips( Texture& texture )
             dstMipViewDesc.baseArrayLayer  = 0;
             dstMipViewDesc.arrayLayerCount = 1;
             dstMipViewDesc.aspect          = WGPUTextureAspect_All;
-            auto dstMipView                = dummyTexture->getView( &dstMipViewDesc );
+            auto dstMipView                = generateMipsDummyTexture->getView( &dstMipViewDesc );
 
             commandBuffer->bindTexture( 0, 2 + dstMip, *dstMipView );
         }
 
-        commandBuffer->dispatch( DivideByMultiple( dstWidth, 8 ), DivideByMultiple( dstHeight, 8 ) );
+        // Dispatches in a compute pass are synchronized, so the next pass can read the mips written by this pass.
+        commandBuffer->dispatch( DivideByMultiple( passes[pass].dstWidth, 8 ),
+                                 DivideByMultiple( passes[pass].dstHeight, 8 ) );
+    }
+
+    queue->submit( *commandBuffer );
+}
+
+void Device::generateMipsSinglePass( const std::vector<Texture*>& textures )
+{
+    // The minimum uniform buffer offset alignment is 256 bytes.
+    constexpr uint32_t MipBufferStride = 256;
+
+    // Textures that cannot be downsampled with a single dispatch use the multi-pass path.
+    std::vector<Texture*>       singlePassTextures;
+    std::vector<Texture*>       multiPassTextures;
+    std::vector<SinglePassMips> singlePassMips;
+
+    for ( auto* texture: textures )
+    {
+        if ( !texture )
+            continue;
+
+        auto desc = texture->getWGPUTextureDescriptor();
+
+        if ( desc.mipLevelCount <= 1 )
+            continue;
+
+        if ( !singlePassMipsSupported || desc.mipLevelCount - 1 > GenerateMipsSinglePassPipelineState::MaxMips ||
+             desc.format != WGPUTextureFormat_RGBA8Unorm )
+        {
+            multiPassTextures.push_back( texture );
+            continue;
+        }
+
+        SinglePassMips mips {};
+        mips.numMips = desc.mipLevelCount - 1;
+
+        singlePassTextures.push_back( texture );
+        singlePassMips.push_back( mips );
+    }
+
+    generateMips( multiPassTextures );
 
-        srcMip += mipCount;
+    if ( singlePassTextures.empty() )
+        return;
+
+    // The helper resources are created once and reused for all textures.
+    if ( !generateMipsSinglePassPipelineState )
+    {
+        generateMipsSinglePassPipelineState = std::make_unique<GenerateMipsSinglePassPipelineState>();
+
+        // Each unused mip is padded with a different layer of the placeholder texture.
+        WGPUTextureDescriptor dummyTextureDesc {};
+        dummyTextureDesc.label             = "Single pass mip map placeholder texture";
+        dummyTextureDesc.usage             = WGPUTextureUsage_StorageBinding;
+        dummyTextureDesc.dimension         = WGPUTextureDimension_2D;
+        dummyTextureDesc.size              = { 1, 1, GenerateMipsSinglePassPipelineState::MaxMips };
+        dummyTextureDesc.format            = WGPUTextureFormat_RGBA8Unorm;
+        dummyTextureDesc.mipLevelCount     = 1;
+        dummyTextureDesc.sampleCount       = 1;
+        generateMipsSinglePassDummyTexture = createTexture( dummyTextureDesc );
+
+        // Buffers are zero initialized, so the counter starts at 0.
+        generateMipsSinglePassCounterBuffer = createStorageBuffer( nullptr, 1, sizeof( uint32_t ) );
+        generateMipsSinglePassMip6Buffer    = createStorageBuffer(
+            nullptr, GenerateMipsSinglePassPipelineState::Mip6BufferSize / sizeof( uint32_t ), sizeof( uint32_t ) );
+    }
+
+    // Upload the parameters of all textures.
+    std::vector<uint8_t> mipData( singlePassMips.size() * MipBufferStride );
+    for ( std::size_t i = 0; i < singlePassMips.size(); ++i )
+    {
+        std::memcpy( mipData.data() + i * MipBufferStride, &singlePassMips[i], sizeof( SinglePassMips ) );
+    }
+
+    if ( !generateMipsSinglePassUniformBuffer || generateMipsSinglePassUniformBuffer->getSize() < mipData.size() )
+        generateMipsSinglePassUniformBuffer = createUniformBuffer( nullptr, mipData.size() );
+
+    queue->writeBuffer( *generateMipsSinglePassUniformBuffer, mipData.data(), mipData.size() );
+
+    // Record a single dispatch per texture into one compute pass.
+    auto commandBuffer = queue->createComputeCommandBuffer( "Generate Mips (Single Pass)" );
+
+    commandBuffer->setComputePipeline( *generateMipsSinglePassPipelineState );
+
+    commandBuffer->bindBuffer( 0, 2 + GenerateMipsSinglePassPipelineState::MaxMips,
+                               *generateMipsSinglePassCounterBuffer );
+    commandBuffer->bindBuffer( 0, 3 + GenerateMipsSinglePassPipelineState::MaxMips, *generateMipsSinglePassMip6Buffer );
+
+    for ( std::size_t i = 0; i < singlePassTextures.size(); ++i )
+    {
+        auto& texture = *singlePassTextures[i];
+        auto  desc    = texture.getWGPUTextureDescriptor();
+
+        commandBuffer->bindBuffer( 0, 0, *generateMipsSinglePassUniformBuffer, i * MipBufferStride,
+                                   sizeof( SinglePassMips ) );
+
+        WGPUTextureViewDescriptor srcTextureViewDesc {};
+        srcTextureViewDesc.label           = "Generate Mip Source Texture";
+        srcTextureViewDesc.format          = desc.format;
+        srcTextureViewDesc.dimension       = WGPUTextureViewDimension_2D;
+        srcTextureViewDesc.baseMipLevel    = 0;
+        srcTextureViewDesc.mipLevelCount   = 1;
+        srcTextureViewDesc.baseArrayLayer  = 0;
+        srcTextureViewDesc.arrayLayerCount = 1;
+        srcTextureViewDesc.aspect          = WGPUTextureAspect_All;
+        auto srcTextureView                = texture.getView( &srcTextureViewDesc );
+
+        commandBuffer->bindTexture( 0, 1, *srcTextureView );
+
+        for ( uint32_t dstMip = 0; dstMip < GenerateMipsSinglePassPipelineState::MaxMips; ++dstMip )
+        {
+            WGPUTextureViewDescriptor dstMipViewDesc {};
+            dstMipViewDesc.format          = desc.format;
+            dstMipViewDesc.dimension       = WGPUTextureViewDimension_2D;
+            dstMipViewDesc.mipLevelCount   = 1;
+            dstMipViewDesc.arrayLayerCount = 1;
+            dstMipViewDesc.aspect          = WGPUTextureAspect_All;
+
+            std::shared_ptr<TextureView> dstMipView;
+            if ( dstMip < singlePassMips[i].numMips )
+            {
+                dstMipViewDesc.label        = "Generate Mip Destination Texture";
+                dstMipViewDesc.baseMipLevel = dstMip + 1;
+                dstMipView                  = texture.getView( &dstMipViewDesc );
+            }
+            else
+            {
+                // Pad any unused mips with a dummy texture view.
+                dstMipViewDesc.label          = "Generate Mip Dummy Texture";
+                dstMipViewDesc.baseArrayLayer = dstMip;
+                dstMipView                    = generateMipsSinglePassDummyTexture->getView( &dstMipViewDesc );
+            }
+
+            commandBuffer->bindTexture( 0, 2 + dstMip, *dstMipView );
+        }
+
+        // Each workgroup downsamples a 64x64 tile of mip 0.
+        commandBuffer->dispatch( DivideByMultiple( desc.size.width, 64 ), DivideByMultiple( desc.size.height, 64 ) );
     }
 
     queue->submit( *commandBuffer );
 }
 
+// The largest number of vertices that can be addressed with 16-bit indices.
+constexpr std::size_t MaxVertexCount16 = 65536;
+
+// A part of an imported mesh with its own vertex and index buffer.
+// Only one of the index vectors is used.
+struct ImportedMeshPart
+{
+    std::vector<VertexPositionNormalTangentBitangentTexture> vertices;
+    std::vector<uint16_t>                                    indices16;
+    std::vector<uint32_t>                                    indices32;
+    BoundingBox                                              boundingBox;
+};
+
+// An imported mesh. Meshes with too many vertices for 16-bit indices may be split into multiple parts.
+struct ImportedMesh
+{
+    std::vector<ImportedMeshPart> parts;
+    VertexCacheStatistics         statisticsBefore;
+    VertexCacheStatistics         statisticsAfter;
+};
+
+// Extract the vertices and indices of a mesh and optimize them for the vertex cache, overdraw and vertex fetch.
+// This only reads from the Assimp mesh, so meshes can be imported on worker threads.
+// The vertex stride is the size of a vertex in the vertex buffer, which is used to decide if a mesh is split.
+ImportedMesh importMesh( const aiMesh* aiMesh, std::size_t vertexStride )
+{
+    std::vector<VertexPositionNormalTangentBitangentTexture> vertices { aiMesh->mNumVertices };
+    std::vector<uint32_t>                                    indices;
+
+    if ( aiMesh->HasPositions() )
+    {
+        for ( unsigned int v = 0; v < aiMesh->mNumVertices; ++v )
+        {
+            aiVector3D p         = aiMesh->mVertices[v];
+            vertices[v].position = { p.x, p.y, p.z };
+        }
+    }
+    if ( aiMesh->HasNormals() )
+    {
+        for ( unsigned int v = 0; v < aiMesh->mNumVertices; ++v )
+        {
+            aiVector3D n       = aiMesh->mNormals[v];
+            vertices[v].normal = { n.x, n.y, n.z };
+        }
+    }
+    if ( aiMesh->HasTangentsAndBitangents() )
+    {
+        for ( unsigned int v = 0; v < aiMesh->mNumVertices; ++v )
+        {
+            aiVector3D t          = aiMesh->mTangents[v];
+            aiVector3D b          = aiMesh->mBitangents[v];
+            vertices[v].tangent   = { t.x, t.y, t.z };
+            vertices[v].bitangent = { b.x, b.y, b.z };
+        }
+    }
+    if ( aiMesh->HasTextureCoords( 0 ) )
+    {
+        for ( unsigned int v = 0; v < aiMesh->mNumVertices; ++v )
+        {
+            aiVector3D uv        = aiMesh->mTextureCoords[0][v];
+            vertices[v].texCoord = { uv.x, uv.y, uv.z };
+        }
+    }
+
+    // Extract the indices.
+    if ( aiMesh->HasFaces() )
+    {
+        indices.reserve( static_cast<std::size_t>( aiMesh->mNumFaces ) * 3 );
+
+        for ( unsigned int f = 0; f < aiMesh->mNumFaces; ++f )
+        {
+            const aiFace& face = aiMesh->mFaces[f];
+
+            // We only care about triangular faces.
+            if ( face.mNumIndices == 3 )
+            {
+                indices.push_back( face.mIndices[0] );
+                indices.push_back( face.mIndices[1] );
+                indices.push_back( face.mIndices[2] );
+            }
+        }
+    }
+
+    ImportedMesh mesh;
+
+    // Meshes without faces are drawn without an index buffer.
+    if ( indices.empty() )
+    {
+        ImportedMeshPart part;
+        part.vertices = std::move( vertices );
+        mesh.parts.push_back( std::move( part ) );
+        return mesh;
+    }
+
+    mesh.statisticsBefore = analyzeVertexCache( indices, vertices.size() );
+    optimizeMesh( vertices, indices );
+    mesh.statisticsAfter = analyzeVertexCache( indices, vertices.size() );
+
+    if ( vertices.size() <= MaxVertexCount16 )
+    {
+        ImportedMeshPart part;
+        part.indices16.assign( indices.begin(), indices.end() );
+        part.vertices = std::move( vertices );
+        mesh.parts.push_back( std::move( part ) );
+        return mesh;
+    }
+
+    // Split large meshes into parts that can use 16-bit indices.
+    // The vertices on the boundaries between the parts are duplicated.
+    auto ranges = partitionTriangles( indices, vertices.size(), MaxVertexCount16 );
+
+    std::vector<ImportedMeshPart> parts;
+    std::size_t                   partVertexCount = 0;
+
+    for ( std::size_t r = 0; r < ranges.size(); ++r )
+    {
+        const std::size_t begin = static_cast<std::size_t>( ranges[r] ) * 3;
+        const std::size_t end =
+            r + 1 < ranges.size() ? static_cast<std::size_t>( ranges[r + 1] ) * 3 : indices.size();
+
+        std::vector<uint32_t> partIndices { indices.begin() + begin, indices.begin() + end };
+        auto [remap, vertexCount] = optimizeVertexFetchRemap( partIndices, vertices.size() );
+
+        ImportedMeshPart part;
+        part.vertices.resize( vertexCount );
+        for ( std::size_t v = 0; v < vertices.size(); ++v )
+        {
+            if ( remap[v] == ~0u )
+                continue;
+
+            part.vertices[remap[v]] = vertices[v];
+            part.boundingBox.merge( vertices[v].position );
+        }
+        part.indices16.assign( partIndices.begin(), partIndices.end() );
+
+        partVertexCount += vertexCount;
+        parts.push_back( std::move( part ) );
+    }
+
+    // Only split the mesh if the index memory that is saved is more than the memory of the duplicated vertices.
+    const std::size_t savedBytes      = indices.size() * ( sizeof( uint32_t ) - sizeof( uint16_t ) );
+    const std::size_t duplicatedBytes = ( partVertexCount - vertices.size() ) * vertexStride;
+
+    if ( savedBytes > duplicatedBytes )
+    {
+        mesh.parts = std::move( parts );
+        return mesh;
+    }
+
+    ImportedMeshPart part;
+    part.indices32 = std::move( indices );
+    part.vertices  = std::move( vertices );
+    mesh.parts.push_back( std::move( part ) );
+
+    return mesh;
+}
+
 std::shared_ptr<SceneNode> importSceneNode( const aiNode* aiNode, std::shared_ptr<SceneNode> parent,
-                                            const std::vector<std::shared_ptr<Mesh>>& meshes )
+                                            const std::vector<std::vector<std::shared_ptr<Mesh>>>& meshes )
 {
     if ( !aiNode )
     {
@@ -735,7 +1453,9 @@ std::shared_ptr<SceneNode> importSceneNode( const aiNode* aiNode, std::shared_pt
 
     for ( unsigned int i = 0; i < aiNode->mNumMeshes; ++i )
     {
-        node->addMesh( meshes[aiNode->mMeshes[i]] );
+        // Add all parts of the mesh.
+        for ( auto& mesh: meshes[aiNode->mMeshes[i]] )
+            node->addMesh( mesh );
     }
 
     // Import children.
@@ -749,6 +1469,12 @@ std::shared_ptr<SceneNode> importSceneNode( const aiNode* aiNode, std::shared_pt
 }
 
 std::shared_ptr<Scene> Device::loadScene( const std::filesystem::path& filePath )
+{
+    return loadScene( filePath, TextureLoadOptions {} );
+}
+
+std::shared_ptr<Scene> Device::loadScene( const std::filesystem::path& filePath,
+                                          const TextureLoadOptions& textureLoadOptions, VertexLayout vertexLayout )
 {
     fs::path parentPath = filePath.parent_path();
 
@@ -768,8 +1494,9 @@ std::shared_ptr<Scene> Device::loadScene( const std::filesystem::path& filePath
         importer.SetPropertyFloat( AI_CONFIG_PP_GSN_MAX_SMOOTHING_ANGLE, 80.0f );
         importer.SetPropertyInteger( AI_CONFIG_PP_SBP_REMOVE, aiPrimitiveType_POINT | aiPrimitiveType_LINE );
 
-        unsigned int preprocessFlags = aiProcessPreset_TargetRealtime_MaxQuality | aiProcess_OptimizeGraph |
-                                       aiProcess_FlipUVs | aiProcess_GenBoundingBoxes;
+        // The meshes are optimized for the vertex cache when they are loaded (see importMesh).
+        unsigned int preprocessFlags = ( aiProcessPreset_TargetRealtime_MaxQuality & ~aiProcess_ImproveCacheLocality ) |
+                                       aiProcess_OptimizeGraph | aiProcess_FlipUVs | aiProcess_GenBoundingBoxes;
         scene = importer.ReadFile( filePath.string(), preprocessFlags );
 
         if ( scene )
@@ -785,16 +1512,84 @@ std::shared_ptr<Scene> Device::loadScene( const std::filesystem::path& filePath
         return nullptr;
     }
 
+    // The meshes are imported and optimized on the thread pool while the materials and textures are loaded.
+    std::vector<std::future<ImportedMesh>> meshTasks;
+    meshTasks.reserve( scene->mNumMeshes );
+
+    const std::size_t vertexStride = vertexLayout == VertexLayout::PositionPackedNormalTangentTexture
+                                         ? sizeof( VertexPositionPackedNormalTangentTexture )
+                                         : sizeof( VertexPositionNormalTangentBitangentTexture );
+
+    for ( unsigned int m = 0; m < scene->mNumMeshes; ++m )
+    {
+        const aiMesh* aiMesh = scene->mMeshes[m];
+        meshTasks.push_back(
+            threadPool->submit( [aiMesh, vertexStride] { return importMesh( aiMesh, vertexStride ); } ) );
+    }
+
     // Import materials.
     std::vector<std::shared_ptr<Material>> materials;
     materials.reserve( scene->mNumMaterials );
 
+    // Texture files are decoded on the thread pool while the materials are imported.
+    // The GPU textures are created on this thread after all of the decode tasks have been queued.
+    // Each file is only decoded once, even if it is used by multiple materials.
+    struct PendingTexture
+    {
+        std::shared_ptr<Material>        material;
+        TextureSlot                      slot;
+        TextureCache::Key                key;
+        std::shared_future<DecodedImage> image;
+    };
+    std::vector<PendingTexture> pendingTextures;
+    std::vector<Texture*>       generateMipsTextures;
+    std::unordered_map<TextureCache::Key, std::shared_future<DecodedImage>, TextureCache::KeyHash> decodeTasks;
+
+    const bool     compressTextures = textureLoadOptions.compress && textureCompressionBCSupported;
+    const uint64_t textureCacheHits = textureCache->getHitCount();
+    std::size_t    textureBytes     = 0;
+
+    // Remove the textures of previously loaded scenes that have been released.
+    textureCache->purge();
+
+    auto textureLoadStart = std::chrono::high_resolution_clock::now();
+
     for ( unsigned int i = 0; i < scene->mNumMaterials; ++i )
     {
         const aiMaterial*         aiMaterial = scene->mMaterials[i];
         std::shared_ptr<Material> material   = std::make_shared<Material>();
 
-        aiString  texturePath;
+        aiString texturePath;
+
+        auto decodeTexture = [&]( TextureSlot slot ) {
+            fs::path path = parentPath / texturePath.C_Str();
+
+            // Normal maps are compressed to two channels.
+            TextureLoadOptions options = textureLoadOptions;
+            options.normalMap          = slot == TextureSlot::Normal;
+
+            auto key = TextureCache::getKey( path, options );
+
+            // Use the texture if it is still loaded.
+            if ( auto texture = textureCache->find( key ) )
+            {
+                material->setTexture( slot, texture );
+                return;
+            }
+
+            auto& decodeTask = decodeTasks[key];
+            if ( !decodeTask.valid() )
+            {
+                decodeTask = threadPool
+                                 ->submit( [path, options, compressTextures] {
+                                     return decodeImage( path, options, compressTextures );
+                                 } )
+                                 .share();
+            }
+
+            pendingTextures.push_back( { material, slot, std::move( key ), decodeTask } );
+        };
+
         aiColor4D ambientColor;
         aiColor4D emissiveColor;
         aiColor4D diffuseColor;
@@ -844,152 +1639,206 @@ std::shared_ptr<Scene> Device::loadScene( const std::filesystem::path& filePath
         if ( aiMaterial->GetTextureCount( aiTextureType_AMBIENT ) > 0 &&
              aiMaterial->GetTexture( aiTextureType_AMBIENT, 0, &texturePath ) == aiReturn_SUCCESS )
         {
-            auto texture = loadTexture( parentPath / texturePath.C_Str() );
-            material->setTexture( TextureSlot::Ambient, texture );
+            decodeTexture( TextureSlot::Ambient );
         }
         if ( aiMaterial->GetTextureCount( aiTextureType_EMISSIVE ) > 0 &&
              aiMaterial->GetTexture( aiTextureType_EMISSIVE, 0, &texturePath ) == aiReturn_SUCCESS )
         {
-            auto texture = loadTexture( parentPath / texturePath.C_Str() );
-            material->setTexture( TextureSlot::Emissive, texture );
+            decodeTexture( TextureSlot::Emissive );
         }
         if ( aiMaterial->GetTextureCount( aiTextureType_DIFFUSE ) > 0 &&
              aiMaterial->GetTexture( aiTextureType_DIFFUSE, 0, &texturePath ) == aiReturn_SUCCESS )
         {
-            auto texture = loadTexture( parentPath / texturePath.C_Str() );
-            material->setTexture( TextureSlot::Diffuse, texture );
+            decodeTexture( TextureSlot::Diffuse );
         }
         if ( aiMaterial->GetTextureCount( aiTextureType_SPECULAR ) > 0 &&
              aiMaterial->GetTexture( aiTextureType_SPECULAR, 0, &texturePath ) == aiReturn_SUCCESS )
         {
-            auto texture = loadTexture( parentPath / texturePath.C_Str() );
-            material->setTexture( TextureSlot::Specular, texture );
+            decodeTexture( TextureSlot::Specular );
         }
         if ( aiMaterial->GetTextureCount( aiTextureType_SHININESS ) > 0 &&
              aiMaterial->GetTexture( aiTextureType_SHININESS, 0, &texturePath ) == aiReturn_SUCCESS )
         {
-            auto texture = loadTexture( parentPath / texturePath.C_Str() );
-            material->setTexture( TextureSlot::SpecularPower, texture );
+            decodeTexture( TextureSlot::SpecularPower );
         }
         if ( aiMaterial->GetTextureCount( aiTextureType_OPACITY ) > 0 &&
              aiMaterial->GetTexture( aiTextureType_OPACITY, 0, &texturePath ) == aiReturn_SUCCESS )
         {
-            auto texture = loadTexture( parentPath / texturePath.C_Str() );
-            material->setTexture( TextureSlot::Opacity, texture );
+            decodeTexture( TextureSlot::Opacity );
         }
         if ( aiMaterial->GetTextureCount( aiTextureType_NORMALS ) > 0 &&
              aiMaterial->GetTexture( aiTextureType_NORMALS, 0, &texturePath ) == aiReturn_SUCCESS )
         {
-            auto texture = loadTexture( parentPath / texturePath.C_Str() );
-            material->setTexture( TextureSlot::Normal, texture );
+            decodeTexture( TextureSlot::Normal );
         }
         else if ( aiMaterial->GetTextureCount( aiTextureType_HEIGHT ) > 0 &&
                   aiMaterial->GetTexture( aiTextureType_HEIGHT, 0, &texturePath ) == aiReturn_SUCCESS )
         {
-            auto texture = loadTexture( parentPath / texturePath.C_Str() );
-            material->setTexture( TextureSlot::Normal, texture );  // Assume height maps are actually normal maps.
+            decodeTexture( TextureSlot::Normal );  // Assume height maps are actually normal maps.
         }
 
         materials.emplace_back( std::move( material ) );
     }
 
-    // Import meshes.
-    std::vector<std::shared_ptr<Mesh>> meshes;
-    meshes.reserve( scene->mNumMeshes );
-
-    for ( unsigned int m = 0; m < scene->mNumMeshes; ++m )
+    for ( auto& pendingTexture: pendingTextures )
     {
-        const aiMesh* aiMesh = scene->mMeshes[m];
+        // The texture was already created for another material.
+        auto texture = textureCache->find( pendingTexture.key );
 
-        std::shared_ptr<Mesh>                                    mesh = std::make_shared<Mesh>();
-        std::vector<VertexPositionNormalTangentBitangentTexture> vertexData { aiMesh->mNumVertices };
-
-        assert( aiMesh->mMaterialIndex < materials.size() );
-        mesh->setMaterial( materials[aiMesh->mMaterialIndex] );
-
-        if ( aiMesh->HasPositions() )
-        {
-            for ( unsigned int v = 0; v < aiMesh->mNumVertices; ++v )
-            {
-                aiVector3D p           = aiMesh->mVertices[v];
-                vertexData[v].position = { p.x, p.y, p.z };
-            }
-        }
-        if ( aiMesh->HasNormals() )
+        if ( !texture )
         {
-            for ( unsigned int v = 0; v < aiMesh->mNumVertices; ++v )
+            const DecodedImage& image = pendingTexture.image.get();
+
+            if ( image.error )
             {
-                aiVector3D n         = aiMesh->mNormals[v];
-                vertexData[v].normal = { n.x, n.y, n.z };
+                std::cerr << "ERROR: " << image.error << ": " << image.filePath << std::endl;
+                continue;
             }
-        }
-        if ( aiMesh->HasTangentsAndBitangents() )
-        {
-            for ( unsigned int v = 0; v < aiMesh->mNumVertices; ++v )
+
+            const auto& options = pendingTexture.key.options;
+            const auto  label   = fs::path( image.filePath ).filename().string();
+
+            if ( image.compressed.isValid() )
             {
-                aiVector3D t            = aiMesh->mTangents[v];
-                aiVector3D b            = aiMesh->mBitangents[v];
-                vertexData[v].tangent   = { t.x, t.y, t.z };
-                vertexData[v].bitangent = { b.x, b.y, b.z };
+                texture = createCompressedTexture( image.compressed, label );
+                textureBytes += image.compressed.getSizeInBytes();
             }
-        }
-        if ( aiMesh->HasTextureCoords( 0 ) )
-        {
-            for ( unsigned int v = 0; v < aiMesh->mNumVertices; ++v )
+            else
             {
-                aiVector3D uv          = aiMesh->mTextureCoords[0][v];
-                vertexData[v].texCoord = { uv.x, uv.y, uv.z };
+                texture = createTextureFromPixels( image.pixels.get(), image.width, image.height, label, options );
+
+                // The mips add about a third to the size of the texture.
+                const std::size_t size = static_cast<std::size_t>( image.width ) * image.height * 4;
+                textureBytes += options.generateMips ? size * 4 / 3 : size;
+
+                if ( options.generateMips )
+                    generateMipsTextures.push_back( texture.get() );
             }
+
+            textureCache->insert( pendingTexture.key, texture );
+
+            std::cout << "INFO: Loaded texture: " << image.filePath;
+            if ( image.compressed.isValid() )
+                std::cout << ( image.isCached ? " (compressed, cached)" : " (compressed)" );
+            std::cout << std::endl;
         }
 
-        auto vertexBuffer = createVertexBuffer( vertexData );
-        mesh->setVertexBuffer( 0, vertexBuffer );
+        pendingTexture.material->setTexture( pendingTexture.slot, texture );
+    }
+
+    // Generate the mips of all new textures in a single submit.
+    generateMips( generateMipsTextures );
+
+    if ( !decodeTasks.empty() )
+    {
+        auto textureLoadTime = std::chrono::duration<double, std::milli>( std::chrono::high_resolution_clock::now() -
+                                                                         textureLoadStart );
+        std::cout << "INFO: Loaded " << decodeTasks.size() << " textures in " << textureLoadTime.count() << " ms using "
+                  << std::max<std::size_t>( threadPool->getThreadCount(), 1 ) << " threads ("
+                  << textureCache->getHitCount() - textureCacheHits << " loads avoided by the texture cache, "
+                  << textureBytes / ( 1024 * 1024 ) << " MiB of texture memory)." << std::endl;
+    }
+
+    // Import meshes.
+    // Each Assimp mesh is imported as one or more meshes (see importMesh).
+    std::vector<std::vector<std::shared_ptr<Mesh>>> meshes;
+    meshes.reserve( scene->mNumMeshes );
+
+    VertexCacheStatistics statisticsBefore;
+    VertexCacheStatistics statisticsAfter;
+    std::size_t           indexBufferCount   = 0;
+    std::size_t           indexBufferCount16 = 0;
+    std::size_t           indexBytes         = 0;
+
+    for ( unsigned int m = 0; m < scene->mNumMeshes; ++m )
+    {
+        const aiMesh* aiMesh       = scene->mMeshes[m];
+        ImportedMesh  importedMesh = meshTasks[m].get();
+        auto&         meshParts    = meshes.emplace_back();
 
-        // Extract index buffer.
-        if ( aiMesh->HasFaces() )
+        for ( auto& part: importedMesh.parts )
         {
-            std::vector<unsigned int> indices;
-            indices.reserve( aiMesh->mNumFaces * 3 );
+            std::shared_ptr<Mesh> mesh = std::make_shared<Mesh>();
 
-            for ( unsigned int f = 0; f < aiMesh->mNumFaces; ++f )
+            assert( aiMesh->mMaterialIndex < materials.size() );
+            mesh->setMaterial( materials[aiMesh->mMaterialIndex] );
+
+            auto vertexBuffer = createMeshVertexBuffer( part.vertices, vertexLayout );
+            mesh->setVertexBuffer( 0, vertexBuffer );
+
+            if ( importedMesh.parts.size() == 1 )
+            {
+                // The bounding box is computed by Assimp (aiProcess_GenBoundingBoxes).
+                const aiAABB& aabb = aiMesh->mAABB;
+                mesh->setBoundingBox( { { aabb.mMin.x, aabb.mMin.y, aabb.mMin.z },
+                                        { aabb.mMax.x, aabb.mMax.y, aabb.mMax.z } } );
+            }
+            else
             {
-                const aiFace& face = aiMesh->mFaces[f];
-
-                // We only care about triangular faces.
-                if ( face.mNumIndices == 3 )
-                {
-                    indices.push_back( face.mIndices[0] );
-                    indices.push_back( face.mIndices[1] );
-                    indices.push_back( face.mIndices[2] );
-                }
+                mesh->setBoundingBox( part.boundingBox );
             }
 
-            if ( !indices.empty() )
+            std::shared_ptr<IndexBuffer> indexBuffer;
+            if ( !part.indices16.empty() )
+                indexBuffer = createIndexBuffer( part.indices16 );
+            else if ( !part.indices32.empty() )
+                indexBuffer = createIndexBuffer( part.indices32 );
+
+            if ( indexBuffer )
             {
-                auto indexBuffer = createIndexBuffer( indices );
                 mesh->setIndexBuffer( indexBuffer );
+
+                ++indexBufferCount;
+                indexBufferCount16 += indexBuffer->getIndexStride() == sizeof( uint16_t ) ? 1 : 0;
+                indexBytes += indexBuffer->getSize();
             }
+
+            meshParts.emplace_back( std::move( mesh ) );
         }
 
-        meshes.emplace_back( std::move( mesh ) );
+        statisticsBefore += importedMesh.statisticsBefore;
+        statisticsAfter += importedMesh.statisticsAfter;
     }
 
+    std::cout << "INFO: Optimized " << meshes.size() << " meshes (" << statisticsAfter.triangleCount
+              << " triangles). ACMR: " << statisticsBefore.getACMR() << " -> " << statisticsAfter.getACMR()
+              << ", ATVR: " << statisticsBefore.getATVR() << " -> " << statisticsAfter.getATVR() << std::endl;
+    std::cout << "INFO: " << indexBufferCount16 << " of " << indexBufferCount << " index buffers use 16-bit indices ("
+              << indexBytes / 1024 << " KiB of indices)." << std::endl;
+
     auto rootNode = importSceneNode( scene->mRootNode, nullptr, meshes );
 
     return std::make_shared<Scene>( rootNode );
 }
 
+std::pair<std::shared_ptr<BufferArena>, uint64_t>
+    Device::allocateFromArena( std::vector<std::shared_ptr<BufferArena>>& arenas, WGPUBufferUsage usage,
+                               std::size_t sizeInBytes, std::size_t alignment, const char* label ) const
+{
+    for ( auto& arena: arenas )
+    {
+        if ( auto offset = arena->allocate( sizeInBytes, alignment ) )
+            return { arena, *offset };
+    }
+
+    // Large buffers get an arena of their own.
+    auto arena = std::make_shared<BufferArena>( usage, std::max<std::size_t>( sizeInBytes, _64MB ), label );
+    arenas.push_back( arena );
+
+    return { arena, *arena->allocate( sizeInBytes, alignment ) };
+}
+
 std::shared_ptr<VertexBuffer> Device::createVertexBuffer( const void* vertexData, std::size_t vertexCount,
                                                           std::size_t vertexStride ) const
 {
-    std::size_t          size = vertexCount * vertexStride;
-    WGPUBufferDescriptor bufferDescriptor {};
-    bufferDescriptor.size  = size;
-    bufferDescriptor.usage = WGPUBufferUsage_Vertex | WGPUBufferUsage_CopyDst;
-    WGPUBuffer buffer      = wgpuDeviceCreateBuffer( device, &bufferDescriptor );
+    std::size_t size = vertexCount * vertexStride;
+
+    // The offset must be a multiple of the vertex stride so the mesh can be drawn with a base vertex.
+    auto [arena, offset] = allocateFromArena( vertexArenas, WGPUBufferUsage_Vertex, size,
+                                              std::lcm<std::size_t>( vertexStride, 4 ), "Vertex Buffer Arena" );
 
-    auto vertexBuffer = std::make_shared<MakeVertexBuffer>( std::move( buffer ),  // NOLINT(performance-move-const-arg)
-                                                            vertexCount, vertexStride );
+    auto vertexBuffer = std::make_shared<MakeVertexBuffer>( arena->referenceWGPUBuffer(), vertexCount, vertexStride,
+                                                            arena, offset );
 
     if ( vertexData )
         queue->writeBuffer( *vertexBuffer, vertexData, size );
@@ -1000,14 +1849,14 @@ std::shared_ptr<VertexBuffer> Device::createVertexBuffer( const void* vertexData
 std::shared_ptr<IndexBuffer> Device::createIndexBuffer( const void* indexData, std::size_t indexCount,
                                                         std::size_t indexStride ) const
 {
-    std::size_t          size = indexCount * indexStride;
-    WGPUBufferDescriptor bufferDescriptor {};
-    bufferDescriptor.size  = size;
-    bufferDescriptor.usage = WGPUBufferUsage_Index | WGPUBufferUsage_CopyDst;
-    WGPUBuffer buffer      = wgpuDeviceCreateBuffer( device, &bufferDescriptor );
+    std::size_t size = indexCount * indexStride;
+
+    // The offset must be a multiple of the index stride so the mesh can be drawn with a first index.
+    auto [arena, offset] = allocateFromArena( indexArenas, WGPUBufferUsage_Index, size,
+                                              std::lcm<std::size_t>( indexStride, 4 ), "Index Buffer Arena" );
 
-    auto indexBuffer = std::make_shared<MakeIndexBuffer>( std::move( buffer ),  // NOLINT(performance-move-const-arg)
-                                                          indexCount, indexStride );
+    auto indexBuffer = std::make_shared<MakeIndexBuffer>( arena->referenceWGPUBuffer(), indexCount, indexStride,
+                                                          arena, offset );
 
     if ( indexData )
         queue->writeBuffer( *indexBuffer, indexData, size );
@@ -1034,11 +1883,24 @@ std::shared_ptr<UniformBuffer> Device::createUniformBuffer( const void* data, st
 
 std::shared_ptr<StorageBuffer> Device::createStorageBuffer( const void* data, std::size_t elementCount,
                                                             std::size_t elementSize ) const
+{
+    return createStorageBuffer( data, elementCount, elementSize, WGPUBufferUsage_Storage | WGPUBufferUsage_CopyDst );
+}
+
+std::shared_ptr<StorageBuffer> Device::createIndirectBuffer( const void* data, std::size_t elementCount,
+                                                             std::size_t elementSize ) const
+{
+    return createStorageBuffer( data, elementCount, elementSize,
+                                WGPUBufferUsage_Storage | WGPUBufferUsage_Indirect | WGPUBufferUsage_CopyDst );
+}
+
+std::shared_ptr<StorageBuffer> Device::createStorageBuffer( const void* data, std::size_t elementCount,
+                                                            std::size_t elementSize, WGPUBufferUsageFlags usage ) const
 {
     std::size_t          size = elementCount * elementSize;
     WGPUBufferDescriptor bufferDescriptor {};
     bufferDescriptor.size             = size;
-    bufferDescriptor.usage            = WGPUBufferUsage_Storage | WGPUBufferUsage_CopyDst;
+    bufferDescriptor.usage            = usage;
     bufferDescriptor.mappedAtCreation = false;
     WGPUBuffer buffer                 = wgpuDeviceCreateBuffer( device, &bufferDescriptor );
 
@@ -1083,6 +1945,26 @@ void Device::poll( bool sleep )
 #endif
 }
 
+void Device::waitIdle()
+{
+    bool done = false;
+    wgpuQueueOnSubmittedWorkDone(
+        queue->getWGPUQueue(),
+        []( WGPUQueueWorkDoneStatus status, void* userdata ) { *static_cast<bool*>( userdata ) = true; }, &done );
+
+    while ( !done )
+    {
+        poll( true );
+    }
+}
+
+void Device::endFrame()
+{
+    bindGroupCache->endFrame();
+    uploadPagePool->endFrame();
+    gpuProfiler->endFrame( *queue );
+}
+
 void Device::onDeviceLostCallback( WGPUDeviceLostReason reason, char const* message, void* userdata )
 {
     std::cerr << "Device lost: " << std::hex << reason << std::dec;
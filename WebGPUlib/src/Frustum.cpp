@@ -0,0 +1,124 @@
+#include <WebGPUlib/Frustum.hpp>
+
+#include <glm/common.hpp>
+#include <glm/geometric.hpp>
+
+#if defined( __SSE__ ) || defined( _M_X64 ) || ( defined( _M_IX86_FP ) && _M_IX86_FP >= 1 )
+    #define WEBGPULIB_FRUSTUM_SSE 1
+    #include <xmmintrin.h>
+#endif
+
+using namespace WebGPUlib;
+
+Frustum::Frustum( const glm::mat4& m )
+{
+    // Source: Gil Gribb, Klaus Hartmann, "Fast Extraction of Viewing Frustum Planes from the
+    // World-View-Projection Matrix" (2001).
+    // The matrix is column-major, so the rows of the matrix are gathered from the columns.
+    glm::vec4 row0 { m[0][0], m[1][0], m[2][0], m[3][0] };
+    glm::vec4 row1 { m[0][1], m[1][1], m[2][1], m[3][1] };
+    glm::vec4 row2 { m[0][2], m[1][2], m[2][2], m[3][2] };
+    glm::vec4 row3 { m[0][3], m[1][3], m[2][3], m[3][3] };
+
+    planes[Left]   = row3 + row0;
+    planes[Right]  = row3 - row0;
+    planes[Bottom] = row3 + row1;
+    planes[Top]    = row3 - row1;
+    planes[Near]   = row2;  // Depth range is [0, 1].
+    planes[Far]    = row3 - row2;
+
+    for ( auto& plane: planes )
+    {
+        float length = glm::length( glm::vec3 { plane } );
+        if ( length > 0.0f )
+            plane /= length;
+    }
+}
+
+Frustum::Containment Frustum::contains( const BoundingBox& boundingBox ) const
+{
+    if ( !boundingBox.isValid() )
+        return Containment::Outside;
+
+    const glm::vec3 center  = boundingBox.getCenter();
+    const glm::vec3 extents = boundingBox.getExtents();
+
+    Containment result = Containment::Inside;
+
+    for ( const auto& plane: planes )
+    {
+        const glm::vec3 normal { plane };
+
+        float distance = glm::dot( normal, center ) + plane.w;
+        float radius   = glm::dot( glm::abs( normal ), extents );
+
+        if ( distance + radius < 0.0f )
+            return Containment::Outside;
+
+        if ( distance - radius < 0.0f )
+            result = Containment::Intersects;
+    }
+
+    return result;
+}
+
+void Frustum::cull( const BoundingBox* boundingBoxes, std::size_t count, uint8_t* visible ) const
+{
+    std::size_t i = 0;
+
+#ifdef WEBGPULIB_FRUSTUM_SSE
+    // Test 4 bounding boxes against each plane at a time.
+    // Invalid (empty) bounding boxes have negative extents, so they always end up outside the frustum.
+    const __m128 half = _mm_set1_ps( 0.5f );
+
+    for ( ; i + 4 <= count; i += 4 )
+    {
+        const BoundingBox* b = boundingBoxes + i;
+
+        __m128 minX = _mm_setr_ps( b[0].min.x, b[1].min.x, b[2].min.x, b[3].min.x );
+        __m128 minY = _mm_setr_ps( b[0].min.y, b[1].min.y, b[2].min.y, b[3].min.y );
+        __m128 minZ = _mm_setr_ps( b[0].min.z, b[1].min.z, b[2].min.z, b[3].min.z );
+        __m128 maxX = _mm_setr_ps( b[0].max.x, b[1].max.x, b[2].max.x, b[3].max.x );
+        __m128 maxY = _mm_setr_ps( b[0].max.y, b[1].max.y, b[2].max.y, b[3].max.y );
+        __m128 maxZ = _mm_setr_ps( b[0].max.z, b[1].max.z, b[2].max.z, b[3].max.z );
+
+        __m128 centerX  = _mm_mul_ps( _mm_add_ps( minX, maxX ), half );
+        __m128 centerY  = _mm_mul_ps( _mm_add_ps( minY, maxY ), half );
+        __m128 centerZ  = _mm_mul_ps( _mm_add_ps( minZ, maxZ ), half );
+        __m128 extentsX = _mm_mul_ps( _mm_sub_ps( maxX, minX ), half );
+        __m128 extentsY = _mm_mul_ps( _mm_sub_ps( maxY, minY ), half );
+        __m128 extentsZ = _mm_mul_ps( _mm_sub_ps( maxZ, minZ ), half );
+
+        __m128 inside = _mm_cmpeq_ps( half, half );  // All bits set.
+
+        for ( const auto& plane: planes )
+        {
+            __m128 normalX = _mm_set1_ps( plane.x );
+            __m128 normalY = _mm_set1_ps( plane.y );
+            __m128 normalZ = _mm_set1_ps( plane.z );
+
+            __m128 distance = _mm_add_ps( _mm_add_ps( _mm_mul_ps( normalX, centerX ), _mm_mul_ps( normalY, centerY ) ),
+                                          _mm_add_ps( _mm_mul_ps( normalZ, centerZ ), _mm_set1_ps( plane.w ) ) );
+
+            __m128 radius = _mm_add_ps( _mm_add_ps( _mm_mul_ps( _mm_set1_ps( glm::abs( plane.x ) ), extentsX ),
+                                                    _mm_mul_ps( _mm_set1_ps( glm::abs( plane.y ) ), extentsY ) ),
+                                        _mm_mul_ps( _mm_set1_ps( glm::abs( plane.z ) ), extentsZ ) );
+
+            inside = _mm_and_ps( inside, _mm_cmpge_ps( _mm_add_ps( distance, radius ), _mm_setzero_ps() ) );
+        }
+
+        int mask = _mm_movemask_ps( inside );
+
+        visible[i + 0] = static_cast<uint8_t>( ( mask >> 0 ) & 1 );
+        visible[i + 1] = static_cast<uint8_t>( ( mask >> 1 ) & 1 );
+        visible[i + 2] = static_cast<uint8_t>( ( mask >> 2 ) & 1 );
+        visible[i + 3] = static_cast<uint8_t>( ( mask >> 3 ) & 1 );
+    }
+#endif
+
+    // Remaining bounding boxes (or all of them if SSE is not available).
+    for ( ; i < count; ++i )
+    {
+        visible[i] = intersects( boundingBoxes[i] ) ? 1 : 0;
+    }
+}
@@ -0,0 +1,187 @@
+#include <WebGPUlib/Device.hpp>
+#include <WebGPUlib/GPUProfiler.hpp>
+#include <WebGPUlib/Queue.hpp>
+
+#include <iostream>
+
+using namespace WebGPUlib;
+
+GPUProfiler::GPUProfiler( WGPUDevice device, uint32_t _maxPassesPerFrame )
+: enabled { wgpuDeviceHasFeature( device, WGPUFeatureName_TimestampQuery ) != 0 }
+, maxPassesPerFrame { _maxPassesPerFrame }
+{
+    if ( !enabled )
+        return;
+
+    // Each pass writes a timestamp at the beginning and at the end of the pass.
+    const uint32_t queryCount = maxPassesPerFrame * 2;
+    const uint64_t bufferSize = queryCount * sizeof( uint64_t );
+
+    for ( auto& frame: frames )
+    {
+        frame.profiler = this;
+
+        WGPUQuerySetDescriptor querySetDesc {};
+        querySetDesc.label = "GPU Profiler Query Set";
+        querySetDesc.type  = WGPUQueryType_Timestamp;
+        querySetDesc.count = queryCount;
+        frame.querySet     = wgpuDeviceCreateQuerySet( device, &querySetDesc );
+
+        WGPUBufferDescriptor resolveBufferDesc {};
+        resolveBufferDesc.label = "GPU Profiler Resolve Buffer";
+        resolveBufferDesc.size  = bufferSize;
+        resolveBufferDesc.usage = WGPUBufferUsage_QueryResolve | WGPUBufferUsage_CopySrc;
+        frame.resolveBuffer     = wgpuDeviceCreateBuffer( device, &resolveBufferDesc );
+
+        WGPUBufferDescriptor readbackBufferDesc {};
+        readbackBufferDesc.label = "GPU Profiler Readback Buffer";
+        readbackBufferDesc.size  = bufferSize;
+        readbackBufferDesc.usage = WGPUBufferUsage_MapRead | WGPUBufferUsage_CopyDst;
+        frame.readbackBuffer     = wgpuDeviceCreateBuffer( device, &readbackBufferDesc );
+
+        frame.passNames.reserve( maxPassesPerFrame );
+    }
+}
+
+GPUProfiler::~GPUProfiler()
+{
+    for ( auto& frame: frames )
+    {
+        if ( frame.querySet )
+            wgpuQuerySetRelease( frame.querySet );
+        if ( frame.resolveBuffer )
+            wgpuBufferRelease( frame.resolveBuffer );
+        if ( frame.readbackBuffer )
+            wgpuBufferRelease( frame.readbackBuffer );
+    }
+}
+
+std::optional<WGPURenderPassTimestampWrites> GPUProfiler::getRenderPassTimestampWrites( const char* passName )
+{
+    auto query = allocateQueries( passName );
+    if ( !query )
+        return std::nullopt;
+
+    WGPURenderPassTimestampWrites timestampWrites {};
+    timestampWrites.querySet                  = frames[currentFrame].querySet;
+    timestampWrites.beginningOfPassWriteIndex = *query;
+    timestampWrites.endOfPassWriteIndex       = *query + 1;
+
+    return timestampWrites;
+}
+
+std::optional<WGPUComputePassTimestampWrites> GPUProfiler::getComputePassTimestampWrites( const char* passName )
+{
+    auto query = allocateQueries( passName );
+    if ( !query )
+        return std::nullopt;
+
+    WGPUComputePassTimestampWrites timestampWrites {};
+    timestampWrites.querySet                  = frames[currentFrame].querySet;
+    timestampWrites.beginningOfPassWriteIndex = *query;
+    timestampWrites.endOfPassWriteIndex       = *query + 1;
+
+    return timestampWrites;
+}
+
+void GPUProfiler::endFrame( const Queue& queue )
+{
+    if ( !enabled )
+        return;
+
+    auto& frame = frames[currentFrame];
+
+    if ( !frame.mapPending && !frame.passNames.empty() )
+    {
+        const uint32_t queryCount = static_cast<uint32_t>( frame.passNames.size() * 2 );
+        const uint64_t size       = queryCount * sizeof( uint64_t );
+
+        // Resolve the queries and copy the results to the readback buffer.
+        WGPUCommandEncoderDescriptor commandEncoderDesc {};
+        commandEncoderDesc.label = "GPU Profiler Command Encoder";
+        WGPUCommandEncoder commandEncoder =
+            wgpuDeviceCreateCommandEncoder( Device::get().getWGPUDevice(), &commandEncoderDesc );
+
+        wgpuCommandEncoderResolveQuerySet( commandEncoder, frame.querySet, 0, queryCount, frame.resolveBuffer, 0 );
+        wgpuCommandEncoderCopyBufferToBuffer( commandEncoder, frame.resolveBuffer, 0, frame.readbackBuffer, 0, size );
+
+        WGPUCommandBuffer commandBuffer = wgpuCommandEncoderFinish( commandEncoder, nullptr );
+        wgpuCommandEncoderRelease( commandEncoder );
+
+        auto wgpuQueue = queue.getWGPUQueue();
+        wgpuQueueSubmit( wgpuQueue, 1, &commandBuffer );
+        wgpuCommandBufferRelease( commandBuffer );
+
+        // The results are processed when the buffer is mapped.
+        frame.frameNumber = frameNumber;
+        frame.mapPending  = true;
+        wgpuBufferMapAsync( frame.readbackBuffer, WGPUMapMode_Read, 0, size, &GPUProfiler::onReadbackMapped, &frame );
+    }
+
+    ++frameNumber;
+    currentFrame = ( currentFrame + 1 ) % FrameCount;
+}
+
+bool GPUProfiler::hasPendingReadbacks() const noexcept
+{
+    for ( auto& frame: frames )
+    {
+        if ( frame.mapPending )
+            return true;
+    }
+
+    return false;
+}
+
+std::optional<uint32_t> GPUProfiler::allocateQueries( const char* passName )
+{
+    if ( !enabled )
+        return std::nullopt;
+
+    auto& frame = frames[currentFrame];
+
+    // Don't wait for the GPU if the results of this frame have not been read back yet.
+    if ( frame.mapPending || frame.passNames.size() >= maxPassesPerFrame )
+        return std::nullopt;
+
+    uint32_t query = static_cast<uint32_t>( frame.passNames.size() * 2 );
+    frame.passNames.emplace_back( passName ? passName : "" );
+
+    return query;
+}
+
+void GPUProfiler::onReadbackMapped( WGPUBufferMapAsyncStatus status, void* userdata )
+{
+    auto& frame    = *static_cast<Frame*>( userdata );
+    auto& profiler = *frame.profiler;
+
+    if ( status == WGPUBufferMapAsyncStatus_Success )
+    {
+        const std::size_t size = frame.passNames.size() * 2 * sizeof( uint64_t );
+        const auto* timestamps =
+            static_cast<const uint64_t*>( wgpuBufferGetConstMappedRange( frame.readbackBuffer, 0, size ) );
+
+        profiler.passTimings.clear();
+
+        for ( std::size_t i = 0; i < frame.passNames.size(); ++i )
+        {
+            const uint64_t begin = timestamps[i * 2 + 0];
+            const uint64_t end   = timestamps[i * 2 + 1];
+
+            // Timestamps are in nanoseconds. Some implementations return non-monotonic values.
+            double milliseconds = end > begin ? static_cast<double>( end - begin ) * 1e-6 : 0.0;
+            profiler.passTimings.push_back( { std::move( frame.passNames[i] ), milliseconds } );
+        }
+
+        profiler.passTimingsFrameNumber = frame.frameNumber;
+
+        wgpuBufferUnmap( frame.readbackBuffer );
+    }
+    else
+    {
+        std::cerr << "ERROR (GPUProfiler::onReadbackMapped): Failed to map readback buffer: " << status << std::endl;
+    }
+
+    frame.passNames.clear();
+    frame.mapPending = false;
+}
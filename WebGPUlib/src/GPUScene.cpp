@@ -0,0 +1,259 @@
+#include <WebGPUlib/ComputeCommandBuffer.hpp>
+#include <WebGPUlib/Device.hpp>
+#include <WebGPUlib/Frustum.hpp>
+#include <WebGPUlib/GPUScene.hpp>
+#include <WebGPUlib/Helpers.hpp>
+#include <WebGPUlib/HiZPyramid.hpp>
+#include <WebGPUlib/IndexBuffer.hpp>
+#include <WebGPUlib/Mesh.hpp>
+#include <WebGPUlib/Queue.hpp>
+#include <WebGPUlib/SceneGraph.hpp>
+#include <WebGPUlib/SceneNode.hpp>
+#include <WebGPUlib/StorageBuffer.hpp>
+#include <WebGPUlib/Texture.hpp>
+#include <WebGPUlib/TextureView.hpp>
+#include <WebGPUlib/UniformBuffer.hpp>
+
+#include <glm/matrix.hpp>
+
+#include <algorithm>
+#include <functional>
+#include <unordered_map>
+
+using namespace WebGPUlib;
+
+// The size of the matrices of a visible instance (the model and inverse-transpose model matrix).
+constexpr uint32_t VisibleInstanceSize = 2 * sizeof( glm::mat4 );
+
+GPUScene::GPUScene()
+{
+    cullInstancesPipelineState = std::make_unique<CullInstancesPipelineState>();
+    parametersBuffer           = Device::get().createUniformBuffer( CullParameters {} );
+}
+
+GPUScene::~GPUScene() = default;
+
+bool GPUScene::update( const SceneNode& root )
+{
+    const auto& rootSceneGraph = *root.getSceneGraph();
+    if ( rootNode == &root && sceneGraph == &rootSceneGraph && sceneGraphVersion == rootSceneGraph.getVersion() )
+        return false;
+
+    rootNode          = &root;
+    sceneGraph        = &rootSceneGraph;
+    sceneGraphVersion = rootSceneGraph.getVersion();
+
+    const auto& meshes                 = sceneGraph->getMeshes();
+    const auto& meshRanges             = sceneGraph->getMeshRanges();
+    const auto& meshWorldBounds        = sceneGraph->getMeshWorldBounds();
+    const auto& worldTransforms        = sceneGraph->getWorldTransforms();
+    const auto& inverseWorldTransforms = sceneGraph->getInverseWorldTransforms();
+
+    // Only the subtree of the root node is drawn. Its nodes and meshes are stored in contiguous ranges.
+    const uint32_t firstNode = root.getIndex();
+    const uint32_t endNode   = sceneGraph->getSubtreeEnds()[firstNode];
+    const uint32_t firstMesh = meshRanges[firstNode].first;
+    const uint32_t endMesh   = meshRanges[endNode - 1].first + meshRanges[endNode - 1].count;
+
+    // One draw for each unique mesh. Meshes without an index buffer can't be drawn with indexed indirect draws.
+    std::vector<Draw> newDraws;
+    for ( uint32_t m = firstMesh; m < endMesh; ++m )
+    {
+        if ( meshes[m]->getIndexBuffer() )
+            newDraws.push_back( { meshes[m], 0, 0, 0 } );
+    }
+
+    // Sort the draws by material, so consecutive draws can skip binding the same material.
+    std::sort( newDraws.begin(), newDraws.end(), []( const Draw& a, const Draw& b ) {
+        const auto materialA = a.mesh->getMaterial().get();
+        const auto materialB = b.mesh->getMaterial().get();
+        return materialA != materialB ? std::less<const Material*> {}( materialA, materialB )
+                                      : std::less<const Mesh*> {}( a.mesh.get(), b.mesh.get() );
+    } );
+    newDraws.erase( std::unique( newDraws.begin(), newDraws.end(),
+                                 []( const Draw& a, const Draw& b ) { return a.mesh == b.mesh; } ),
+                    newDraws.end() );
+
+    std::unordered_map<const Mesh*, uint32_t> drawIndices;
+    for ( uint32_t d = 0; d < newDraws.size(); ++d )
+        drawIndices.emplace( newDraws[d].mesh.get(), d );
+
+    // One instance for each mesh of each node.
+    instances.clear();
+    for ( uint32_t node = firstNode; node < endNode; ++node )
+    {
+        const auto& range = meshRanges[node];
+        for ( uint32_t m = range.first; m < range.first + range.count; ++m )
+        {
+            auto iter = drawIndices.find( meshes[m].get() );
+            if ( iter == drawIndices.end() )
+                continue;
+
+            CullInstance instance {};
+            instance.model     = worldTransforms[node];
+            instance.modelIT   = glm::transpose( inverseWorldTransforms[node] );
+            instance.minBounds = meshWorldBounds[m].min;
+            instance.maxBounds = meshWorldBounds[m].max;
+            instance.drawIndex = iter->second;
+            instances.push_back( instance );
+
+            ++newDraws[iter->second].instanceCount;
+        }
+    }
+
+    instanceCount = static_cast<uint32_t>( instances.size() );
+
+    // If only the transforms have changed, the draws stay the same and only the instances are uploaded.
+    const bool drawsChanged =
+        !std::equal( newDraws.begin(), newDraws.end(), draws.begin(), draws.end(), []( const Draw& a, const Draw& b ) {
+            return a.mesh == b.mesh && a.instanceCount == b.instanceCount;
+        } );
+
+    if ( !drawsChanged )
+    {
+        if ( instanceCount > 0 )
+        {
+            Device::get().getQueue()->writeBuffer( *instanceBuffer, instances.data(),
+                                                   instances.size() * sizeof( CullInstance ) );
+        }
+
+        return false;
+    }
+
+    draws = std::move( newDraws );
+
+    // Assign a region of the visible instance buffer to each draw.
+    std::vector<uint32_t> instanceOffsets;  // In instances, used by the culling shader.
+    uint32_t              instanceOffset   = 0;
+    uint32_t              maxInstanceCount = 0;
+
+    drawArguments.clear();
+    for ( uint32_t d = 0; d < draws.size(); ++d )
+    {
+        auto&       draw        = draws[d];
+        const auto& indexBuffer = draw.mesh->getIndexBuffer();
+
+        draw.indirectOffset = d * sizeof( DrawIndexedIndirectArguments );
+        draw.instanceOffset = instanceOffset;
+
+        drawArguments.push_back( { static_cast<uint32_t>( indexBuffer->getIndexCount() ), 0,
+                                   draw.mesh->getFirstIndex(), draw.mesh->getBaseVertex(), 0 } );
+        instanceOffsets.push_back( instanceOffset / VisibleInstanceSize );
+
+        instanceOffset += draw.instanceCount * VisibleInstanceSize;
+        instanceOffset   = AlignUp( instanceOffset, InstanceOffsetAlignment );
+        maxInstanceCount = std::max( maxInstanceCount, draw.instanceCount );
+    }
+
+    instanceBindingSize = static_cast<uint64_t>( maxInstanceCount ) * VisibleInstanceSize;
+
+    if ( instanceCount == 0 )
+    {
+        instanceBuffer.reset();
+        drawBuffer.reset();
+        visibilityBuffer.reset();
+
+        for ( std::size_t drawSet = 0; drawSet < NumDrawSets; ++drawSet )
+        {
+            indirectBuffers[drawSet].reset();
+            visibleInstanceBuffers[drawSet].reset();
+        }
+
+        return true;
+    }
+
+    // Every draw binds the same range size, so the buffer must extend past the start of the last draw.
+    const uint64_t visibleInstanceBufferSize = draws.back().instanceOffset + instanceBindingSize;
+
+    auto& device   = Device::get();
+    instanceBuffer = device.createStorageBuffer( instances.data(), instances.size(), sizeof( CullInstance ) );
+    drawBuffer     = device.createStorageBuffer( instanceOffsets );
+
+    // Buffers are zero initialized, so all instances start as not visible and are tested in the late phase.
+    visibilityBuffer = device.createStorageBuffer( nullptr, instances.size(), sizeof( uint32_t ) );
+
+    for ( std::size_t drawSet = 0; drawSet < NumDrawSets; ++drawSet )
+    {
+        indirectBuffers[drawSet]        = device.createIndirectBuffer( drawArguments.data(), drawArguments.size(),
+                                                                       sizeof( DrawIndexedIndirectArguments ) );
+        visibleInstanceBuffers[drawSet] = device.createStorageBuffer(
+            nullptr, visibleInstanceBufferSize / VisibleInstanceSize, VisibleInstanceSize );
+    }
+
+    return true;
+}
+
+// Copy the frustum planes to the culling parameters.
+static CullParameters getCullParameters( const Frustum& frustum, CullPhase phase, uint32_t instanceCount )
+{
+    CullParameters parameters {};
+    for ( int plane = 0; plane < Frustum::NumPlanes; ++plane )
+        parameters.planes[plane] = frustum.getPlane( static_cast<Frustum::Plane>( plane ) );
+    parameters.instanceCount = instanceCount;
+    parameters.phase         = phase;
+
+    return parameters;
+}
+
+void GPUScene::cull( const Frustum& frustum )
+{
+    if ( instanceCount == 0 )
+        return;
+
+    // The Hi-Z pyramid is not used, but the binding can't be empty.
+    dispatch( getCullParameters( frustum, CullPhase::Frustum, instanceCount ),
+              *Device::get().getDefaultWhiteTexture()->getView() );
+}
+
+void GPUScene::cullEarly( const Frustum& frustum )
+{
+    if ( instanceCount == 0 )
+        return;
+
+    dispatch( getCullParameters( frustum, CullPhase::Early, instanceCount ),
+              *Device::get().getDefaultWhiteTexture()->getView() );
+}
+
+void GPUScene::cullLate( const Frustum& frustum, const glm::mat4& viewProjection, const HiZPyramid& hiZPyramid )
+{
+    if ( instanceCount == 0 )
+        return;
+
+    auto parameters           = getCullParameters( frustum, CullPhase::Late, instanceCount );
+    parameters.viewProjection = viewProjection;
+    parameters.depthSize      = { static_cast<float>( hiZPyramid.getDepthWidth() ),
+                                  static_cast<float>( hiZPyramid.getDepthHeight() ) };
+    parameters.hiZMipCount    = hiZPyramid.getMipCount();
+
+    dispatch( parameters, *hiZPyramid.getView() );
+}
+
+void GPUScene::dispatch( const CullParameters& parameters, const TextureView& hiZView )
+{
+    const auto  queue          = Device::get().getQueue();
+    const auto  drawSet        = getDrawSet( parameters.phase );
+    const auto& indirectBuffer = indirectBuffers[drawSet];
+
+    queue->writeBuffer( *parametersBuffer, parameters );
+
+    // The culling pass counts the visible instances of each draw, starting from 0.
+    queue->writeBuffer( *indirectBuffer, drawArguments.data(),
+                        drawArguments.size() * sizeof( DrawIndexedIndirectArguments ) );
+
+    const auto commandBuffer = queue->createComputeCommandBuffer(
+        parameters.phase == CullPhase::Late ? "Instance Culling (Late)" : "Instance Culling" );
+
+    commandBuffer->setComputePipeline( *cullInstancesPipelineState );
+
+    commandBuffer->bindBuffer( 0, 0, *parametersBuffer );
+    commandBuffer->bindBuffer( 0, 1, *instanceBuffer );
+    commandBuffer->bindBuffer( 0, 2, *drawBuffer );
+    commandBuffer->bindBuffer( 0, 3, *indirectBuffer );
+    commandBuffer->bindBuffer( 0, 4, *visibleInstanceBuffers[drawSet] );
+    commandBuffer->bindBuffer( 0, 5, *visibilityBuffer );
+    commandBuffer->bindTexture( 0, 6, hiZView );
+
+    commandBuffer->dispatch( DivideByMultiple( instanceCount, CullInstancesPipelineState::GroupSize ) );
+
+    queue->submit( *commandBuffer );
+}
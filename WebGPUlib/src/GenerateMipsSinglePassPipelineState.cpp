@@ -0,0 +1,102 @@
+#include <WebGPUlib/ComputeCommandBuffer.hpp>
+#include <WebGPUlib/Device.hpp>
+#include <WebGPUlib/GenerateMipsSinglePassPipelineState.hpp>
+
+#include <iterator>
+
+using namespace WebGPUlib;
+
+GenerateMipsSinglePassPipelineState::GenerateMipsSinglePassPipelineState()
+{
+    // Load the shader module.
+    const char* shaderCode = {
+#include "../shaders/GenerateMipsSinglePass.wgsl"
+    };
+
+    auto device = Device::get().getWGPUDevice();
+
+    // Load the compute shader module.
+    WGPUShaderModuleWGSLDescriptor shaderCodeDesc {};
+    shaderCodeDesc.chain.next  = nullptr;
+    shaderCodeDesc.chain.sType = WGPUSType_ShaderModuleWGSLDescriptor;
+    shaderCodeDesc.code        = shaderCode;
+
+    WGPUShaderModuleDescriptor shaderModuleDesc {};
+    shaderModuleDesc.nextInChain  = &shaderCodeDesc.chain;
+    shaderModuleDesc.label        = "Generate Mips Single Pass Shader Module";
+    WGPUShaderModule shaderModule = wgpuDeviceCreateShaderModule( device, &shaderModuleDesc );
+
+    // Setup the binding layout for the single pass generate mips compute shader.
+    //@group(0) @binding(0) var<uniform> params : Parameters;
+    //@group(0) @binding(1) var srcMip : texture_2d<f32>;
+    //@group(0) @binding(2-13) var dstMip1-12 : texture_storage_2d<rgba8unorm, write>;
+    //@group(0) @binding(14) var<storage, read_write> counter : Counter;
+    //@group(0) @binding(15) var<storage, read_write> mip6 : array<atomic<u32>>;
+    WGPUBindGroupLayoutEntry bindGroupLayoutEntries[4 + MaxMips] {};
+    bindGroupLayoutEntries[0].binding               = 0;
+    bindGroupLayoutEntries[0].visibility            = WGPUShaderStage_Compute;
+    bindGroupLayoutEntries[0].buffer.type           = WGPUBufferBindingType_Uniform;
+    bindGroupLayoutEntries[0].buffer.minBindingSize = sizeof( SinglePassMips );
+
+    bindGroupLayoutEntries[1].binding               = 1;
+    bindGroupLayoutEntries[1].visibility            = WGPUShaderStage_Compute;
+    bindGroupLayoutEntries[1].texture.sampleType    = WGPUTextureSampleType_UnfilterableFloat;
+    bindGroupLayoutEntries[1].texture.viewDimension = WGPUTextureViewDimension_2D;
+
+    for ( uint32_t i = 2; i < 2 + MaxMips; ++i )
+    {
+        bindGroupLayoutEntries[i].binding                      = i;
+        bindGroupLayoutEntries[i].visibility                   = WGPUShaderStage_Compute;
+        bindGroupLayoutEntries[i].storageTexture.access        = WGPUStorageTextureAccess_WriteOnly;
+        bindGroupLayoutEntries[i].storageTexture.format        = WGPUTextureFormat_RGBA8Unorm;
+        bindGroupLayoutEntries[i].storageTexture.viewDimension = WGPUTextureViewDimension_2D;
+    }
+
+    bindGroupLayoutEntries[2 + MaxMips].binding               = 2 + MaxMips;
+    bindGroupLayoutEntries[2 + MaxMips].visibility            = WGPUShaderStage_Compute;
+    bindGroupLayoutEntries[2 + MaxMips].buffer.type           = WGPUBufferBindingType_Storage;
+    bindGroupLayoutEntries[2 + MaxMips].buffer.minBindingSize = sizeof( uint32_t );
+
+    bindGroupLayoutEntries[3 + MaxMips].binding               = 3 + MaxMips;
+    bindGroupLayoutEntries[3 + MaxMips].visibility            = WGPUShaderStage_Compute;
+    bindGroupLayoutEntries[3 + MaxMips].buffer.type           = WGPUBufferBindingType_Storage;
+    bindGroupLayoutEntries[3 + MaxMips].buffer.minBindingSize = Mip6BufferSize;
+
+    WGPUBindGroupLayoutDescriptor bindGroupLayoutDesc {};
+    bindGroupLayoutDesc.label      = "Generate Mips Single Pass Bind Group Layout";
+    bindGroupLayoutDesc.entryCount = std::size( bindGroupLayoutEntries );
+    bindGroupLayoutDesc.entries    = bindGroupLayoutEntries;
+    bindGroupLayout                = wgpuDeviceCreateBindGroupLayout( device, &bindGroupLayoutDesc );
+
+    // Setup the pipeline layout.
+    WGPUPipelineLayoutDescriptor pipelineLayoutDesc {};
+    pipelineLayoutDesc.label                = "Generate Mips Single Pass Pipeline Layout";
+    pipelineLayoutDesc.bindGroupLayoutCount = 1;
+    pipelineLayoutDesc.bindGroupLayouts     = &bindGroupLayout;
+    WGPUPipelineLayout pipelineLayout       = wgpuDeviceCreatePipelineLayout( device, &pipelineLayoutDesc );
+
+    // Setup the pipeline state.
+    WGPUComputePipelineDescriptor pipelineDesc {};
+    pipelineDesc.label              = "Generate Mips Single Pass Pipeline";
+    pipelineDesc.layout             = pipelineLayout;
+    pipelineDesc.compute.module     = shaderModule;
+    pipelineDesc.compute.entryPoint = "main";
+    pipeline                        = wgpuDeviceCreateComputePipeline( device, &pipelineDesc );
+
+    // We are done with the shader module.
+    wgpuShaderModuleRelease( shaderModule );
+    // We are done with the pipeline layout.
+    wgpuPipelineLayoutRelease( pipelineLayout );
+}
+
+GenerateMipsSinglePassPipelineState::~GenerateMipsSinglePassPipelineState()
+{
+    if ( bindGroupLayout )
+        wgpuBindGroupLayoutRelease( bindGroupLayout );
+}
+
+void GenerateMipsSinglePassPipelineState::bind( ComputeCommandBuffer& commandBuffer )
+{
+    auto passEncoder = commandBuffer.getWGPUPassEncoder();
+    wgpuComputePassEncoderSetPipeline( passEncoder, pipeline );
+}
@@ -3,6 +3,7 @@
 #include <WebGPUlib/GraphicsPipelineState.hpp>
 #include <WebGPUlib/IndexBuffer.hpp>
 #include <WebGPUlib/Mesh.hpp>
+#include <WebGPUlib/RenderBundle.hpp>
 #include <WebGPUlib/VertexBuffer.hpp>
 
 #include <iostream>
@@ -29,7 +30,11 @@ void GraphicsCommandBuffer::setBindGroup( uint32_t groupIndex, const BindGroup&
     {
         auto bindGroupLayout = currentPipelineState->getWGPUBindGroupLayout( groupIndex );
         auto bindGroup       = _bindGroup.getWGPUBindGroup( bindGroupLayout );
-        wgpuRenderPassEncoderSetBindGroup( passEncoder, groupIndex, bindGroup, 0, nullptr );
+        auto& dynamicOffsets = _bindGroup.getDynamicOffsets();
+
+        if ( updateBindGroupState( groupIndex, bindGroup, dynamicOffsets ) )
+            wgpuRenderPassEncoderSetBindGroup( passEncoder, groupIndex, bindGroup, dynamicOffsets.size(),
+                                               dynamicOffsets.data() );
     }
     else
     {
@@ -41,53 +46,154 @@ void GraphicsCommandBuffer::setBindGroup( uint32_t groupIndex, const BindGroup&
 
 void GraphicsCommandBuffer::setGraphicsPipeline( GraphicsPipelineState& pipeline )
 {
+    if ( currentPipelineState == &pipeline && currentPipeline == pipeline.getWGPURenderPipeline() )
+    {
+        ++statistics.pipelinesSkipped;
+        return;
+    }
+
     // Keep track of the currently bound pipeline state.
     currentPipelineState = &pipeline;
+    currentPipeline      = pipeline.getWGPURenderPipeline();
 
     pipeline.bind( *this );
+    ++statistics.pipelinesSet;
+
+    // The bind groups are resolved with the bind group layouts of the pipeline.
+    invalidateBindGroups();
 }
 
-void GraphicsCommandBuffer::draw( const Mesh& mesh )
+void GraphicsCommandBuffer::setVertexBuffer( uint32_t slot, const BufferBinding& binding )
 {
-    commitBindGroups();
+    if ( currentVertexBuffers.size() <= slot )
+        currentVertexBuffers.resize( slot + 1 );
 
-    auto vertexBuffers = mesh.getVertexBuffers();
-    auto indexBuffer   = mesh.getIndexBuffer();
+    if ( currentVertexBuffers[slot] == binding )
+    {
+        ++statistics.vertexBuffersSkipped;
+        return;
+    }
+
+    wgpuRenderPassEncoderSetVertexBuffer( passEncoder, slot, binding.buffer, binding.offset, binding.size );
+    currentVertexBuffers[slot] = binding;
+    ++statistics.vertexBuffersSet;
+}
+
+void GraphicsCommandBuffer::setIndexBuffer( const BufferBinding& binding, WGPUIndexFormat indexFormat )
+{
+    if ( currentIndexBuffer == binding && currentIndexFormat == indexFormat )
+    {
+        ++statistics.indexBuffersSkipped;
+        return;
+    }
+
+    wgpuRenderPassEncoderSetIndexBuffer( passEncoder, binding.buffer, indexFormat, binding.offset, binding.size );
+    currentIndexBuffer = binding;
+    currentIndexFormat = indexFormat;
+    ++statistics.indexBuffersSet;
+}
+
+void GraphicsCommandBuffer::setMeshBuffers( const Mesh& mesh )
+{
+    auto& vertexBuffers = mesh.getVertexBuffers();
+    auto& indexBuffer   = mesh.getIndexBuffer();
+
+    // Meshes that share an arena bind the whole arena, so consecutive draws do not need to rebind the buffer.
+    bool useBaseVertex = mesh.usesBaseVertex();
 
     for ( uint32_t i = 0; i < vertexBuffers.size(); ++i )
     {
         if ( auto& vertexBuffer = vertexBuffers[i] )
         {
-            wgpuRenderPassEncoderSetVertexBuffer( passEncoder, i, vertexBuffer->getWGPUBuffer(), 0,
-                                                  vertexBuffer->getSize() );
+            if ( useBaseVertex )
+                setVertexBuffer( i, { vertexBuffer->getWGPUBuffer(), 0, WGPU_WHOLE_SIZE } );
+            else
+                setVertexBuffer( i,
+                                 { vertexBuffer->getWGPUBuffer(), vertexBuffer->getOffset(), vertexBuffer->getSize() } );
         }
     }
 
     if ( indexBuffer )
     {
-        WGPUIndexFormat indexFormat = WGPUIndexFormat_Undefined;
-        switch ( indexBuffer->getIndexStride() )
-        {
-        case 2:
-            indexFormat = WGPUIndexFormat_Uint16;
-            break;
-        case 4:
-            indexFormat = WGPUIndexFormat_Uint32;
-            break;
-        }
+        if ( indexBuffer->getArena() )
+            setIndexBuffer( { indexBuffer->getWGPUBuffer(), 0, WGPU_WHOLE_SIZE }, indexBuffer->getIndexFormat() );
+        else
+            setIndexBuffer( { indexBuffer->getWGPUBuffer(), indexBuffer->getOffset(), indexBuffer->getSize() },
+                            indexBuffer->getIndexFormat() );
+    }
+}
+
+void GraphicsCommandBuffer::draw( const Mesh& mesh, uint32_t instanceCount, uint32_t firstInstance )
+{
+    commitBindGroups();
+    ++statistics.drawCount;
 
-        wgpuRenderPassEncoderSetIndexBuffer( passEncoder, indexBuffer->getWGPUBuffer(), indexFormat, 0,
-                                             indexBuffer->getSize() );
-        wgpuRenderPassEncoderDrawIndexed( passEncoder, static_cast<uint32_t>( indexBuffer->getIndexCount() ), 1, 0, 0,
-                                          0 );
+    setMeshBuffers( mesh );
+
+    auto& vertexBuffers = mesh.getVertexBuffers();
+    auto& indexBuffer   = mesh.getIndexBuffer();
+
+    if ( indexBuffer )
+    {
+        wgpuRenderPassEncoderDrawIndexed( passEncoder, static_cast<uint32_t>( indexBuffer->getIndexCount() ),
+                                          instanceCount, mesh.getFirstIndex(), mesh.getBaseVertex(), firstInstance );
     }
-    else
+    else if ( !vertexBuffers.empty() && vertexBuffers[0] )
     {
-        if ( auto& vertexBuffer = vertexBuffers[0] )
-        {
-            wgpuRenderPassEncoderDraw( passEncoder, static_cast<uint32_t>( vertexBuffer->getVertexCount() ), 1, 0, 0 );
-        }
+        wgpuRenderPassEncoderDraw( passEncoder, static_cast<uint32_t>( vertexBuffers[0]->getVertexCount() ),
+                                   instanceCount, static_cast<uint32_t>( mesh.getBaseVertex() ), firstInstance );
+    }
+}
+
+void GraphicsCommandBuffer::drawIndirect( const Mesh& mesh, const Buffer& indirectBuffer, uint64_t indirectOffset )
+{
+    if ( !mesh.getIndexBuffer() )
+    {
+        std::cerr << "ERROR (GraphicsCommandBuffer::drawIndirect): Only indexed meshes can be drawn indirectly."
+                  << std::endl;
+        return;
     }
+
+    commitBindGroups();
+    ++statistics.drawCount;
+
+    setMeshBuffers( mesh );
+
+    wgpuRenderPassEncoderDrawIndexedIndirect( passEncoder, indirectBuffer.getWGPUBuffer(),
+                                              indirectBuffer.getOffset() + indirectOffset );
+}
+
+void GraphicsCommandBuffer::executeBundle( const RenderBundle& bundle )
+{
+    WGPURenderBundle renderBundle = bundle.getWGPURenderBundle();
+    wgpuRenderPassEncoderExecuteBundles( passEncoder, 1, &renderBundle );
+
+    resetState();
+}
+
+void GraphicsCommandBuffer::executeBundles( const std::vector<std::shared_ptr<RenderBundle>>& bundles )
+{
+    if ( bundles.empty() )
+        return;
+
+    std::vector<WGPURenderBundle> renderBundles;
+    renderBundles.reserve( bundles.size() );
+    for ( const auto& bundle: bundles )
+        renderBundles.push_back( bundle->getWGPURenderBundle() );
+
+    wgpuRenderPassEncoderExecuteBundles( passEncoder, renderBundles.size(), renderBundles.data() );
+
+    resetState();
+}
+
+void GraphicsCommandBuffer::resetState()
+{
+    currentPipelineState = nullptr;
+    currentPipeline      = nullptr;
+    resetBindGroupState();
+    currentVertexBuffers.clear();
+    currentIndexBuffer = {};
+    currentIndexFormat = WGPUIndexFormat_Undefined;
 }
 
 WGPUCommandBuffer GraphicsCommandBuffer::finish()
@@ -95,11 +201,14 @@ WGPUCommandBuffer GraphicsCommandBuffer::finish()
     wgpuRenderPassEncoderEnd( passEncoder );
 
     currentPipelineState = nullptr;
+    currentPipeline      = nullptr;
+    resetBindGroupState();
+    currentVertexBuffers.clear();
+    currentIndexBuffer = {};
+    currentIndexFormat = WGPUIndexFormat_Undefined;
 
     WGPUCommandBufferDescriptor commandBufferDescriptor {};
     commandBufferDescriptor.label = "Graphics Command Buffer";
 
-    reset();
-
     return wgpuCommandEncoderFinish( commandEncoder, &commandBufferDescriptor );
 }
\ No newline at end of file
@@ -0,0 +1,107 @@
+#include <WebGPUlib/ComputeCommandBuffer.hpp>
+#include <WebGPUlib/Device.hpp>
+#include <WebGPUlib/HiZPipelineState.hpp>
+
+#include <iterator>
+
+using namespace WebGPUlib;
+
+HiZPipelineState::HiZPipelineState( Source _source )
+: source { _source }
+{
+    // Load the shader module.
+    const char* shaderCode = {
+#include "../shaders/HiZ.wgsl"
+    };
+
+    auto device = Device::get().getWGPUDevice();
+
+    // Load the compute shader module.
+    WGPUShaderModuleWGSLDescriptor shaderCodeDesc {};
+    shaderCodeDesc.chain.next  = nullptr;
+    shaderCodeDesc.chain.sType = WGPUSType_ShaderModuleWGSLDescriptor;
+    shaderCodeDesc.code        = shaderCode;
+
+    WGPUShaderModuleDescriptor shaderModuleDesc {};
+    shaderModuleDesc.nextInChain  = &shaderCodeDesc.chain;
+    shaderModuleDesc.label        = "Hi-Z Shader Module";
+    WGPUShaderModule shaderModule = wgpuDeviceCreateShaderModule( device, &shaderModuleDesc );
+
+    // Setup the binding layout for the Hi-Z compute shader.
+    //@group(0) @binding(0) var<uniform> params : Parameters;
+    //@group(0) @binding(1) var dstMip : texture_storage_2d<rg32float, write>;
+    //@group(0) @binding(2) var srcDepth : texture_depth_2d;
+    //@group(0) @binding(2) var srcDepthMultisampled : texture_depth_multisampled_2d;
+    //@group(0) @binding(2) var srcMip : texture_2d<f32>;
+    WGPUBindGroupLayoutEntry bindGroupLayoutEntries[3] {};
+    bindGroupLayoutEntries[0].binding               = 0;
+    bindGroupLayoutEntries[0].visibility            = WGPUShaderStage_Compute;
+    bindGroupLayoutEntries[0].buffer.type           = WGPUBufferBindingType_Uniform;
+    bindGroupLayoutEntries[0].buffer.minBindingSize = sizeof( HiZParameters );
+
+    bindGroupLayoutEntries[1].binding                      = 1;
+    bindGroupLayoutEntries[1].visibility                   = WGPUShaderStage_Compute;
+    bindGroupLayoutEntries[1].storageTexture.access        = WGPUStorageTextureAccess_WriteOnly;
+    bindGroupLayoutEntries[1].storageTexture.format        = Format;
+    bindGroupLayoutEntries[1].storageTexture.viewDimension = WGPUTextureViewDimension_2D;
+
+    bindGroupLayoutEntries[2].binding               = 2;
+    bindGroupLayoutEntries[2].visibility            = WGPUShaderStage_Compute;
+    bindGroupLayoutEntries[2].texture.viewDimension = WGPUTextureViewDimension_2D;
+
+    const char* entryPoint = nullptr;
+    switch ( source )
+    {
+    case Source::Depth:
+        bindGroupLayoutEntries[2].texture.sampleType = WGPUTextureSampleType_Depth;
+        entryPoint                                   = "downsampleDepth";
+        break;
+    case Source::DepthMultisampled:
+        bindGroupLayoutEntries[2].texture.sampleType   = WGPUTextureSampleType_Depth;
+        bindGroupLayoutEntries[2].texture.multisampled = true;
+        entryPoint                                     = "downsampleDepthMultisampled";
+        break;
+    default:
+        bindGroupLayoutEntries[2].texture.sampleType = WGPUTextureSampleType_UnfilterableFloat;
+        entryPoint                                   = "downsampleHiZ";
+        break;
+    }
+
+    WGPUBindGroupLayoutDescriptor bindGroupLayoutDesc {};
+    bindGroupLayoutDesc.label      = "Hi-Z Bind Group Layout";
+    bindGroupLayoutDesc.entryCount = std::size( bindGroupLayoutEntries );
+    bindGroupLayoutDesc.entries    = bindGroupLayoutEntries;
+    bindGroupLayout                = wgpuDeviceCreateBindGroupLayout( device, &bindGroupLayoutDesc );
+
+    // Setup the pipeline layout.
+    WGPUPipelineLayoutDescriptor pipelineLayoutDesc {};
+    pipelineLayoutDesc.label                = "Hi-Z Pipeline Layout";
+    pipelineLayoutDesc.bindGroupLayoutCount = 1;
+    pipelineLayoutDesc.bindGroupLayouts     = &bindGroupLayout;
+    WGPUPipelineLayout pipelineLayout       = wgpuDeviceCreatePipelineLayout( device, &pipelineLayoutDesc );
+
+    // Setup the pipeline state.
+    WGPUComputePipelineDescriptor pipelineDesc {};
+    pipelineDesc.label              = "Hi-Z Pipeline";
+    pipelineDesc.layout             = pipelineLayout;
+    pipelineDesc.compute.module     = shaderModule;
+    pipelineDesc.compute.entryPoint = entryPoint;
+    pipeline                        = wgpuDeviceCreateComputePipeline( device, &pipelineDesc );
+
+    // We are done with the shader module.
+    wgpuShaderModuleRelease( shaderModule );
+    // We are done with the pipeline layout.
+    wgpuPipelineLayoutRelease( pipelineLayout );
+}
+
+HiZPipelineState::~HiZPipelineState()
+{
+    if ( bindGroupLayout )
+        wgpuBindGroupLayoutRelease( bindGroupLayout );
+}
+
+void HiZPipelineState::bind( ComputeCommandBuffer& commandBuffer )
+{
+    auto passEncoder = commandBuffer.getWGPUPassEncoder();
+    wgpuComputePassEncoderSetPipeline( passEncoder, pipeline );
+}
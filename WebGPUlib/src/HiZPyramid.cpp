@@ -0,0 +1,134 @@
+#include <WebGPUlib/ComputeCommandBuffer.hpp>
+#include <WebGPUlib/Device.hpp>
+#include <WebGPUlib/Helpers.hpp>
+#include <WebGPUlib/HiZPyramid.hpp>
+#include <WebGPUlib/Queue.hpp>
+#include <WebGPUlib/Texture.hpp>
+#include <WebGPUlib/TextureView.hpp>
+#include <WebGPUlib/UniformBuffer.hpp>
+
+#include <algorithm>
+#include <cstring>
+
+using namespace WebGPUlib;
+
+HiZPyramid::HiZPyramid()  = default;
+HiZPyramid::~HiZPyramid() = default;
+
+HiZPipelineState& HiZPyramid::getPipelineState( HiZPipelineState::Source source )
+{
+    auto& pipelineState = pipelineStates[static_cast<std::size_t>( source )];
+    if ( !pipelineState )
+        pipelineState = std::make_unique<HiZPipelineState>( source );
+
+    return *pipelineState;
+}
+
+void HiZPyramid::create( uint32_t _depthWidth, uint32_t _depthHeight )
+{
+    depthWidth  = _depthWidth;
+    depthHeight = _depthHeight;
+
+    const uint32_t width  = std::max( depthWidth / 2, 1u );
+    const uint32_t height = std::max( depthHeight / 2, 1u );
+
+    uint32_t mipCount = 1;
+    while ( ( std::max( width, height ) >> mipCount ) > 0 )
+        ++mipCount;
+
+    WGPUTextureFormat format = HiZPipelineState::Format;
+
+    WGPUTextureDescriptor textureDesc {};
+    textureDesc.label           = "Hi-Z Pyramid";
+    textureDesc.usage           = WGPUTextureUsage_StorageBinding | WGPUTextureUsage_TextureBinding;
+    textureDesc.dimension       = WGPUTextureDimension_2D;
+    textureDesc.size            = { width, height, 1 };
+    textureDesc.format          = format;
+    textureDesc.mipLevelCount   = mipCount;
+    textureDesc.sampleCount     = 1;
+    textureDesc.viewFormatCount = 1;
+    textureDesc.viewFormats     = &format;
+
+    texture = Device::get().createTexture( textureDesc );
+    view    = texture->getView();
+
+    mipViews.clear();
+    for ( uint32_t mip = 0; mip < mipCount; ++mip )
+    {
+        WGPUTextureViewDescriptor mipViewDesc {};
+        mipViewDesc.label           = "Hi-Z Pyramid Mip";
+        mipViewDesc.format          = format;
+        mipViewDesc.dimension       = WGPUTextureViewDimension_2D;
+        mipViewDesc.baseMipLevel    = mip;
+        mipViewDesc.mipLevelCount   = 1;
+        mipViewDesc.baseArrayLayer  = 0;
+        mipViewDesc.arrayLayerCount = 1;
+        mipViewDesc.aspect          = WGPUTextureAspect_All;
+        mipViews.push_back( texture->getView( &mipViewDesc ) );
+    }
+
+    parametersBuffer = Device::get().createUniformBuffer( nullptr, mipCount * ParameterStride );
+
+    // The size of the mips only changes when the pyramid is created.
+    std::vector<uint8_t> parameterData( mipCount * ParameterStride );
+
+    HiZParameters parameters {};
+    parameters.srcWidth  = depthWidth;
+    parameters.srcHeight = depthHeight;
+    for ( uint32_t mip = 0; mip < mipCount; ++mip )
+    {
+        parameters.dstWidth  = std::max( parameters.srcWidth / 2, 1u );
+        parameters.dstHeight = std::max( parameters.srcHeight / 2, 1u );
+
+        std::memcpy( parameterData.data() + mip * ParameterStride, &parameters, sizeof( HiZParameters ) );
+
+        parameters.srcWidth  = parameters.dstWidth;
+        parameters.srcHeight = parameters.dstHeight;
+    }
+
+    Device::get().getQueue()->writeBuffer( *parametersBuffer, parameterData.data(), parameterData.size() );
+}
+
+void HiZPyramid::build( Texture& depthTexture )
+{
+    const auto depthDesc = depthTexture.getWGPUTextureDescriptor();
+
+    if ( !texture || depthDesc.size.width != depthWidth || depthDesc.size.height != depthHeight )
+        create( depthDesc.size.width, depthDesc.size.height );
+
+    WGPUTextureViewDescriptor depthViewDesc {};
+    depthViewDesc.label           = "Hi-Z Depth Source";
+    depthViewDesc.format          = depthDesc.format;
+    depthViewDesc.dimension       = WGPUTextureViewDimension_2D;
+    depthViewDesc.baseMipLevel    = 0;
+    depthViewDesc.mipLevelCount   = 1;
+    depthViewDesc.baseArrayLayer  = 0;
+    depthViewDesc.arrayLayerCount = 1;
+    depthViewDesc.aspect          = WGPUTextureAspect_DepthOnly;
+    auto depthView                = depthTexture.getView( &depthViewDesc );
+
+    const auto depthSource =
+        depthDesc.sampleCount > 1 ? HiZPipelineState::Source::DepthMultisampled : HiZPipelineState::Source::Depth;
+
+    const auto queue         = Device::get().getQueue();
+    const auto commandBuffer = queue->createComputeCommandBuffer( "Hi-Z" );
+
+    // Each mip is downsampled from the previous mip (or the depth texture) with a separate dispatch.
+    uint32_t width  = depthWidth;
+    uint32_t height = depthHeight;
+    for ( uint32_t mip = 0; mip < getMipCount(); ++mip )
+    {
+        width  = std::max( width / 2, 1u );
+        height = std::max( height / 2, 1u );
+
+        commandBuffer->setComputePipeline( getPipelineState( mip == 0 ? depthSource : HiZPipelineState::Source::HiZ ) );
+
+        commandBuffer->bindBuffer( 0, 0, *parametersBuffer, mip * ParameterStride, sizeof( HiZParameters ) );
+        commandBuffer->bindTexture( 0, 1, *mipViews[mip] );
+        commandBuffer->bindTexture( 0, 2, mip == 0 ? *depthView : *mipViews[mip - 1] );
+
+        commandBuffer->dispatch( DivideByMultiple( width, 8 ), DivideByMultiple( height, 8 ) );
+    }
+
+    queue->submit( *commandBuffer );
+}
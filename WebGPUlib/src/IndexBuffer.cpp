@@ -1,11 +1,21 @@
+#include <WebGPUlib/BufferArena.hpp>
 #include <WebGPUlib/IndexBuffer.hpp>
 
 #include <utility>
 
 using namespace WebGPUlib;
 
-IndexBuffer::IndexBuffer( WGPUBuffer&& _buffer, std::size_t _indexCount, std::size_t _indexStride )
-: Buffer( std::move( _buffer ) )  // NOLINT(performance-move-const-arg)
+IndexBuffer::IndexBuffer( WGPUBuffer&& _buffer, std::size_t _indexCount, std::size_t _indexStride,
+                          std::shared_ptr<BufferArena> _arena, uint64_t _offset )
+: Buffer( std::move( _buffer ), _offset )  // NOLINT(performance-move-const-arg)
 , indexCount( _indexCount )
 , indexStride( _indexStride )
-{}
\ No newline at end of file
+, arena( std::move( _arena ) )
+{}
+
+IndexBuffer::~IndexBuffer()
+{
+    // Return the range to the arena.
+    if ( arena )
+        arena->free( getOffset(), getSize() );
+}
\ No newline at end of file
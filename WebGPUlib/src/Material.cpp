@@ -15,6 +15,7 @@ const glm::vec4& Material::getDiffuse() const noexcept
 void Material::setDiffuse( const glm::vec4& diffuse ) noexcept
 {
     properties->diffuse = diffuse;
+    ++version;
 }
 
 const glm::vec4& Material::getSpecular() const noexcept
@@ -25,6 +26,7 @@ const glm::vec4& Material::getSpecular() const noexcept
 void Material::setSpecular( const glm::vec4& specular ) noexcept
 {
     properties->specular = specular;
+    ++version;
 }
 
 const glm::vec4& Material::getEmissive() const noexcept
@@ -35,6 +37,7 @@ const glm::vec4& Material::getEmissive() const noexcept
 void Material::setEmissive( const glm::vec4& emissive ) noexcept
 {
     properties->emissive = emissive;
+    ++version;
 }
 
 const glm::vec4& Material::getAmbient() const noexcept
@@ -45,6 +48,7 @@ const glm::vec4& Material::getAmbient() const noexcept
 void Material::setAmbient( const glm::vec4& ambient ) noexcept
 {
     properties->ambient = ambient;
+    ++version;
 }
 
 const glm::vec4& Material::getReflectance() const noexcept
@@ -55,6 +59,7 @@ const glm::vec4& Material::getReflectance() const noexcept
 void Material::setReflectance( const glm::vec4& reflectance ) noexcept
 {
     properties->reflectance = reflectance;
+    ++version;
 }
 
 float Material::getOpacity() const noexcept
@@ -65,6 +70,7 @@ float Material::getOpacity() const noexcept
 void Material::setOpacity( float opacity ) noexcept
 {
     properties->opacity = opacity;
+    ++version;
 }
 
 float Material::getSpecularPower() const noexcept
@@ -75,6 +81,7 @@ float Material::getSpecularPower() const noexcept
 void Material::setSpecularPower( float specularPower ) noexcept
 {
     properties->specularPower = specularPower;
+    ++version;
 }
 
 float Material::getIndexOfRefraction() const noexcept
@@ -85,6 +92,7 @@ float Material::getIndexOfRefraction() const noexcept
 void Material::setIndexOfRefraction( float indexOfRefraction ) noexcept
 {
     properties->indexOfRefraction = indexOfRefraction;
+    ++version;
 }
 
 float Material::getBumpIntensity() const noexcept
@@ -95,6 +103,7 @@ float Material::getBumpIntensity() const noexcept
 void Material::setBumpIntensity( float bumpIntensity ) noexcept
 {
     properties->bumpIntensity = bumpIntensity;
+    ++version;
 }
 
 std::shared_ptr<Texture> Material::getTexture( TextureSlot slot ) const
@@ -139,6 +148,8 @@ void Material::setTexture( TextureSlot slot, std::shared_ptr<Texture> texture )
     case TextureSlot::NumTextureSlots:
         break;
     }
+
+    ++version;
 }
 
 bool Material::isTransparent() const noexcept
@@ -154,5 +165,6 @@ const MaterialProperties& Material::getProperties() const noexcept
 void Material::setProperties( const MaterialProperties& _properties ) noexcept
 {
     *properties = _properties;
+    ++version;
 }
 
@@ -1,4 +1,6 @@
+#include <WebGPUlib/IndexBuffer.hpp>
 #include <WebGPUlib/Mesh.hpp>
+#include <WebGPUlib/VertexBuffer.hpp>
 
 #include <utility>
 
@@ -36,7 +38,7 @@ void Mesh::setIndexBuffer( std::shared_ptr<IndexBuffer> _indexBuffer )
     indexBuffer = std::move( _indexBuffer );
 }
 
-std::shared_ptr<IndexBuffer> Mesh::getIndexBuffer() const
+const std::shared_ptr<IndexBuffer>& Mesh::getIndexBuffer() const
 {
     return indexBuffer;
 }
@@ -49,4 +51,35 @@ void Mesh::setMaterial( std::shared_ptr<Material> _material )
 std::shared_ptr<Material> Mesh::getMaterial() const
 {
     return material;
+}
+
+void Mesh::setBoundingBox( const BoundingBox& _boundingBox )
+{
+    boundingBox = _boundingBox;
+}
+
+const BoundingBox& Mesh::getBoundingBox() const
+{
+    return boundingBox;
+}
+
+bool Mesh::usesBaseVertex() const
+{
+    return vertexBuffers.size() == 1 && vertexBuffers[0] && vertexBuffers[0]->getArena();
+}
+
+int32_t Mesh::getBaseVertex() const
+{
+    if ( !usesBaseVertex() )
+        return 0;
+
+    return static_cast<int32_t>( vertexBuffers[0]->getOffset() / vertexBuffers[0]->getVertexStride() );
+}
+
+uint32_t Mesh::getFirstIndex() const
+{
+    if ( !indexBuffer || !indexBuffer->getArena() )
+        return 0;
+
+    return static_cast<uint32_t>( indexBuffer->getOffset() / indexBuffer->getIndexStride() );
 }
\ No newline at end of file
@@ -0,0 +1,375 @@
+#include <WebGPUlib/MeshOptimizer.hpp>
+
+#include <glm/geometric.hpp>
+#include <glm/vec3.hpp>
+
+#include <algorithm>
+#include <cassert>
+#include <numeric>
+
+using namespace WebGPUlib;
+
+// A FIFO vertex cache that uses timestamps, so it can be flushed in constant time.
+// A vertex is in the cache if fewer than cacheSize vertices have been added since the vertex was added.
+class VertexCache
+{
+public:
+    VertexCache( std::size_t vertexCount, uint32_t cacheSize )
+    : cacheTime( vertexCount, 0 )
+    , cacheSize { cacheSize }
+    , time { cacheSize + 1 }
+    {}
+
+    // Returns true if the vertex was not in the cache.
+    bool access( uint32_t vertex )
+    {
+        if ( time - cacheTime[vertex] > cacheSize )
+        {
+            cacheTime[vertex] = time++;
+            return true;
+        }
+
+        return false;
+    }
+
+    void flush()
+    {
+        time += cacheSize + 1;
+    }
+
+private:
+    std::vector<uint32_t> cacheTime;
+    uint32_t              cacheSize;
+    uint32_t              time;
+};
+
+static glm::vec3 getPosition( const void* positions, std::size_t positionStride, uint32_t vertex )
+{
+    const auto* p = reinterpret_cast<const float*>( static_cast<const uint8_t*>( positions ) + vertex * positionStride );
+    return { p[0], p[1], p[2] };
+}
+
+VertexCacheStatistics WebGPUlib::analyzeVertexCache( const std::vector<uint32_t>& indices, std::size_t vertexCount,
+                                                     uint32_t cacheSize )
+{
+    VertexCacheStatistics statistics;
+    statistics.triangleCount = indices.size() / 3;
+
+    VertexCache       cache { vertexCount, cacheSize };
+    std::vector<bool> referenced( vertexCount, false );
+
+    for ( auto index: indices )
+    {
+        assert( index < vertexCount );
+
+        if ( cache.access( index ) )
+            ++statistics.transformCount;
+
+        if ( !referenced[index] )
+        {
+            referenced[index] = true;
+            ++statistics.vertexCount;
+        }
+    }
+
+    return statistics;
+}
+
+std::vector<uint32_t> WebGPUlib::optimizeVertexCache( std::vector<uint32_t>& indices, std::size_t vertexCount,
+                                                      uint32_t cacheSize )
+{
+    const std::size_t     triangleCount = indices.size() / 3;
+    std::vector<uint32_t> clusters;
+
+    if ( triangleCount == 0 )
+        return clusters;
+
+    // Build the vertex to triangle adjacency.
+    std::vector<uint32_t> liveTriangles( vertexCount, 0 );
+    for ( auto index: indices )
+        ++liveTriangles[index];
+
+    std::vector<uint32_t> adjacencyOffsets( vertexCount + 1, 0 );
+    std::partial_sum( liveTriangles.begin(), liveTriangles.end(), adjacencyOffsets.begin() + 1 );
+
+    std::vector<uint32_t> adjacency( triangleCount * 3 );
+    std::vector<uint32_t> fill( adjacencyOffsets.begin(), adjacencyOffsets.end() - 1 );
+    for ( uint32_t t = 0; t < triangleCount; ++t )
+    {
+        for ( uint32_t k = 0; k < 3; ++k )
+            adjacency[fill[indices[t * 3 + k]]++] = t;
+    }
+
+    std::vector<uint32_t> cacheTime( vertexCount, 0 );
+    std::vector<bool>     emitted( triangleCount, false );
+    std::vector<uint32_t> deadEnds;
+    std::vector<uint32_t> candidates;
+    std::vector<uint32_t> result;
+    result.reserve( indices.size() );
+
+    uint32_t    time   = cacheSize + 1;
+    std::size_t cursor = 0;
+    int64_t     fan    = indices[0];
+
+    clusters.push_back( 0 );
+
+    while ( fan >= 0 )
+    {
+        candidates.clear();
+
+        // Emit all triangles around the fanning vertex.
+        for ( uint32_t a = adjacencyOffsets[fan]; a < adjacencyOffsets[fan + 1]; ++a )
+        {
+            const uint32_t t = adjacency[a];
+            if ( emitted[t] )
+                continue;
+
+            for ( uint32_t k = 0; k < 3; ++k )
+            {
+                const uint32_t v = indices[t * 3 + k];
+                result.push_back( v );
+                deadEnds.push_back( v );
+                candidates.push_back( v );
+                --liveTriangles[v];
+
+                if ( time - cacheTime[v] > cacheSize )
+                    cacheTime[v] = time++;
+            }
+
+            emitted[t] = true;
+        }
+
+        // Pick the candidate that is still in the cache after its remaining triangles are emitted,
+        // preferring the vertex that entered the cache first.
+        fan                = -1;
+        int64_t bestWeight = -1;
+        for ( auto v: candidates )
+        {
+            if ( liveTriangles[v] == 0 )
+                continue;
+
+            int64_t weight = 0;
+            if ( time - cacheTime[v] + 2 * liveTriangles[v] <= cacheSize )
+                weight = time - cacheTime[v];
+
+            if ( weight > bestWeight )
+            {
+                bestWeight = weight;
+                fan        = v;
+            }
+        }
+
+        // Dead end: continue with a recently used vertex.
+        while ( fan < 0 && !deadEnds.empty() )
+        {
+            const uint32_t v = deadEnds.back();
+            deadEnds.pop_back();
+
+            if ( liveTriangles[v] > 0 )
+                fan = v;
+        }
+
+        // Nothing left nearby: jump to the next vertex in index order and start a new cluster.
+        if ( fan < 0 )
+        {
+            while ( cursor < vertexCount && liveTriangles[cursor] == 0 )
+                ++cursor;
+
+            if ( cursor < vertexCount )
+            {
+                fan = static_cast<int64_t>( cursor );
+                clusters.push_back( static_cast<uint32_t>( result.size() / 3 ) );
+            }
+        }
+    }
+
+    assert( result.size() == triangleCount * 3 );
+    indices = std::move( result );
+
+    return clusters;
+}
+
+void WebGPUlib::optimizeOverdraw( std::vector<uint32_t>& indices, const std::vector<uint32_t>& clusters,
+                                  const void* positions, std::size_t vertexCount, std::size_t positionStride,
+                                  float threshold, uint32_t cacheSize )
+{
+    const auto triangleCount = static_cast<uint32_t>( indices.size() / 3 );
+
+    if ( triangleCount == 0 || clusters.empty() )
+        return;
+
+    const float targetACMR = analyzeVertexCache( indices, vertexCount, cacheSize ).getACMR() * threshold;
+
+    // Split the clusters where the ACMR of the cluster is below the target.
+    // The cache is flushed at each cluster boundary, since the clusters are reordered.
+    std::vector<uint32_t> softClusters;
+    VertexCache           cache { vertexCount, cacheSize };
+
+    for ( std::size_t c = 0; c < clusters.size(); ++c )
+    {
+        const uint32_t begin = clusters[c];
+        const uint32_t end   = c + 1 < clusters.size() ? clusters[c + 1] : triangleCount;
+
+        uint32_t clusterBegin = begin;
+        uint32_t misses       = 0;
+
+        cache.flush();
+        softClusters.push_back( begin );
+
+        for ( uint32_t t = begin; t < end; ++t )
+        {
+            for ( uint32_t k = 0; k < 3; ++k )
+                misses += cache.access( indices[t * 3 + k] ) ? 1 : 0;
+
+            const float clusterACMR = static_cast<float>( misses ) / static_cast<float>( t + 1 - clusterBegin );
+            if ( t + 1 < end && clusterACMR <= targetACMR )
+            {
+                clusterBegin = t + 1;
+                misses       = 0;
+
+                cache.flush();
+                softClusters.push_back( clusterBegin );
+            }
+        }
+    }
+
+    // Compute the area weighted centroid and normal of each cluster.
+    struct Cluster
+    {
+        uint32_t  begin;
+        uint32_t  end;
+        glm::vec3 centroid;
+        glm::vec3 normal;
+        float     area;
+        float     sortKey;
+    };
+
+    std::vector<Cluster> sortedClusters( softClusters.size() );
+    glm::vec3            meshCentroid { 0 };
+    float                meshArea = 0.0f;
+
+    for ( std::size_t c = 0; c < softClusters.size(); ++c )
+    {
+        auto& cluster    = sortedClusters[c];
+        cluster.begin    = softClusters[c];
+        cluster.end      = c + 1 < softClusters.size() ? softClusters[c + 1] : triangleCount;
+        cluster.centroid = glm::vec3 { 0 };
+        cluster.normal   = glm::vec3 { 0 };
+        cluster.area     = 0.0f;
+
+        for ( uint32_t t = cluster.begin; t < cluster.end; ++t )
+        {
+            const glm::vec3 p0 = getPosition( positions, positionStride, indices[t * 3 + 0] );
+            const glm::vec3 p1 = getPosition( positions, positionStride, indices[t * 3 + 1] );
+            const glm::vec3 p2 = getPosition( positions, positionStride, indices[t * 3 + 2] );
+
+            const glm::vec3 n    = glm::cross( p1 - p0, p2 - p0 );
+            const float     area = glm::length( n ) * 0.5f;
+
+            cluster.centroid += ( p0 + p1 + p2 ) * ( area / 3.0f );
+            cluster.normal += n;
+            cluster.area += area;
+        }
+
+        meshCentroid += cluster.centroid;
+        meshArea += cluster.area;
+
+        if ( cluster.area > 0.0f )
+            cluster.centroid /= cluster.area;
+    }
+
+    if ( meshArea > 0.0f )
+        meshCentroid /= meshArea;
+
+    // Clusters that are far from the center and face outwards are drawn first.
+    for ( auto& cluster: sortedClusters )
+    {
+        const float normalLength = glm::length( cluster.normal );
+        cluster.sortKey =
+            normalLength > 0.0f ? glm::dot( cluster.centroid - meshCentroid, cluster.normal / normalLength ) : 0.0f;
+    }
+
+    std::stable_sort( sortedClusters.begin(), sortedClusters.end(),
+                      []( const Cluster& a, const Cluster& b ) { return a.sortKey > b.sortKey; } );
+
+    std::vector<uint32_t> result;
+    result.reserve( indices.size() );
+    for ( auto& cluster: sortedClusters )
+    {
+        result.insert( result.end(), indices.begin() + cluster.begin * 3, indices.begin() + cluster.end * 3 );
+    }
+
+    // Keep the vertex cache order if the cluster order costs too many cache misses.
+    if ( analyzeVertexCache( result, vertexCount, cacheSize ).getACMR() <= targetACMR )
+        indices = std::move( result );
+}
+
+std::pair<std::vector<uint32_t>, uint32_t> WebGPUlib::optimizeVertexFetchRemap( std::vector<uint32_t>& indices,
+                                                                                 std::size_t            vertexCount )
+{
+    std::vector<uint32_t> remap( vertexCount, ~0u );
+    uint32_t              nextVertex = 0;
+
+    for ( auto& index: indices )
+    {
+        if ( remap[index] == ~0u )
+            remap[index] = nextVertex++;
+
+        index = remap[index];
+    }
+
+    return { std::move( remap ), nextVertex };
+}
+
+std::vector<uint32_t> WebGPUlib::partitionTriangles( const std::vector<uint32_t>& indices, std::size_t vertexCount,
+                                                     uint32_t maxVertexCount )
+{
+    assert( maxVertexCount >= 3 );
+
+    const auto            triangleCount = static_cast<uint32_t>( indices.size() / 3 );
+    std::vector<uint32_t> ranges;
+
+    if ( triangleCount == 0 )
+        return ranges;
+
+    // The range that last referenced each vertex.
+    std::vector<uint32_t> vertexRange( vertexCount, ~0u );
+    uint32_t              range            = 0;
+    uint32_t              rangeVertexCount = 0;
+
+    ranges.push_back( 0 );
+
+    for ( uint32_t t = 0; t < triangleCount; ++t )
+    {
+        const uint32_t* triangle = &indices[t * 3];
+
+        // Count the vertices that are not in the current range yet (each vertex once for degenerate triangles).
+        uint32_t newVertexCount = 0;
+        for ( uint32_t k = 0; k < 3; ++k )
+        {
+            const uint32_t v         = triangle[k];
+            const bool     duplicate = ( k > 0 && triangle[0] == v ) || ( k > 1 && triangle[1] == v );
+            if ( !duplicate && vertexRange[v] != range )
+                ++newVertexCount;
+        }
+
+        if ( rangeVertexCount + newVertexCount > maxVertexCount )
+        {
+            ranges.push_back( t );
+            ++range;
+            rangeVertexCount = 0;
+        }
+
+        for ( uint32_t k = 0; k < 3; ++k )
+        {
+            const uint32_t v = triangle[k];
+            if ( vertexRange[v] != range )
+            {
+                vertexRange[v] = range;
+                ++rangeVertexCount;
+            }
+        }
+    }
+
+    return ranges;
+}
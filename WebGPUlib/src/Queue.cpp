@@ -2,14 +2,21 @@
 
 #include <WebGPUlib/Buffer.hpp>
 #include <WebGPUlib/Device.hpp>
+#include <WebGPUlib/GPUProfiler.hpp>
 #include <WebGPUlib/GraphicsCommandBuffer.hpp>
+#include <WebGPUlib/Helpers.hpp>
 #include <WebGPUlib/Queue.hpp>
+#include <WebGPUlib/RenderBundleCommandBuffer.hpp>
 #include <WebGPUlib/RenderTarget.hpp>
 #include <WebGPUlib/Texture.hpp>
 #include <WebGPUlib/TextureView.hpp>
 
+#include <algorithm>
 #include <cassert>
+#include <cstring>
 #include <exception>
+#include <iostream>
+#include <optional>
 #include <vector>
 
 using namespace WebGPUlib;
@@ -28,6 +35,13 @@ struct MakeComputeCommandBuffer : ComputeCommandBuffer
     {}
 };
 
+struct MakeRenderBundleCommandBuffer : RenderBundleCommandBuffer
+{
+    MakeRenderBundleCommandBuffer( WGPURenderBundleEncoder&& bundleEncoder )
+    : RenderBundleCommandBuffer { std::move( bundleEncoder ) }  // NOLINT(performance-move-const-arg)
+    {}
+};
+
 void Queue::writeBuffer( WGPUBuffer buffer, const void* data, std::size_t size, uint64_t offset ) const
 {
     wgpuQueueWriteBuffer( queue, buffer, offset, data, size );
@@ -35,7 +49,20 @@ void Queue::writeBuffer( WGPUBuffer buffer, const void* data, std::size_t size,
 
 void Queue::writeBuffer( const Buffer& buffer, const void* data, std::size_t size, uint64_t offset ) const
 {
-    writeBuffer( buffer.getWGPUBuffer(), data, size, offset );
+    // Buffers that are allocated from a buffer arena start at an offset in the WGPUBuffer.
+    offset += buffer.getOffset();
+
+    // Queue writes require the size of the data to be a multiple of 4 bytes.
+    if ( size % 4 == 0 )
+    {
+        writeBuffer( buffer.getWGPUBuffer(), data, size, offset );
+    }
+    else
+    {
+        std::vector<uint8_t> padded( AlignUp( size, 4 ), 0 );
+        std::memcpy( padded.data(), data, size );
+        writeBuffer( buffer.getWGPUBuffer(), padded.data(), padded.size(), offset );
+    }
 }
 
 static uint32_t bytesPerPixel( WGPUTextureFormat format, WGPUTextureAspect aspect )
@@ -182,39 +209,34 @@ static uint32_t bytesPerPixel( WGPUTextureFormat format, WGPUTextureAspect aspec
     throw std::invalid_argument( "Invalid texture format" );
 }
 
-void Queue::writeTexture( Texture& texture, uint32_t mip, const void* data, std::size_t size ) const
+// The width and height of a texel block. Block compressed formats store 4x4 texel blocks.
+static uint32_t blockDimension( WGPUTextureFormat format )
 {
-    constexpr float mipDiv[] = {
-        1.0f,      // 2^0
-        2.0f,      // 2^1
-        4.0f,      // 2^2
-        8.0f,      // 2^3
-        16.0f,     // 2^4
-        32.0f,     // 2^5
-        64.0f,     // 2^6
-        128.0f,    // 2^7
-        256.0f,    // 2^8
-        512.0f,    // 2^9
-        1024.0f,   // 2^10
-        2048.0f,   // 2^11
-        4096.0f,   // 2^12
-        8192.0f,   // 2^13
-        16384.0f,  // 2^14
-    };
+    if ( format >= WGPUTextureFormat_BC1RGBAUnorm && format <= WGPUTextureFormat_BC7RGBAUnormSrgb )
+        return 4u;
 
+    return 1u;
+}
+
+void Queue::writeTexture( Texture& texture, uint32_t mip, const void* data, std::size_t size ) const
+{
     auto desc = texture.getWGPUTextureDescriptor();
-    assert( mip < desc.mipLevelCount && mip < 14 );
+    assert( mip < desc.mipLevelCount );
 
-    uint32_t w = static_cast<uint32_t>( std::floor( static_cast<float>( desc.size.width ) / mipDiv[mip] ) );
-    uint32_t h = static_cast<uint32_t>( std::floor( static_cast<float>( desc.size.height ) / mipDiv[mip] ) );
     // Width and height must be greater than 0!
-    assert( w > 0 );
-    assert( h > 0 );
+    uint32_t w = std::max( desc.size.width >> mip, 1u );
+    uint32_t h = std::max( desc.size.height >> mip, 1u );
+
+    // For block compressed formats, the copy size is rounded up to whole blocks and
+    // bytesPerPixel returns the size of a block.
+    const uint32_t blockDim = blockDimension( desc.format );
+    const uint32_t blocksX  = ( w + blockDim - 1 ) / blockDim;
+    const uint32_t blocksY  = ( h + blockDim - 1 ) / blockDim;
 
     WGPUTextureDataLayout src {};
     src.offset       = 0;
-    src.bytesPerRow  = w * bytesPerPixel( desc.format, WGPUTextureAspect_All );
-    src.rowsPerImage = h;
+    src.bytesPerRow  = blocksX * bytesPerPixel( desc.format, WGPUTextureAspect_All );
+    src.rowsPerImage = blocksY;
     // The source size and the data size must match.
     assert( static_cast<std::size_t>( src.bytesPerRow ) * src.rowsPerImage == size );
 
@@ -224,13 +246,107 @@ void Queue::writeTexture( Texture& texture, uint32_t mip, const void* data, std:
     dst.origin   = { 0, 0, 0 };
     dst.aspect   = WGPUTextureAspect_All;
 
-    wgpuQueueWriteTexture( queue, &dst, data, size, &src, &desc.size );
+    WGPUExtent3D copySize { blocksX * blockDim, blocksY * blockDim, 1 };
+
+    wgpuQueueWriteTexture( queue, &dst, data, size, &src, &copySize );
+}
+
+std::vector<uint8_t> Queue::readTexture( const Texture& texture, uint32_t mip ) const
+{
+    auto desc = texture.getWGPUTextureDescriptor();
+    assert( mip < desc.mipLevelCount );
+
+    const uint32_t width         = std::max( desc.size.width >> mip, 1u );
+    const uint32_t height        = std::max( desc.size.height >> mip, 1u );
+    const uint32_t rowSize       = width * bytesPerPixel( desc.format, WGPUTextureAspect_All );
+    const uint32_t paddedRowSize = AlignUp( rowSize, 256 );  // bytesPerRow must be a multiple of 256.
+
+    WGPUBufferDescriptor bufferDesc {};
+    bufferDesc.label            = "Readback Buffer";
+    bufferDesc.usage            = WGPUBufferUsage_MapRead | WGPUBufferUsage_CopyDst;
+    bufferDesc.size             = static_cast<uint64_t>( paddedRowSize ) * height;
+    bufferDesc.mappedAtCreation = false;
+
+    WGPUDevice device         = Device::get().getWGPUDevice();
+    WGPUBuffer readbackBuffer = wgpuDeviceCreateBuffer( device, &bufferDesc );
+
+    WGPUImageCopyTexture src {};
+    src.texture  = texture.getWGPUTexture();
+    src.mipLevel = mip;
+    src.origin   = { 0, 0, 0 };
+    src.aspect   = WGPUTextureAspect_All;
+
+    WGPUImageCopyBuffer dst {};
+    dst.buffer              = readbackBuffer;
+    dst.layout.offset       = 0;
+    dst.layout.bytesPerRow  = paddedRowSize;
+    dst.layout.rowsPerImage = height;
+
+    WGPUExtent3D copySize { width, height, 1 };
+
+    WGPUCommandEncoderDescriptor commandEncoderDesc {};
+    commandEncoderDesc.label          = "Readback Command Encoder";
+    WGPUCommandEncoder commandEncoder = wgpuDeviceCreateCommandEncoder( device, &commandEncoderDesc );
+    wgpuCommandEncoderCopyTextureToBuffer( commandEncoder, &src, &dst, &copySize );
+    WGPUCommandBuffer commandBuffer = wgpuCommandEncoderFinish( commandEncoder, nullptr );
+    wgpuCommandEncoderRelease( commandEncoder );
+
+    wgpuQueueSubmit( queue, 1, &commandBuffer );
+    wgpuCommandBufferRelease( commandBuffer );
+
+    // Used by the map callback to notify us when the mapping is complete.
+    struct MapData
+    {
+        WGPUBufferMapAsyncStatus status = WGPUBufferMapAsyncStatus_Unknown;
+        bool                     done   = false;
+    } mapData;
+
+    wgpuBufferMapAsync(
+        readbackBuffer, WGPUMapMode_Read, 0, bufferDesc.size,
+        []( WGPUBufferMapAsyncStatus status, void* userData ) {
+            auto& data  = *static_cast<MapData*>( userData );
+            data.status = status;
+            data.done   = true;
+        },
+        &mapData );
+
+    // Poll the device until the copy is done and the buffer is mapped.
+    while ( !mapData.done )
+    {
+        Device::get().poll( true );
+    }
+
+    std::vector<uint8_t> pixels;
+
+    if ( mapData.status == WGPUBufferMapAsyncStatus_Success )
+    {
+        pixels.resize( static_cast<std::size_t>( rowSize ) * height );
+
+        auto mapped =
+            static_cast<const uint8_t*>( wgpuBufferGetConstMappedRange( readbackBuffer, 0, bufferDesc.size ) );
+        for ( uint32_t y = 0; y < height; ++y )
+        {
+            std::memcpy( pixels.data() + static_cast<std::size_t>( y ) * rowSize,
+                         mapped + static_cast<std::size_t>( y ) * paddedRowSize, rowSize );
+        }
+
+        wgpuBufferUnmap( readbackBuffer );
+    }
+    else
+    {
+        std::cerr << "ERROR: Failed to map readback buffer: " << mapData.status << std::endl;
+    }
+
+    wgpuBufferRelease( readbackBuffer );
+
+    return pixels;
 }
 
 std::shared_ptr<GraphicsCommandBuffer> Queue::createGraphicsCommandBuffer( const RenderTarget& renderTarget,
                                                                            ClearFlags          clearFlags,
                                                                            const WGPUColor& clearColor, float depth,
-                                                                           uint32_t stencil ) const
+                                                                           uint32_t    stencil,
+                                                                           const char* passName ) const
 {
     WGPUCommandEncoderDescriptor commandEncoderDesc {};
     commandEncoderDesc.label = "Graphics Command Encoder";
@@ -283,18 +399,24 @@ std::shared_ptr<GraphicsCommandBuffer> Queue::createGraphicsCommandBuffer( const
         depthStencilAttachment.stencilReadOnly   = false;
     }
 
+    // Measure the GPU time of named passes.
+    std::optional<WGPURenderPassTimestampWrites> timestampWrites;
+    if ( passName )
+        timestampWrites = Device::get().getGPUProfiler().getRenderPassTimestampWrites( passName );
+
     WGPURenderPassDescriptor renderPassDesc {};
+    renderPassDesc.label                    = passName;
     renderPassDesc.colorAttachmentCount     = static_cast<uint32_t>( colorAttachments.size() );
     renderPassDesc.colorAttachments         = colorAttachments.data();
     renderPassDesc.depthStencilAttachment   = depthStencilView ? &depthStencilAttachment : nullptr;
-    renderPassDesc.timestampWrites          = nullptr;
+    renderPassDesc.timestampWrites          = timestampWrites ? &*timestampWrites : nullptr;
     WGPURenderPassEncoder renderPassEncoder = wgpuCommandEncoderBeginRenderPass( commandEncoder, &renderPassDesc );
 
     return std::make_shared<MakeGraphicsCommandBuffer>(
         std::move( commandEncoder ), std::move( renderPassEncoder ) );  // NOLINT(performance-move-const-arg)
 }
 
-std::shared_ptr<ComputeCommandBuffer> Queue::createComputeCommandBuffer()
+std::shared_ptr<ComputeCommandBuffer> Queue::createComputeCommandBuffer( const char* passName )
 {
     // Create a command encoder.
     WGPUCommandEncoderDescriptor commandEncoderDesc {};
@@ -302,23 +424,79 @@ std::shared_ptr<ComputeCommandBuffer> Queue::createComputeCommandBuffer()
     WGPUCommandEncoder commandEncoder =
         wgpuDeviceCreateCommandEncoder( Device::get().getWGPUDevice(), &commandEncoderDesc );
 
+    // Measure the GPU time of named passes.
+    std::optional<WGPUComputePassTimestampWrites> timestampWrites;
+    if ( passName )
+        timestampWrites = Device::get().getGPUProfiler().getComputePassTimestampWrites( passName );
+
     // Create a compute pass
     WGPUComputePassDescriptor computePassDesc {};
-    computePassDesc.label              = "Compute Pass";
-    computePassDesc.timestampWrites    = nullptr;
+    computePassDesc.label              = passName ? passName : "Compute Pass";
+    computePassDesc.timestampWrites    = timestampWrites ? &*timestampWrites : nullptr;
     WGPUComputePassEncoder passEncoder = wgpuCommandEncoderBeginComputePass( commandEncoder, &computePassDesc );
 
     return std::make_shared<MakeComputeCommandBuffer>(
         std::move( commandEncoder ), std::move( passEncoder ) );  // NOLINT(performance-move-const-arg)
 }
 
+std::shared_ptr<RenderBundleCommandBuffer>
+    Queue::createRenderBundleCommandBuffer( const RenderTarget& renderTarget ) const
+{
+    std::vector<WGPUTextureFormat> colorFormats;
+    colorFormats.reserve( 8 );  // Max color attachment points.
+
+    uint32_t sampleCount = 1;
+
+    auto& views = renderTarget.getTextureViews();
+    for ( int i = 0; i < 8; ++i )
+    {
+        auto& view = views[i];
+        if ( view.first )
+        {
+            WGPUTexture texture = view.first->getWGPUTexture();
+            colorFormats.push_back( wgpuTextureGetFormat( texture ) );
+            sampleCount = wgpuTextureGetSampleCount( texture );
+        }
+    }
+
+    WGPUTextureFormat depthStencilFormat = WGPUTextureFormat_Undefined;
+    if ( auto& depthStencilView = views[static_cast<std::size_t>( AttachmentPoint::DepthStencil )].first )
+    {
+        depthStencilFormat = wgpuTextureGetFormat( depthStencilView->getWGPUTexture() );
+        sampleCount        = wgpuTextureGetSampleCount( depthStencilView->getWGPUTexture() );
+    }
+
+    WGPURenderBundleEncoderDescriptor bundleEncoderDesc {};
+    bundleEncoderDesc.label              = "Render Bundle Encoder";
+    bundleEncoderDesc.colorFormatCount   = colorFormats.size();
+    bundleEncoderDesc.colorFormats       = colorFormats.data();
+    bundleEncoderDesc.depthStencilFormat = depthStencilFormat;
+    bundleEncoderDesc.sampleCount        = sampleCount;
+    bundleEncoderDesc.depthReadOnly      = false;
+    bundleEncoderDesc.stencilReadOnly    = false;
+    WGPURenderBundleEncoder bundleEncoder =
+        wgpuDeviceCreateRenderBundleEncoder( Device::get().getWGPUDevice(), &bundleEncoderDesc );
+
+    return std::make_shared<MakeRenderBundleCommandBuffer>(
+        std::move( bundleEncoder ) );  // NOLINT(performance-move-const-arg)
+}
+
 void Queue::submit( CommandBuffer& commandBuffer )
 {
     WGPUCommandBuffer cb = commandBuffer.finish();
 
+    if ( !cb )
+        return;
+
+    // Queue writes are executed before the command buffers that are submitted after them.
+    commandBuffer.flush();
+
     wgpuQueueSubmit( queue, 1, &cb );
 
     wgpuCommandBufferRelease( cb );
+
+    // Upload pages can be recycled once the submitted work is done.
+    commandBuffer.reset();
 }
 
 Queue::Queue( WGPUQueue&& _queue )  // NOLINT(cppcoreguidelines-rvalue-reference-param-not-moved)
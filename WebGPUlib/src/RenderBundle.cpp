@@ -0,0 +1,55 @@
+#include <WebGPUlib/Device.hpp>
+#include <WebGPUlib/GraphicsPipelineState.hpp>
+#include <WebGPUlib/Material.hpp>
+#include <WebGPUlib/Queue.hpp>
+#include <WebGPUlib/RenderBundle.hpp>
+#include <WebGPUlib/SceneNode.hpp>
+
+#include <utility>
+
+using namespace WebGPUlib;
+
+RenderBundle::RenderBundle( WGPURenderBundle&& _renderBundle,  // NOLINT(cppcoreguidelines-rvalue-reference-param-not-moved)
+                            UploadPagePool::PageList&& _pages, Dependencies&& _dependencies )
+: renderBundle { _renderBundle }
+, pages { std::move( _pages ) }
+, dependencies { std::move( _dependencies ) }
+{}
+
+RenderBundle::~RenderBundle()
+{
+    if ( renderBundle )
+        wgpuRenderBundleRelease( renderBundle );
+
+    // The pages can be reused after the GPU has finished the work that executed this bundle.
+    auto& device = Device::get();
+    device.getUploadPagePool().retirePages( *device.getQueue(), std::move( pages ) );
+}
+
+bool RenderBundle::isValid() const
+{
+    if ( invalidated || !renderBundle )
+        return false;
+
+    for ( auto& [weakNode, version]: dependencies.nodes )
+    {
+        auto node = weakNode.lock();
+        if ( !node || node->getTransformVersion() != version )
+            return false;
+    }
+
+    for ( auto& [weakMaterial, version]: dependencies.materials )
+    {
+        auto material = weakMaterial.lock();
+        if ( !material || material->getVersion() != version )
+            return false;
+    }
+
+    for ( auto& [pipelineState, pipeline]: dependencies.pipelines )
+    {
+        if ( pipelineState->getWGPURenderPipeline() != pipeline )
+            return false;
+    }
+
+    return true;
+}
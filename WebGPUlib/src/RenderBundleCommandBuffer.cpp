@@ -0,0 +1,215 @@
+#include <WebGPUlib/BindGroup.hpp>
+#include <WebGPUlib/Device.hpp>
+#include <WebGPUlib/GraphicsPipelineState.hpp>
+#include <WebGPUlib/IndexBuffer.hpp>
+#include <WebGPUlib/Material.hpp>
+#include <WebGPUlib/Mesh.hpp>
+#include <WebGPUlib/Queue.hpp>
+#include <WebGPUlib/RenderBundleCommandBuffer.hpp>
+#include <WebGPUlib/SceneNode.hpp>
+#include <WebGPUlib/VertexBuffer.hpp>
+
+#include <iostream>
+#include <utility>
+
+using namespace WebGPUlib;
+
+struct MakeRenderBundle : RenderBundle
+{
+    MakeRenderBundle( WGPURenderBundle&& renderBundle, UploadPagePool::PageList&& pages, Dependencies&& dependencies )
+    : RenderBundle( std::move( renderBundle ), std::move( pages ),  // NOLINT(performance-move-const-arg)
+                    std::move( dependencies ) )
+    {}
+};
+
+RenderBundleCommandBuffer::RenderBundleCommandBuffer(
+    WGPURenderBundleEncoder&& _bundleEncoder )  // NOLINT(cppcoreguidelines-rvalue-reference-param-not-moved)
+: CommandBuffer( WGPUCommandEncoder { nullptr } )
+, bundleEncoder { _bundleEncoder }
+{}
+
+RenderBundleCommandBuffer::~RenderBundleCommandBuffer()
+{
+    if ( bundleEncoder )
+        wgpuRenderBundleEncoderRelease( bundleEncoder );
+}
+
+void RenderBundleCommandBuffer::setBindGroup( uint32_t groupIndex, const BindGroup& _bindGroup )
+{
+    if ( currentPipelineState )
+    {
+        auto  bindGroupLayout = currentPipelineState->getWGPUBindGroupLayout( groupIndex );
+        auto  bindGroup       = _bindGroup.getWGPUBindGroup( bindGroupLayout );
+        auto& dynamicOffsets  = _bindGroup.getDynamicOffsets();
+
+        if ( updateBindGroupState( groupIndex, bindGroup, dynamicOffsets ) )
+            wgpuRenderBundleEncoderSetBindGroup( bundleEncoder, groupIndex, bindGroup, dynamicOffsets.size(),
+                                                 dynamicOffsets.data() );
+    }
+    else
+    {
+        std::cerr
+            << "ERROR (RenderBundleCommandBuffer::setBindGroup): No graphics pipeline set. Make sure to set the pipeline before drawing."
+            << std::endl;
+    }
+}
+
+void RenderBundleCommandBuffer::setGraphicsPipeline( GraphicsPipelineState& pipeline )
+{
+    if ( currentPipelineState == &pipeline && currentPipeline == pipeline.getWGPURenderPipeline() )
+    {
+        ++statistics.pipelinesSkipped;
+        return;
+    }
+
+    currentPipelineState = &pipeline;
+    currentPipeline      = pipeline.getWGPURenderPipeline();
+
+    wgpuRenderBundleEncoderSetPipeline( bundleEncoder, currentPipeline );
+    ++statistics.pipelinesSet;
+
+    // The bind groups are resolved with the bind group layouts of the pipeline.
+    invalidateBindGroups();
+
+    dependencies.pipelines.emplace_back( &pipeline, currentPipeline );
+}
+
+void RenderBundleCommandBuffer::setVertexBuffer( uint32_t slot, const BufferBinding& binding )
+{
+    if ( currentVertexBuffers.size() <= slot )
+        currentVertexBuffers.resize( slot + 1 );
+
+    if ( currentVertexBuffers[slot] == binding )
+    {
+        ++statistics.vertexBuffersSkipped;
+        return;
+    }
+
+    wgpuRenderBundleEncoderSetVertexBuffer( bundleEncoder, slot, binding.buffer, binding.offset, binding.size );
+    currentVertexBuffers[slot] = binding;
+    ++statistics.vertexBuffersSet;
+}
+
+void RenderBundleCommandBuffer::setIndexBuffer( const BufferBinding& binding, WGPUIndexFormat indexFormat )
+{
+    if ( currentIndexBuffer == binding && currentIndexFormat == indexFormat )
+    {
+        ++statistics.indexBuffersSkipped;
+        return;
+    }
+
+    wgpuRenderBundleEncoderSetIndexBuffer( bundleEncoder, binding.buffer, indexFormat, binding.offset, binding.size );
+    currentIndexBuffer = binding;
+    currentIndexFormat = indexFormat;
+    ++statistics.indexBuffersSet;
+}
+
+void RenderBundleCommandBuffer::setMeshBuffers( const Mesh& mesh )
+{
+    auto& vertexBuffers = mesh.getVertexBuffers();
+    auto& indexBuffer   = mesh.getIndexBuffer();
+
+    // Meshes that share an arena bind the whole arena, so consecutive draws do not need to rebind the buffer.
+    bool useBaseVertex = mesh.usesBaseVertex();
+
+    for ( uint32_t i = 0; i < vertexBuffers.size(); ++i )
+    {
+        if ( auto& vertexBuffer = vertexBuffers[i] )
+        {
+            if ( useBaseVertex )
+                setVertexBuffer( i, { vertexBuffer->getWGPUBuffer(), 0, WGPU_WHOLE_SIZE } );
+            else
+                setVertexBuffer( i,
+                                 { vertexBuffer->getWGPUBuffer(), vertexBuffer->getOffset(), vertexBuffer->getSize() } );
+        }
+    }
+
+    if ( indexBuffer )
+    {
+        if ( indexBuffer->getArena() )
+            setIndexBuffer( { indexBuffer->getWGPUBuffer(), 0, WGPU_WHOLE_SIZE }, indexBuffer->getIndexFormat() );
+        else
+            setIndexBuffer( { indexBuffer->getWGPUBuffer(), indexBuffer->getOffset(), indexBuffer->getSize() },
+                            indexBuffer->getIndexFormat() );
+    }
+}
+
+void RenderBundleCommandBuffer::draw( const Mesh& mesh, uint32_t instanceCount, uint32_t firstInstance )
+{
+    commitBindGroups();
+    ++statistics.drawCount;
+
+    setMeshBuffers( mesh );
+
+    auto& vertexBuffers = mesh.getVertexBuffers();
+    auto& indexBuffer   = mesh.getIndexBuffer();
+
+    if ( indexBuffer )
+    {
+        wgpuRenderBundleEncoderDrawIndexed( bundleEncoder, static_cast<uint32_t>( indexBuffer->getIndexCount() ),
+                                            instanceCount, mesh.getFirstIndex(), mesh.getBaseVertex(), firstInstance );
+    }
+    else if ( !vertexBuffers.empty() && vertexBuffers[0] )
+    {
+        wgpuRenderBundleEncoderDraw( bundleEncoder, static_cast<uint32_t>( vertexBuffers[0]->getVertexCount() ),
+                                     instanceCount, static_cast<uint32_t>( mesh.getBaseVertex() ), firstInstance );
+    }
+}
+
+void RenderBundleCommandBuffer::drawIndirect( const Mesh& mesh, const Buffer& indirectBuffer, uint64_t indirectOffset )
+{
+    if ( !mesh.getIndexBuffer() )
+    {
+        std::cerr << "ERROR (RenderBundleCommandBuffer::drawIndirect): Only indexed meshes can be drawn indirectly."
+                  << std::endl;
+        return;
+    }
+
+    commitBindGroups();
+    ++statistics.drawCount;
+
+    setMeshBuffers( mesh );
+
+    wgpuRenderBundleEncoderDrawIndexedIndirect( bundleEncoder, indirectBuffer.getWGPUBuffer(),
+                                                indirectBuffer.getOffset() + indirectOffset );
+}
+
+void RenderBundleCommandBuffer::addDependency( const std::shared_ptr<const SceneNode>& node )
+{
+    // The world transform of the node also depends on the transforms of its parents.
+    for ( std::shared_ptr<const SceneNode> n = node; n; n = n->getParent() )
+    {
+        dependencies.nodes.emplace_back( n, n->getTransformVersion() );
+    }
+}
+
+void RenderBundleCommandBuffer::addDependency( const std::shared_ptr<const Material>& material )
+{
+    if ( material )
+        dependencies.materials.emplace_back( material, material->getVersion() );
+}
+
+std::shared_ptr<RenderBundle> RenderBundleCommandBuffer::finishBundle()
+{
+    WGPURenderBundleDescriptor renderBundleDesc {};
+    renderBundleDesc.label = "Render Bundle";
+
+    WGPURenderBundle renderBundle = wgpuRenderBundleEncoderFinish( bundleEncoder, &renderBundleDesc );
+
+    // Write the dynamic buffer data. The render bundle keeps the upload pages until it is destroyed.
+    flush();
+
+    currentPipelineState = nullptr;
+    currentPipeline      = nullptr;
+    resetBindGroupState();
+
+    return std::make_shared<MakeRenderBundle>( std::move( renderBundle ),  // NOLINT(performance-move-const-arg)
+                                               releaseUploadPages(), std::move( dependencies ) );
+}
+
+WGPUCommandBuffer RenderBundleCommandBuffer::finish()
+{
+    std::cerr << "ERROR (RenderBundleCommandBuffer::finish): Render bundles can not be submitted to the queue. Use finishBundle instead." << std::endl;
+
+    return nullptr;
+}
@@ -0,0 +1,130 @@
+#include <WebGPUlib/Mesh.hpp>
+#include <WebGPUlib/RenderQueue.hpp>
+#include <WebGPUlib/SceneNode.hpp>
+
+#include <glm/vec4.hpp>
+
+#include <algorithm>
+#include <cstring>
+#include <functional>
+
+using namespace WebGPUlib;
+
+// Convert a (non-negative) depth value to a 24-bit key.
+// The bits of a positive float increase with its value, so the upper bits can be compared as an integer.
+static uint64_t depthKey( float depth )
+{
+    depth = std::max( depth, 0.0f );
+
+    uint32_t bits;
+    std::memcpy( &bits, &depth, sizeof( bits ) );
+
+    return bits >> 7;  // The sign bit is always 0, keep the next 24 bits.
+}
+
+std::size_t RenderQueue::TextureSetHash::operator()( const TextureSet& textureSet ) const noexcept
+{
+    std::size_t hash = 0;
+    for ( auto& texture: textureSet )
+        hash = hash * 31 + std::hash<const Texture*> {}( texture.get() );
+
+    return hash;
+}
+
+void RenderQueue::clear( const glm::mat4& _viewMatrix )
+{
+    viewMatrix = _viewMatrix;
+
+    drawPackets.clear();
+    materials.clear();
+    textureSets.clear();
+    materialEntries.clear();
+    textureSetIndices.clear();
+}
+
+RenderQueue::MaterialEntry RenderQueue::getMaterialEntry( const std::shared_ptr<Material>& material )
+{
+    auto iter = materialEntries.find( material.get() );
+    if ( iter != materialEntries.end() )
+        return iter->second;
+
+    // The textures only need to be looked up once per material.
+    TextureSet textureSet;
+    for ( std::size_t slot = 0; slot < textureSet.size(); ++slot )
+    {
+        if ( material )
+            textureSet[slot] = material->getTexture( static_cast<TextureSlot>( slot ) );
+    }
+
+    auto [textureSetIter, inserted] =
+        textureSetIndices.try_emplace( textureSet, static_cast<uint32_t>( textureSets.size() ) );
+    if ( inserted )
+        textureSets.push_back( std::move( textureSet ) );
+
+    MaterialEntry entry { static_cast<uint32_t>( materials.size() ), textureSetIter->second };
+    materials.push_back( material );
+    materialEntries.emplace( material.get(), entry );
+
+    return entry;
+}
+
+void RenderQueue::add( const VisibleMesh& visibleMesh, uint32_t pipeline )
+{
+    const auto& node = *visibleMesh.node;
+    const auto& mesh = *visibleMesh.mesh;
+
+    const auto entry = getMaterialEntry( mesh.getMaterial() );
+
+    // The view space depth of the center of the mesh (the camera looks down the negative z-axis).
+    const glm::vec4 center = node.getWorldTransform() * glm::vec4 { mesh.getBoundingBox().getCenter(), 1.0f };
+    const float     depth  = -( viewMatrix * center ).z;
+
+    const uint64_t sortKey = static_cast<uint64_t>( std::min( pipeline, MaxPipelineCount - 1 ) ) << 56 |
+                             static_cast<uint64_t>( std::min( entry.textureSet, MaxMaterialCount - 1 ) ) << 40 |
+                             static_cast<uint64_t>( std::min( entry.material, MaxMaterialCount - 1 ) ) << 24 |
+                             depthKey( depth );
+
+    drawPackets.push_back( { sortKey, &node, &mesh, entry.material, entry.textureSet } );
+}
+
+void RenderQueue::sort()
+{
+    constexpr int DigitBits  = 8;
+    constexpr int DigitCount = 64 / DigitBits;
+    constexpr int RadixSize  = 1 << DigitBits;
+
+    const std::size_t count = drawPackets.size();
+
+    // Build the histograms of all digits in a single pass.
+    uint32_t histograms[DigitCount][RadixSize] {};
+    for ( auto& packet: drawPackets )
+    {
+        for ( int d = 0; d < DigitCount; ++d )
+            ++histograms[d][( packet.sortKey >> ( d * DigitBits ) ) & ( RadixSize - 1 )];
+    }
+
+    sortBuffer.resize( count );
+
+    // Least significant digit first. Each pass is stable, so the order of the previous passes is kept.
+    for ( int d = 0; d < DigitCount; ++d )
+    {
+        auto& histogram = histograms[d];
+
+        // Skip the digits that are the same for all packets (e.g. the pipeline or unused material bits).
+        if ( count == 0 || histogram[( drawPackets[0].sortKey >> ( d * DigitBits ) ) & ( RadixSize - 1 )] == count )
+            continue;
+
+        uint32_t offsets[RadixSize];
+        uint32_t offset = 0;
+        for ( int r = 0; r < RadixSize; ++r )
+        {
+            offsets[r] = offset;
+            offset += histogram[r];
+        }
+
+        for ( auto& packet: drawPackets )
+            sortBuffer[offsets[( packet.sortKey >> ( d * DigitBits ) ) & ( RadixSize - 1 )]++] = packet;
+
+        drawPackets.swap( sortBuffer );
+    }
+}
@@ -0,0 +1,345 @@
+#include <WebGPUlib/Frustum.hpp>
+#include <WebGPUlib/Mesh.hpp>
+#include <WebGPUlib/SceneGraph.hpp>
+#include <WebGPUlib/SceneNode.hpp>
+
+#include <glm/matrix.hpp>
+
+#include <algorithm>
+#include <cassert>
+
+using namespace WebGPUlib;
+
+// Reorder the elements of an array: result[i] = array[order[i]].
+template<typename T>
+static void permute( std::vector<T>& array, const std::vector<uint32_t>& order )
+{
+    std::vector<T> result;
+    result.reserve( order.size() );
+
+    for ( auto i: order )
+        result.push_back( std::move( array[i] ) );
+
+    array = std::move( result );
+}
+
+void SceneGraph::update()
+{
+    if ( sortDirty )
+        sortNodes();
+
+    if ( !boundsDirty )
+        return;
+
+    const auto nodeCount = static_cast<uint32_t>( nodes.size() );
+
+    // Parents are stored before their children, so a single forward sweep updates all world transforms.
+    for ( uint32_t i = 0; i < nodeCount; ++i )
+    {
+        if ( needsUpdate( i ) )
+            computeWorldTransform( i );
+
+        const auto& range = meshRanges[i];
+
+        if ( meshBoundsDirty[i] )
+        {
+            for ( uint32_t m = range.first; m < range.first + range.count; ++m )
+                meshWorldBounds[m] = meshes[m]->getBoundingBox().transform( worldTransforms[i] );
+
+            meshBoundsDirty[i] = false;
+        }
+
+        worldBounds[i] = BoundingBox {};
+        for ( uint32_t m = range.first; m < range.first + range.count; ++m )
+            worldBounds[i].merge( meshWorldBounds[m] );
+    }
+
+    // Children are stored after their parents, so a single backward sweep merges the bounds of the subtrees.
+    for ( uint32_t i = nodeCount; i-- > 0; )
+    {
+        if ( parents[i] != InvalidIndex )
+            worldBounds[parents[i]].merge( worldBounds[i] );
+    }
+
+    boundsDirty = false;
+    ++version;
+}
+
+void SceneGraph::cull( uint32_t node, const Frustum& frustum, std::vector<VisibleMesh>& visibleMeshes ) const
+{
+    assert( !sortDirty && node < nodes.size() );
+
+    // The subtree of a node is stored in the range [node, subtreeEnds[node]).
+    const uint32_t end = subtreeEnds[node];
+    uint32_t       i   = node;
+
+    while ( i < end )
+    {
+        const auto containment = frustum.contains( worldBounds[i] );
+
+        if ( containment == Frustum::Containment::Outside )
+        {
+            i = subtreeEnds[i];
+            continue;
+        }
+
+        if ( containment == Frustum::Containment::Inside )
+        {
+            // All meshes of the subtree are visible.
+            for ( uint32_t j = i; j < subtreeEnds[i]; ++j )
+            {
+                const auto& range = meshRanges[j];
+                for ( uint32_t m = range.first; m < range.first + range.count; ++m )
+                    visibleMeshes.push_back( { nodes[j]->shared_from_this(), meshes[m] } );
+            }
+
+            i = subtreeEnds[i];
+            continue;
+        }
+
+        // Test the meshes of this node and continue with its children.
+        const auto& range = meshRanges[i];
+        if ( range.count > 0 )
+        {
+            thread_local std::vector<uint8_t> visible;
+            visible.resize( range.count );
+
+            frustum.cull( &meshWorldBounds[range.first], range.count, visible.data() );
+
+            for ( uint32_t m = 0; m < range.count; ++m )
+            {
+                if ( visible[m] )
+                    visibleMeshes.push_back( { nodes[i]->shared_from_this(), meshes[range.first + m] } );
+            }
+        }
+
+        ++i;
+    }
+}
+
+uint32_t SceneGraph::addNode( SceneNode* node, const glm::mat4& localTransform, const glm::mat4& inverseLocalTransform,
+                              uint64_t transformVersion )
+{
+    const auto index = static_cast<uint32_t>( nodes.size() );
+
+    nodes.push_back( node );
+    parents.push_back( InvalidIndex );
+    subtreeEnds.push_back( index + 1 );
+    localTransforms.push_back( localTransform );
+    inverseLocalTransforms.push_back( inverseLocalTransform );
+    worldTransforms.push_back( localTransform );
+    inverseWorldTransforms.push_back( inverseLocalTransform );
+    transformVersions.push_back( transformVersion );
+    worldVersions.push_back( 0 );
+    parentWorldVersions.push_back( 0 );
+    localDirty.push_back( true );
+    meshBoundsDirty.push_back( true );
+    worldBounds.emplace_back();
+    meshRanges.emplace_back();
+
+    sortDirty   = true;
+    boundsDirty = true;
+
+    return index;
+}
+
+void SceneGraph::removeNode( uint32_t index )
+{
+    // The node is removed from the arrays when the nodes are sorted.
+    nodes[index] = nullptr;
+
+    sortDirty   = true;
+    boundsDirty = true;
+}
+
+void SceneGraph::setParent( uint32_t index, uint32_t parent )
+{
+    parents[index]    = parent;
+    localDirty[index] = true;
+
+    // The node may now be stored before its parent.
+    sortDirty   = true;
+    boundsDirty = true;
+}
+
+void SceneGraph::setLocalTransform( uint32_t index, const glm::mat4& localTransform )
+{
+    localTransforms[index]        = localTransform;
+    inverseLocalTransforms[index] = glm::inverse( localTransform );
+    localDirty[index]             = true;
+    ++transformVersions[index];
+
+    boundsDirty = true;
+}
+
+void SceneGraph::updateWorldTransform( uint32_t index )
+{
+    const uint32_t parent = parents[index];
+
+    if ( parent != InvalidIndex )
+        updateWorldTransform( parent );
+
+    if ( needsUpdate( index ) )
+        computeWorldTransform( index );
+}
+
+void SceneGraph::computeWorldTransform( uint32_t index )
+{
+    const uint32_t parent = parents[index];
+
+    if ( parent != InvalidIndex )
+    {
+        worldTransforms[index]        = worldTransforms[parent] * localTransforms[index];
+        inverseWorldTransforms[index] = inverseLocalTransforms[index] * inverseWorldTransforms[parent];
+        parentWorldVersions[index]    = worldVersions[parent];
+    }
+    else
+    {
+        worldTransforms[index]        = localTransforms[index];
+        inverseWorldTransforms[index] = inverseLocalTransforms[index];
+    }
+
+    ++worldVersions[index];
+    localDirty[index]      = false;
+    meshBoundsDirty[index] = true;
+}
+
+bool SceneGraph::isInSubtree( const SceneNode* root, const SceneNode* node )
+{
+    if ( root->sceneGraph.get() != this || node->sceneGraph.get() != this )
+        return false;
+
+    // Sorting the nodes updates the subtree ranges (and the node indices).
+    if ( sortDirty )
+        sortNodes();
+
+    return node->index > root->index && node->index < subtreeEnds[root->index];
+}
+
+void SceneGraph::moveSubtree( SceneNode& node, const std::shared_ptr<SceneGraph>& target, uint32_t parent )
+{
+    // Keep the source scene graph alive until the whole subtree has been moved.
+    auto           source = node.sceneGraph;
+    const uint32_t index  = node.index;
+
+    const auto&    localTransform = source->localTransforms[index];
+    const uint32_t newIndex       = target->addNode( &node, localTransform, source->inverseLocalTransforms[index],
+                                                     source->transformVersions[index] );
+    target->setParent( newIndex, parent );
+    source->removeNode( index );
+
+    node.sceneGraph = target;
+    node.index      = newIndex;
+
+    for ( auto& child: node.children )
+    {
+        if ( child->sceneGraph == source && source->parents[child->index] == index )
+            moveSubtree( *child, target, newIndex );
+    }
+}
+
+void SceneGraph::sortNodes()
+{
+    const auto nodeCount = static_cast<uint32_t>( nodes.size() );
+
+    // Nodes whose parent has been removed become roots.
+    for ( uint32_t i = 0; i < nodeCount; ++i )
+    {
+        if ( nodes[i] && parents[i] != InvalidIndex && !nodes[parents[i]] )
+            setParent( i, InvalidIndex );
+    }
+
+    // Group the children of each node (a counting sort on the parent index, which keeps the order of the children).
+    std::vector<uint32_t> childOffsets( nodeCount + 1, 0 );
+    for ( uint32_t i = 0; i < nodeCount; ++i )
+    {
+        if ( nodes[i] && parents[i] != InvalidIndex )
+            ++childOffsets[parents[i] + 1];
+    }
+    for ( uint32_t i = 0; i < nodeCount; ++i )
+        childOffsets[i + 1] += childOffsets[i];
+
+    std::vector<uint32_t> children( childOffsets.back() );
+    std::vector<uint32_t> fill( childOffsets.begin(), childOffsets.end() - 1 );
+    for ( uint32_t i = 0; i < nodeCount; ++i )
+    {
+        if ( nodes[i] && parents[i] != InvalidIndex )
+            children[fill[parents[i]]++] = i;
+    }
+
+    // Depth-first traversal of all trees in the scene graph.
+    std::vector<uint32_t> order;
+    std::vector<uint32_t> stack;
+    order.reserve( nodeCount );
+
+    for ( uint32_t root = 0; root < nodeCount; ++root )
+    {
+        if ( !nodes[root] || parents[root] != InvalidIndex )
+            continue;
+
+        stack.push_back( root );
+        while ( !stack.empty() )
+        {
+            const uint32_t i = stack.back();
+            stack.pop_back();
+
+            order.push_back( i );
+
+            // Push the children in reverse, so they are visited in order.
+            for ( uint32_t c = childOffsets[i + 1]; c-- > childOffsets[i]; )
+                stack.push_back( children[c] );
+        }
+    }
+
+    std::vector<uint32_t> newIndices( nodeCount, InvalidIndex );
+    for ( uint32_t i = 0; i < order.size(); ++i )
+        newIndices[order[i]] = i;
+
+    permute( nodes, order );
+    permute( parents, order );
+    permute( localTransforms, order );
+    permute( inverseLocalTransforms, order );
+    permute( worldTransforms, order );
+    permute( inverseWorldTransforms, order );
+    permute( transformVersions, order );
+    permute( worldVersions, order );
+    permute( parentWorldVersions, order );
+    permute( localDirty, order );
+
+    const auto newNodeCount = static_cast<uint32_t>( order.size() );
+
+    subtreeEnds.resize( newNodeCount );
+    meshBoundsDirty.assign( newNodeCount, true );
+    worldBounds.resize( newNodeCount );
+    meshRanges.resize( newNodeCount );
+
+    for ( uint32_t i = 0; i < newNodeCount; ++i )
+    {
+        nodes[i]->index = i;
+        subtreeEnds[i]  = i + 1;
+
+        if ( parents[i] != InvalidIndex )
+            parents[i] = newIndices[parents[i]];
+    }
+
+    for ( uint32_t i = newNodeCount; i-- > 0; )
+    {
+        if ( parents[i] != InvalidIndex )
+            subtreeEnds[parents[i]] = std::max( subtreeEnds[parents[i]], subtreeEnds[i] );
+    }
+
+    // Rebuild the mesh arrays in node order, so the meshes of a subtree are stored in a contiguous range.
+    meshes.clear();
+    for ( uint32_t i = 0; i < newNodeCount; ++i )
+    {
+        const auto& nodeMeshes = nodes[i]->meshes;
+
+        meshRanges[i].first = static_cast<uint32_t>( meshes.size() );
+        meshRanges[i].count = static_cast<uint32_t>( nodeMeshes.size() );
+        meshes.insert( meshes.end(), nodeMeshes.begin(), nodeMeshes.end() );
+    }
+    meshWorldBounds.resize( meshes.size() );
+
+    sortDirty   = false;
+    boundsDirty = true;
+}
@@ -1,11 +1,33 @@
+#include <WebGPUlib/Frustum.hpp>
+#include <WebGPUlib/Mesh.hpp>
 #include <WebGPUlib/SceneNode.hpp>
 
+#include <algorithm>
+
 using namespace WebGPUlib;
 
 SceneNode::SceneNode( const glm::mat4& localTransform )
-: localTransform { localTransform }
+: sceneGraph { std::make_shared<SceneGraph>() }
+{
+    index = sceneGraph->addNode( this, localTransform, glm::inverse( localTransform ), 0 );
+}
+
+SceneNode::~SceneNode()
 {
-    inverseTransform = glm::inverse( localTransform );
+    // Children that are still owned by other nodes become roots of their own scene graph.
+    // The other children are destroyed with this node.
+    for ( auto& child: children )
+    {
+        if ( child->sceneGraph != sceneGraph || sceneGraph->parents[child->index] != index )
+            continue;
+
+        if ( child.use_count() > 1 )
+            SceneGraph::moveSubtree( *child, std::make_shared<SceneGraph>(), SceneGraph::InvalidIndex );
+        else
+            sceneGraph->setParent( child->index, SceneGraph::InvalidIndex );
+    }
+
+    sceneGraph->removeNode( index );
 }
 
 void SceneNode::setName( const std::string& _name )
@@ -18,67 +40,81 @@ const std::string& SceneNode::getName() const
     return name;
 }
 
-void SceneNode::setLocalTransform( const glm::mat4& _localTransform )
+void SceneNode::setLocalTransform( const glm::mat4& localTransform )
 {
-    localTransform   = _localTransform;
-    inverseTransform = glm::inverse( localTransform );
+    sceneGraph->setLocalTransform( index, localTransform );
 }
 
 const glm::mat4& SceneNode::getLocalTransform() const
 {
-    return localTransform;
+    return sceneGraph->localTransforms[index];
 }
 
 const glm::mat4& SceneNode::getInverseLocalTransform() const
 {
-    return inverseTransform;
+    return sceneGraph->inverseLocalTransforms[index];
 }
 
-glm::mat4 SceneNode::getWorldTransform() const
+const glm::mat4& SceneNode::getWorldTransform() const
 {
-    return getParentWorldTransform() * localTransform;
+    sceneGraph->updateWorldTransform( index );
+
+    return sceneGraph->worldTransforms[index];
 }
 
-glm::mat4 SceneNode::getInverseWorldTransform() const
+const glm::mat4& SceneNode::getInverseWorldTransform() const
 {
-    return glm::inverse( getWorldTransform() );
+    sceneGraph->updateWorldTransform( index );
+
+    return sceneGraph->inverseWorldTransforms[index];
+}
+
+void SceneNode::updateWorldTransforms()
+{
+    sceneGraph->update();
+}
+
+const BoundingBox& SceneNode::getWorldBounds() const
+{
+    return sceneGraph->worldBounds[index];
+}
+
+void SceneNode::cull( const Frustum& frustum, std::vector<VisibleMesh>& visibleMeshes ) const
+{
+    sceneGraph->cull( index, frustum, visibleMeshes );
 }
 
 void SceneNode::addChild( std::shared_ptr<SceneNode> child )
 {
-    if (child)
-    {
-        auto iter = std::find( children.begin(), children.end(), child );
-        if (iter == children.end())
-        {
-            child->parent = shared_from_this();
-            glm::mat4 worldTransform = child->getWorldTransform();
-            glm::mat4 _localTransform = getInverseWorldTransform() * worldTransform;
-            child->setLocalTransform( _localTransform );
-            children.push_back( child );
-        }
-    }
+    if ( !child || child.get() == this || child->parent.lock().get() == this )
+        return;
+
+    const glm::mat4 worldTransform = child->getWorldTransform();
+
+    // Detach the child from its current parent first, so it is only owned by one node.
+    // The child stays in its scene graph until it is moved to the scene graph of this node.
+    child->detachFromParent();
+
+    child->parent = shared_from_this();
+    if ( child->sceneGraph != sceneGraph )
+        SceneGraph::moveSubtree( *child, sceneGraph, index );
+    else
+        sceneGraph->setParent( child->index, index );
+
+    child->setLocalTransform( getInverseWorldTransform() * worldTransform );
+    child->childIndex = children.size();
+    children.push_back( std::move( child ) );
 }
 
 void SceneNode::removeChild( std::shared_ptr<SceneNode> child )
 {
-    if (child)
-    {
-        auto iter = std::find( children.begin(), children.end(), child );
-        if (iter != children.end())
-        {
-            child->setParent( nullptr );
-            children.erase( iter );
-        }
-        else
-        {
-            // Not a direct child of this node. Search lower in the scene hierarchy.
-            for (auto& c : children )
-            {
-                c->removeChild( child );
-            }
-        }
-    }
+    if ( !child || child.get() == this )
+        return;
+
+    // The child can also be lower in the scene hierarchy. A scene graph stores a single tree,
+    // so the child is a descendant if it is stored in the subtree range of this node.
+    if ( child->parent.lock().get() == this || sceneGraph->isInSubtree( this, child.get() ) )
+        child->setParent( nullptr );
 }
 
 const std::vector<std::shared_ptr<SceneNode>>& SceneNode::getChildren() const
@@ -93,20 +129,41 @@ void SceneNode::setParent( std::shared_ptr<SceneNode> _parent )
     // To ensure this doesn't happen, we need to store a shared pointer to myself
     // until the new parent takes ownership.
     auto me = shared_from_this();
-    if (_parent)
+    if ( _parent )
     {
         _parent->addChild( me );
     }
-    else if (auto currentParent = parent.lock())
+    else if ( auto currentParent = parent.lock() )
     {
-        // Remove this node from its current parent.
-        auto worldTransform = getWorldTransform();
-        currentParent->removeChild( me );
+        const glm::mat4 worldTransform = getWorldTransform();
+
+        detachFromParent();
+
+        // The subtree of this node moves to its own scene graph, so it is no longer updated and culled
+        // with the scene graph of the parent.
+        SceneGraph::moveSubtree( *this, std::make_shared<SceneGraph>(), SceneGraph::InvalidIndex );
         setLocalTransform( worldTransform );
-        parent.reset();
     }
 }
 
+void SceneNode::detachFromParent()
+{
+    auto currentParent = parent.lock();
+    if ( !currentParent )
+        return;
+
+    // Remove this node from the children of its parent by moving the last sibling into its slot.
+    auto& siblings = currentParent->children;
+    if ( childIndex != siblings.size() - 1 )
+    {
+        siblings[childIndex]             = std::move( siblings.back() );
+        siblings[childIndex]->childIndex = childIndex;
+    }
+    siblings.pop_back();
+
+    parent.reset();
+}
+
 std::shared_ptr<SceneNode> SceneNode::getParent() const
 {
     return parent.lock();
@@ -119,6 +176,10 @@ void SceneNode::addMesh( std::shared_ptr<Mesh> mesh )
     if (iter == meshes.end())
     {
         meshes.push_back( std::move(mesh) );
+
+        // The mesh arrays of the scene graph are rebuilt on the next update.
+        sceneGraph->sortDirty   = true;
+        sceneGraph->boundsDirty = true;
     }
 }
 
@@ -126,14 +187,3 @@ const std::vector<std::shared_ptr<Mesh>>& SceneNode::getMeshes() const
 {
     return meshes;
 }
-
-glm::mat4 SceneNode::getParentWorldTransform() const
-{
-    glm::mat4 parentTransform { 1 };
-    if ( auto parentNode = parent.lock() )
-    {
-        parentTransform = parentNode->getWorldTransform();
-    }
-
-    return parentTransform;
-}
\ No newline at end of file
@@ -0,0 +1,73 @@
+#include <WebGPUlib/Hash.hpp>
+#include <WebGPUlib/Texture.hpp>
+#include <WebGPUlib/TextureCache.hpp>
+
+#include <algorithm>
+#include <system_error>
+
+using namespace WebGPUlib;
+namespace fs = std::filesystem;
+
+TextureCache::Key TextureCache::getKey( const std::filesystem::path& _filePath, const TextureLoadOptions& options )
+{
+    auto filePath = _filePath.string();
+    // Replace double backslashes in the file path.
+    // This is required on POSIX systems (like Emscripten).
+    std::replace( filePath.begin(), filePath.end(), '\\', '/' );
+
+    std::error_code ec;
+    fs::path        canonicalPath = fs::weakly_canonical( filePath, ec );
+    if ( ec )
+        canonicalPath = fs::path( filePath ).lexically_normal();
+
+    return { canonicalPath.generic_string(), options };
+}
+
+std::shared_ptr<Texture> TextureCache::find( const Key& key )
+{
+    auto it = textures.find( key );
+    if ( it == textures.end() )
+        return nullptr;
+
+    auto texture = it->second.lock();
+    if ( !texture )
+    {
+        // The texture has been released.
+        textures.erase( it );
+        return nullptr;
+    }
+
+    ++hitCount;
+
+    return texture;
+}
+
+void TextureCache::insert( const Key& key, const std::shared_ptr<Texture>& texture )
+{
+    if ( !texture )
+        return;
+
+    textures[key] = texture;
+    ++missCount;
+}
+
+void TextureCache::purge()
+{
+    for ( auto it = textures.begin(); it != textures.end(); )
+    {
+        if ( it->second.expired() )
+            it = textures.erase( it );
+        else
+            ++it;
+    }
+}
+
+std::size_t TextureCache::KeyHash::operator()( const Key& key ) const noexcept
+{
+    std::size_t seed = 0;
+    std::hash_combine( seed, key.filePath );
+    std::hash_combine( seed, key.options.generateMips );
+    std::hash_combine( seed, key.options.compress );
+    std::hash_combine( seed, key.options.normalMap );
+    return seed;
+}
@@ -0,0 +1,289 @@
+#include <WebGPUlib/TextureCompression.hpp>
+
+#include <stb_dxt.h>
+#include <stb_image_resize2.h>
+
+#include <algorithm>
+#include <fstream>
+
+using namespace WebGPUlib;
+
+namespace
+{
+// The formats are stored in the cache file with their own values,
+// because the values of WGPUTextureFormat differ between WebGPU implementations.
+enum class CacheFormat : uint32_t
+{
+    BC1 = 1,
+    BC3 = 3,
+    BC5 = 5,
+};
+
+struct CacheFileHeader
+{
+    static constexpr uint32_t Magic   = 0x54434257;  // "WBCT"
+    static constexpr uint32_t Version = 1;
+
+    uint32_t magic       = Magic;
+    uint32_t version     = Version;
+    uint64_t contentHash = 0;
+    uint32_t format      = 0;
+    uint32_t width       = 0;
+    uint32_t height      = 0;
+    uint32_t mipCount    = 0;
+};
+
+uint32_t bytesPerBlock( WGPUTextureFormat format ) noexcept
+{
+    return format == WGPUTextureFormat_BC1RGBAUnorm ? 8u : 16u;
+}
+
+std::size_t mipSizeInBytes( WGPUTextureFormat format, uint32_t width, uint32_t height, uint32_t mip ) noexcept
+{
+    const uint32_t w = std::max( width >> mip, 1u );
+    const uint32_t h = std::max( height >> mip, 1u );
+
+    return static_cast<std::size_t>( ( w + 3 ) / 4 ) * ( ( h + 3 ) / 4 ) * bytesPerBlock( format );
+}
+
+// The number of mips of a compressed image (the full mip chain, or only mip 0).
+uint32_t getMipCount( uint32_t width, uint32_t height, bool generateMips ) noexcept
+{
+    uint32_t mipCount = 1;
+    if ( generateMips )
+    {
+        while ( ( std::max( width, height ) >> mipCount ) > 0 )
+            ++mipCount;
+    }
+
+    return mipCount;
+}
+
+std::vector<uint8_t> compressMip( const uint8_t* pixels, uint32_t width, uint32_t height, WGPUTextureFormat format )
+{
+    const uint32_t blocksX = ( width + 3 ) / 4;
+    const uint32_t blocksY = ( height + 3 ) / 4;
+    const uint32_t size    = bytesPerBlock( format );
+
+    std::vector<uint8_t> blocks( static_cast<std::size_t>( blocksX ) * blocksY * size );
+
+    uint8_t* dst = blocks.data();
+    for ( uint32_t by = 0; by < blocksY; ++by )
+    {
+        for ( uint32_t bx = 0; bx < blocksX; ++bx )
+        {
+            // Mips that are smaller than a block repeat the last row and column.
+            uint8_t rgba[16 * 4];
+            uint8_t rg[16 * 2];
+            for ( uint32_t y = 0; y < 4; ++y )
+            {
+                for ( uint32_t x = 0; x < 4; ++x )
+                {
+                    const uint32_t px  = std::min( bx * 4 + x, width - 1 );
+                    const uint32_t py  = std::min( by * 4 + y, height - 1 );
+                    const uint8_t* src = pixels + ( static_cast<std::size_t>( py ) * width + px ) * 4;
+                    const uint32_t i   = y * 4 + x;
+
+                    std::copy_n( src, 4, rgba + i * 4 );
+                    rg[i * 2 + 0] = src[0];
+                    rg[i * 2 + 1] = src[1];
+                }
+            }
+
+            switch ( format )
+            {
+            case WGPUTextureFormat_BC1RGBAUnorm:
+                stb_compress_dxt_block( dst, rgba, 0, STB_DXT_HIGHQUAL );
+                break;
+            case WGPUTextureFormat_BC3RGBAUnorm:
+                stb_compress_dxt_block( dst, rgba, 1, STB_DXT_HIGHQUAL );
+                break;
+            default:
+                stb_compress_bc5_block( dst, rg );
+                break;
+            }
+
+            dst += size;
+        }
+    }
+
+    return blocks;
+}
+}  // namespace
+
+std::size_t CompressedImage::getSizeInBytes() const noexcept
+{
+    std::size_t size = 0;
+    for ( auto& mip: mips )
+    {
+        size += mip.size();
+    }
+
+    return size;
+}
+
+bool WebGPUlib::canCompressImage( uint32_t width, uint32_t height ) noexcept
+{
+    return width > 0 && height > 0 && width % 4 == 0 && height % 4 == 0;
+}
+
+CompressedImage WebGPUlib::compressImage( const uint8_t* pixels, uint32_t width, uint32_t height, bool normalMap,
+                                          bool generateMips )
+{
+    CompressedImage image;
+    image.width  = width;
+    image.height = height;
+
+    if ( normalMap )
+    {
+        image.format = WGPUTextureFormat_BC5RGUnorm;
+    }
+    else
+    {
+        // Use BC3 only if the image has (non-opaque) alpha.
+        const std::size_t pixelCount = static_cast<std::size_t>( width ) * height;
+        bool              hasAlpha   = false;
+        for ( std::size_t i = 0; i < pixelCount && !hasAlpha; ++i )
+        {
+            hasAlpha = pixels[i * 4 + 3] != 255;
+        }
+
+        image.format = hasAlpha ? WGPUTextureFormat_BC3RGBAUnorm : WGPUTextureFormat_BC1RGBAUnorm;
+    }
+
+    const uint32_t mipCount = getMipCount( width, height, generateMips );
+
+    image.mips.reserve( mipCount );
+    image.mips.push_back( compressMip( pixels, width, height, image.format ) );
+
+    // Each mip is downsampled from the previous mip.
+    // Normal maps are resampled without alpha weighting, since the alpha channel is not used.
+    const stbir_pixel_layout layout = normalMap ? STBIR_4CHANNEL : STBIR_RGBA;
+
+    std::vector<uint8_t> src( pixels, pixels + static_cast<std::size_t>( width ) * height * 4 );
+    std::vector<uint8_t> dst;
+
+    for ( uint32_t mip = 1; mip < mipCount; ++mip )
+    {
+        const uint32_t srcWidth  = std::max( width >> ( mip - 1 ), 1u );
+        const uint32_t srcHeight = std::max( height >> ( mip - 1 ), 1u );
+        const uint32_t dstWidth  = std::max( width >> mip, 1u );
+        const uint32_t dstHeight = std::max( height >> mip, 1u );
+
+        dst.resize( static_cast<std::size_t>( dstWidth ) * dstHeight * 4 );
+        stbir_resize_uint8_linear( src.data(), static_cast<int>( srcWidth ), static_cast<int>( srcHeight ), 0,
+                                   dst.data(), static_cast<int>( dstWidth ), static_cast<int>( dstHeight ), 0,
+                                   layout );
+
+        image.mips.push_back( compressMip( dst.data(), dstWidth, dstHeight, image.format ) );
+
+        std::swap( src, dst );
+    }
+
+    return image;
+}
+
+uint64_t WebGPUlib::hashFileContents( const void* data, std::size_t size ) noexcept
+{
+    constexpr uint64_t FNVOffsetBasis = 0xcbf29ce484222325ull;
+    constexpr uint64_t FNVPrime       = 0x100000001b3ull;
+
+    const auto* bytes = static_cast<const uint8_t*>( data );
+    uint64_t    hash  = FNVOffsetBasis;
+    for ( std::size_t i = 0; i < size; ++i )
+    {
+        hash ^= bytes[i];
+        hash *= FNVPrime;
+    }
+
+    return hash;
+}
+
+bool WebGPUlib::loadCompressedImage( const std::filesystem::path& cacheFilePath, uint64_t contentHash,
+                                     bool generateMips, CompressedImage& image )
+{
+    std::ifstream file( cacheFilePath, std::ios::binary );
+    if ( !file )
+        return false;
+
+    CacheFileHeader header {};
+    if ( !file.read( reinterpret_cast<char*>( &header ), sizeof( header ) ) )
+        return false;
+
+    if ( header.magic != CacheFileHeader::Magic || header.version != CacheFileHeader::Version ||
+         header.contentHash != contentHash )
+        return false;
+
+    // The cache file is only used if it has the requested mips.
+    if ( header.mipCount != getMipCount( header.width, header.height, generateMips ) )
+        return false;
+
+    switch ( static_cast<CacheFormat>( header.format ) )
+    {
+    case CacheFormat::BC1:
+        image.format = WGPUTextureFormat_BC1RGBAUnorm;
+        break;
+    case CacheFormat::BC3:
+        image.format = WGPUTextureFormat_BC3RGBAUnorm;
+        break;
+    case CacheFormat::BC5:
+        image.format = WGPUTextureFormat_BC5RGUnorm;
+        break;
+    default:
+        return false;
+    }
+
+    image.width  = header.width;
+    image.height = header.height;
+    image.mips.resize( header.mipCount );
+
+    for ( uint32_t mip = 0; mip < header.mipCount; ++mip )
+    {
+        image.mips[mip].resize( mipSizeInBytes( image.format, image.width, image.height, mip ) );
+        if ( !file.read( reinterpret_cast<char*>( image.mips[mip].data() ),
+                         static_cast<std::streamsize>( image.mips[mip].size() ) ) )
+        {
+            image = {};
+            return false;
+        }
+    }
+
+    return true;
+}
+
+bool WebGPUlib::saveCompressedImage( const std::filesystem::path& cacheFilePath, uint64_t contentHash,
+                                     const CompressedImage& image )
+{
+    CacheFileHeader header {};
+    header.contentHash = contentHash;
+    header.width       = image.width;
+    header.height      = image.height;
+    header.mipCount    = static_cast<uint32_t>( image.mips.size() );
+
+    switch ( image.format )
+    {
+    case WGPUTextureFormat_BC1RGBAUnorm:
+        header.format = static_cast<uint32_t>( CacheFormat::BC1 );
+        break;
+    case WGPUTextureFormat_BC3RGBAUnorm:
+        header.format = static_cast<uint32_t>( CacheFormat::BC3 );
+        break;
+    case WGPUTextureFormat_BC5RGUnorm:
+        header.format = static_cast<uint32_t>( CacheFormat::BC5 );
+        break;
+    default:
+        return false;
+    }
+
+    std::ofstream file( cacheFilePath, std::ios::binary | std::ios::trunc );
+    if ( !file )
+        return false;
+
+    file.write( reinterpret_cast<const char*>( &header ), sizeof( header ) );
+    for ( auto& mip: image.mips )
+    {
+        file.write( reinterpret_cast<const char*>( mip.data() ), static_cast<std::streamsize>( mip.size() ) );
+    }
+
+    return static_cast<bool>( file );
+}
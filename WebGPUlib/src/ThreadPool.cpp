@@ -0,0 +1,49 @@
+#include <WebGPUlib/ThreadPool.hpp>
+
+using namespace WebGPUlib;
+
+ThreadPool::ThreadPool( std::size_t threadCount )
+{
+    threads.reserve( threadCount );
+
+    for ( std::size_t i = 0; i < threadCount; ++i )
+    {
+        threads.emplace_back( &ThreadPool::workerThread, this );
+    }
+}
+
+ThreadPool::~ThreadPool()
+{
+    {
+        std::lock_guard lock { mutex };
+        stopping = true;
+    }
+    condition.notify_all();
+
+    // Workers finish the remaining tasks before they exit.
+    for ( auto& thread: threads )
+    {
+        thread.join();
+    }
+}
+
+void ThreadPool::workerThread()
+{
+    while ( true )
+    {
+        std::function<void()> task;
+
+        {
+            std::unique_lock lock { mutex };
+            condition.wait( lock, [this] { return stopping || !tasks.empty(); } );
+
+            if ( tasks.empty() )
+                return;  // Stopping and no more work to do.
+
+            task = std::move( tasks.front() );
+            tasks.pop_front();
+        }
+
+        task();
+    }
+}
@@ -0,0 +1,163 @@
+#include <WebGPUlib/Device.hpp>
+#include <WebGPUlib/Helpers.hpp>
+#include <WebGPUlib/Queue.hpp>
+#include <WebGPUlib/UploadPagePool.hpp>
+
+#include <algorithm>
+#include <iostream>
+#include <new>
+
+using namespace WebGPUlib;
+
+UploadPagePool::Page::Page( WGPUBufferUsage _usage, std::size_t sizeInBytes )
+: usage( _usage )
+, pageSize( sizeInBytes )
+, shadow( sizeInBytes )
+{
+    WGPUBufferDescriptor desc {};
+    desc.label            = "UploadPagePool::Page";
+    desc.usage            = usage | WGPUBufferUsage_CopyDst;
+    desc.size             = sizeInBytes;
+    desc.mappedAtCreation = false;
+
+    buffer = wgpuDeviceCreateBuffer( Device::get().getWGPUDevice(), &desc );
+}
+
+UploadPagePool::Page::~Page()
+{
+    if ( buffer )
+    {
+        wgpuBufferRelease( buffer );
+    }
+}
+
+bool UploadPagePool::Page::hasSpace( std::size_t sizeInBytes, std::size_t alignment ) const
+{
+    std::size_t alignedSize   = AlignUp( sizeInBytes, alignment );
+    std::size_t alignedOffset = AlignUp( offset, alignment );
+
+    return alignedOffset + alignedSize <= pageSize;
+}
+
+std::size_t UploadPagePool::Page::allocate( std::size_t sizeInBytes, std::size_t alignment )
+{
+    if ( !hasSpace( sizeInBytes, alignment ) )
+    {
+        throw std::bad_alloc();
+    }
+
+    std::size_t alignedSize = AlignUp( sizeInBytes, alignment );
+    offset                  = AlignUp( offset, alignment );
+
+    std::size_t allocationOffset = offset;
+
+    offset += alignedSize;
+
+    // Extend the dirty range to include the new allocation.
+    if ( dirtyBegin == dirtyEnd )
+        dirtyBegin = allocationOffset;
+    dirtyEnd = allocationOffset + sizeInBytes;
+    ++pendingAllocationCount;
+
+    return allocationOffset;
+}
+
+std::size_t UploadPagePool::Page::flush( const Queue& queue )
+{
+    if ( dirtyBegin == dirtyEnd )
+        return 0;
+
+    // The size of a queue write must be a multiple of 4 bytes.
+    std::size_t size = std::min( AlignUp( dirtyEnd, 4 ), pageSize ) - dirtyBegin;
+
+    queue.writeBuffer( buffer, shadow.data() + dirtyBegin, size, dirtyBegin );
+
+    dirtyBegin             = offset;
+    dirtyEnd               = offset;
+    pendingAllocationCount = 0;
+
+    return size;
+}
+
+void UploadPagePool::Page::reset()
+{
+    offset                 = 0;
+    dirtyBegin             = 0;
+    dirtyEnd               = 0;
+    pendingAllocationCount = 0;
+}
+
+std::shared_ptr<UploadPagePool::Page> UploadPagePool::requestPage( WGPUBufferUsage usage, std::size_t pageSize )
+{
+    for ( auto it = freePages.begin(); it != freePages.end(); ++it )
+    {
+        if ( ( *it )->getUsage() == usage && ( *it )->getPageSize() == pageSize )
+        {
+            auto page = *it;
+            freePages.erase( it );
+            return page;
+        }
+    }
+
+    ++createdPageCount;
+
+    return std::make_shared<Page>( usage, pageSize );
+}
+
+void UploadPagePool::retirePages( const Queue& queue, PageList&& pages )
+{
+    if ( pages.empty() )
+        return;
+
+    PendingPages pending;
+    pending.fenceValue = ++submittedFenceValue;
+    pending.pages      = std::move( pages );
+    pendingPages.push_back( std::move( pending ) );
+
+    // Work done callbacks are called in the order they were requested.
+    wgpuQueueOnSubmittedWorkDone( queue.getWGPUQueue(), onSubmittedWorkDone, this );
+}
+
+void UploadPagePool::flushPages( const Queue& queue, const PageList& pages )
+{
+    for ( auto& page: pages )
+    {
+        currentStatistics.allocationCount += page->getPendingAllocationCount();
+
+        if ( std::size_t bytesWritten = page->flush( queue ) )
+        {
+            ++currentStatistics.queueWriteCount;
+            currentStatistics.bytesWritten += bytesWritten;
+        }
+    }
+}
+
+void UploadPagePool::endFrame()
+{
+    frameStatistics   = currentStatistics;
+    currentStatistics = {};
+}
+
+void UploadPagePool::onSubmittedWorkDone( WGPUQueueWorkDoneStatus status, void* userdata )
+{
+    auto& pool = *static_cast<UploadPagePool*>( userdata );
+
+    if ( status != WGPUQueueWorkDoneStatus_Success )
+    {
+        std::cerr << "ERROR: Queue work done status: " << status << std::endl;
+    }
+
+    ++pool.completedFenceValue;
+
+    // Pages used by completed work can be reused.
+    while ( !pool.pendingPages.empty() && pool.pendingPages.front().fenceValue <= pool.completedFenceValue )
+    {
+        for ( auto& page: pool.pendingPages.front().pages )
+        {
+            page->reset();
+            pool.freePages.push_back( std::move( page ) );
+        }
+
+        pool.pendingPages.pop_front();
+    }
+}
@@ -1,5 +1,11 @@
 #include <WebGPUlib/Vertex.hpp>
 
+#include <glm/geometric.hpp>
+#include <glm/packing.hpp>
+#include <glm/vec2.hpp>
+#include <glm/vec4.hpp>
+
+#include <cmath>
 #include <cstddef>
 
 using namespace WebGPUlib;
@@ -48,4 +54,70 @@ WGPUVertexAttribute VertexPositionNormalTangentBitangentTexture::attributes[5] =
         offsetof(VertexPositionNormalTangentBitangentTexture, texCoord),
         4
     }
-};
\ No newline at end of file
+};
+
+WGPUVertexAttribute VertexPositionPackedNormalTangentTexture::attributes[4] = {
+    {
+        WGPUVertexFormat_Float32x3,
+        offsetof( VertexPositionPackedNormalTangentTexture, position ),
+        0,
+    },
+    {
+        WGPUVertexFormat_Snorm16x2,
+        offsetof( VertexPositionPackedNormalTangentTexture, normal ),
+        1
+    },
+    {
+        WGPUVertexFormat_Snorm8x4,
+        offsetof( VertexPositionPackedNormalTangentTexture, tangent ),
+        2
+    },
+    {
+        WGPUVertexFormat_Float16x2,
+        offsetof( VertexPositionPackedNormalTangentTexture, texCoord ),
+        3
+    }
+};
+
+// Map a unit vector onto the octahedron and unfold the lower half onto the square [-1, 1]^2.
+static glm::vec2 octahedralEncode( const glm::vec3& n )
+{
+    const float l1 = std::abs( n.x ) + std::abs( n.y ) + std::abs( n.z );
+    if ( l1 == 0.0f )
+        return glm::vec2 { 0.0f, 0.0f };
+
+    glm::vec2 p { n.x / l1, n.y / l1 };
+
+    if ( n.z < 0.0f )
+    {
+        const float x = ( 1.0f - std::abs( p.y ) ) * ( p.x >= 0.0f ? 1.0f : -1.0f );
+        const float y = ( 1.0f - std::abs( p.x ) ) * ( p.y >= 0.0f ? 1.0f : -1.0f );
+        p             = glm::vec2 { x, y };
+    }
+
+    return p;
+}
+
+// Get any unit vector that is perpendicular to n.
+static glm::vec3 perpendicular( const glm::vec3& n )
+{
+    const glm::vec3 axis = std::abs( n.x ) < 0.9f ? glm::vec3 { 1, 0, 0 } : glm::vec3 { 0, 1, 0 };
+    return glm::normalize( glm::cross( axis, n ) );
+}
+
+VertexPositionPackedNormalTangentTexture::VertexPositionPackedNormalTangentTexture(
+    const VertexPositionNormalTangentBitangentTexture& vertex )
+: position( vertex.position )
+{
+    glm::vec3 n = glm::length( vertex.normal ) > 0.0f ? glm::normalize( vertex.normal ) : glm::vec3 { 0, 0, 1 };
+
+    // Gram-Schmidt orthogonalize the tangent. Vertices without a tangent get an arbitrary one.
+    glm::vec3 t = vertex.tangent - n * glm::dot( n, vertex.tangent );
+    t           = glm::length( t ) > 1e-6f ? glm::normalize( t ) : perpendicular( n );
+
+    const float handedness = glm::dot( glm::cross( n, t ), vertex.bitangent ) < 0.0f ? -1.0f : 1.0f;
+
+    normal   = glm::packSnorm2x16( octahedralEncode( n ) );
+    tangent  = glm::packSnorm4x8( glm::vec4 { t, handedness } );
+    texCoord = glm::packHalf2x16( glm::vec2 { vertex.texCoord.x, vertex.texCoord.y } );
+}
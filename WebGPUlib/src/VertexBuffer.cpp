@@ -1,11 +1,20 @@
+#include <WebGPUlib/BufferArena.hpp>
 #include <WebGPUlib/VertexBuffer.hpp>
 
 #include <utility>
 
 using namespace WebGPUlib;
 
-VertexBuffer::VertexBuffer( WGPUBuffer&& _buffer, std::size_t _vertexCount, std::size_t _vertexStride )  // NOLINT(cppcoreguidelines-rvalue-reference-param-not-moved)
-: Buffer( std::move(_buffer) )  // NOLINT(performance-move-const-arg)
+VertexBuffer::VertexBuffer( WGPUBuffer&& _buffer, std::size_t _vertexCount, std::size_t _vertexStride, std::shared_ptr<BufferArena> _arena, uint64_t _offset )  // NOLINT(cppcoreguidelines-rvalue-reference-param-not-moved)
+: Buffer( std::move(_buffer), _offset )  // NOLINT(performance-move-const-arg)
 , vertexCount( _vertexCount )
 , vertexStride( _vertexStride )
+, arena( std::move( _arena ) )
 {}
+
+VertexBuffer::~VertexBuffer()
+{
+    // Return the range to the arena.
+    if ( arena )
+        arena->free( getOffset(), getSize() );
+}
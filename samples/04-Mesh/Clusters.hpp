@@ -0,0 +1,40 @@
+#pragma once
+
+#include <glm/mat4x4.hpp>
+#include <glm/vec2.hpp>
+#include <glm/vec4.hpp>
+
+#include <cstdint>
+
+// The view frustum is divided into a grid of clusters (froxels).
+// Clusters are tiled in screen space and sliced exponentially in depth.
+constexpr uint32_t CLUSTER_GRID_X = 16;
+constexpr uint32_t CLUSTER_GRID_Y = 9;
+constexpr uint32_t CLUSTER_GRID_Z = 24;
+constexpr uint32_t CLUSTER_COUNT  = CLUSTER_GRID_X * CLUSTER_GRID_Y * CLUSTER_GRID_Z;
+
+// Each cluster stores a fixed size list of light indices.
+// Lights that don't fit in the list are ignored for that cluster.
+constexpr uint32_t MAX_LIGHTS_PER_CLUSTER = 128;
+
+// The number of threads per dimension of the light culling compute shader.
+// Must match the workgroup size in LightCullingShader.wgsl.
+constexpr uint32_t LIGHT_CULLING_GROUP_SIZE = 4;
+
+struct ClusterParameters
+{
+    glm::mat4 inverseProjection;
+    //----------------------------------- (16 byte boundary)
+    glm::uvec4 gridSize;  // xyz: Number of clusters, w: max lights per cluster.
+    //----------------------------------- (16 byte boundary)
+    glm::vec2 screenSize;
+    float     near;
+    float     far;
+    //----------------------------------- (16 byte boundary)
+    float    sliceScale;  // Maps log(depth) to the depth slice of the cluster.
+    float    sliceBias;
+    uint32_t pointLightCount;
+    uint32_t spotLightCount;
+    //----------------------------------- (16 byte boundary)
+    // Total:                              16 * 7 = 112 bytes
+};
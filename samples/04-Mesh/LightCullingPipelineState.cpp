@@ -0,0 +1,99 @@
+#include "LightCullingPipelineState.hpp"
+#include "Clusters.hpp"
+#include "Light.hpp"
+
+#include <WebGPUlib/ComputeCommandBuffer.hpp>
+#include <WebGPUlib/Device.hpp>
+
+#include <iterator>
+
+using namespace WebGPUlib;
+
+LightCullingPipelineState::LightCullingPipelineState()
+{
+    const char* shaderCode = {
+#include "LightCullingShader.wgsl"
+    };
+
+    WGPUDevice device = Device::get().getWGPUDevice();
+
+    // Load the compute shader module.
+    WGPUShaderModuleWGSLDescriptor shaderCodeDesc {};
+    shaderCodeDesc.chain.sType = WGPUSType_ShaderModuleWGSLDescriptor;
+    shaderCodeDesc.chain.next  = nullptr;
+    shaderCodeDesc.code        = shaderCode;
+
+    WGPUShaderModuleDescriptor shaderModuleDescriptor {};
+    shaderModuleDescriptor.nextInChain = &shaderCodeDesc.chain;
+    shaderModuleDescriptor.label       = "Light Culling Shader Module";
+    WGPUShaderModule shaderModule      = wgpuDeviceCreateShaderModule( device, &shaderModuleDescriptor );
+
+    // Setup the binding layout.
+    WGPUBindGroupLayoutEntry bindGroupLayoutEntries[5] {};
+
+    // @group(0) @binding(0) var<uniform> clusters : Clusters;
+    bindGroupLayoutEntries[0].binding               = 0;
+    bindGroupLayoutEntries[0].visibility            = WGPUShaderStage_Compute;
+    bindGroupLayoutEntries[0].buffer.type           = WGPUBufferBindingType_Uniform;
+    bindGroupLayoutEntries[0].buffer.minBindingSize = sizeof( ClusterParameters );
+
+    // @group(0) @binding(1) var<storage> pointLights : array<PointLight>;
+    bindGroupLayoutEntries[1].binding               = 1;
+    bindGroupLayoutEntries[1].visibility            = WGPUShaderStage_Compute;
+    bindGroupLayoutEntries[1].buffer.type           = WGPUBufferBindingType_ReadOnlyStorage;
+    bindGroupLayoutEntries[1].buffer.minBindingSize = sizeof( PointLight );
+
+    // @group(0) @binding(2) var<storage> spotLights : array<SpotLight>;
+    bindGroupLayoutEntries[2].binding               = 2;
+    bindGroupLayoutEntries[2].visibility            = WGPUShaderStage_Compute;
+    bindGroupLayoutEntries[2].buffer.type           = WGPUBufferBindingType_ReadOnlyStorage;
+    bindGroupLayoutEntries[2].buffer.minBindingSize = sizeof( SpotLight );
+
+    // @group(0) @binding(3) var<storage, read_write> clusterLightCounts : array<vec2u>;
+    bindGroupLayoutEntries[3].binding               = 3;
+    bindGroupLayoutEntries[3].visibility            = WGPUShaderStage_Compute;
+    bindGroupLayoutEntries[3].buffer.type           = WGPUBufferBindingType_Storage;
+    bindGroupLayoutEntries[3].buffer.minBindingSize = 0;
+
+    // @group(0) @binding(4) var<storage, read_write> clusterLightIndices : array<u32>;
+    bindGroupLayoutEntries[4].binding               = 4;
+    bindGroupLayoutEntries[4].visibility            = WGPUShaderStage_Compute;
+    bindGroupLayoutEntries[4].buffer.type           = WGPUBufferBindingType_Storage;
+    bindGroupLayoutEntries[4].buffer.minBindingSize = 0;
+
+    WGPUBindGroupLayoutDescriptor bindGroupLayoutDescriptor {};
+    bindGroupLayoutDescriptor.label      = "Light Culling Bind Group Layout";
+    bindGroupLayoutDescriptor.entryCount = std::size( bindGroupLayoutEntries );
+    bindGroupLayoutDescriptor.entries    = bindGroupLayoutEntries;
+    bindGroupLayout                      = wgpuDeviceCreateBindGroupLayout( device, &bindGroupLayoutDescriptor );
+
+    // Setup the pipeline layout.
+    WGPUPipelineLayoutDescriptor pipelineLayoutDescriptor {};
+    pipelineLayoutDescriptor.label                = "Light Culling Pipeline Layout";
+    pipelineLayoutDescriptor.bindGroupLayoutCount = 1;
+    pipelineLayoutDescriptor.bindGroupLayouts     = &bindGroupLayout;
+    WGPUPipelineLayout pipelineLayout             = wgpuDeviceCreatePipelineLayout( device, &pipelineLayoutDescriptor );
+
+    // Setup the pipeline state.
+    WGPUComputePipelineDescriptor pipelineDescriptor {};
+    pipelineDescriptor.label              = "Light Culling Pipeline";
+    pipelineDescriptor.layout             = pipelineLayout;
+    pipelineDescriptor.compute.module     = shaderModule;
+    pipelineDescriptor.compute.entryPoint = "main";
+    pipeline                              = wgpuDeviceCreateComputePipeline( device, &pipelineDescriptor );
+
+    wgpuShaderModuleRelease( shaderModule );
+    wgpuPipelineLayoutRelease( pipelineLayout );
+}
+
+LightCullingPipelineState::~LightCullingPipelineState()
+{
+    if ( bindGroupLayout )
+        wgpuBindGroupLayoutRelease( bindGroupLayout );
+}
+
+void LightCullingPipelineState::bind( ComputeCommandBuffer& commandBuffer )
+{
+    auto passEncoder = commandBuffer.getWGPUPassEncoder();
+    wgpuComputePassEncoderSetPipeline( passEncoder, pipeline );
+}
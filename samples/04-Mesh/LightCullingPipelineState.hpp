@@ -0,0 +1,32 @@
+#pragma once
+
+#include <WebGPUlib/ComputePipelineState.hpp>
+
+namespace WebGPUlib
+{
+
+// Assigns the point and spot lights to the clusters of the view frustum.
+class LightCullingPipelineState : public ComputePipelineState
+{
+public:
+    LightCullingPipelineState();
+    ~LightCullingPipelineState() override;
+
+    LightCullingPipelineState( const LightCullingPipelineState& )                = delete;
+    LightCullingPipelineState( LightCullingPipelineState&& ) noexcept            = delete;
+    LightCullingPipelineState& operator=( const LightCullingPipelineState& )     = delete;
+    LightCullingPipelineState& operator=( LightCullingPipelineState&& ) noexcept = delete;
+
+    WGPUBindGroupLayout getWGPUBindGroupLayout( uint32_t groupIndex ) override
+    {
+        // This pipeline only has a single bind group.
+        return bindGroupLayout;
+    }
+
+protected:
+    void bind( ComputeCommandBuffer& commandBuffer ) override;
+
+private:
+    WGPUBindGroupLayout bindGroupLayout = nullptr;
+};
+}  // namespace WebGPUlib
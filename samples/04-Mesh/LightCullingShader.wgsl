@@ -0,0 +1,176 @@
+R"(
+struct PointLight
+{
+    positionWS : vec4f,
+    //----------------------------------- (16 byte boundary)
+    positionVS : vec4f,
+    //----------------------------------- (16 byte boundary)
+    color : vec4f,
+    //----------------------------------- (16 byte boundary)
+    ambient : f32,
+    constantAttenuation : f32,
+    linearAttenuation : f32,
+    quadraticAttenuation : f32,
+    //----------------------------------- (16 byte boundary)
+    // Total:                              16 * 4 = 64 bytes
+};
+
+struct SpotLight
+{
+    positionWS : vec4f,
+    //----------------------------------- (16 byte boundary)
+    positionVS : vec4f,
+    //----------------------------------- (16 byte boundary)
+    directionWS : vec4f,
+    //----------------------------------- (16 byte boundary)
+    directionVS : vec4f,
+    //----------------------------------- (16 byte boundary)
+    color : vec4f,
+    //----------------------------------- (16 byte boundary)
+    ambient : f32,
+    spotAngle : f32,
+    constantAttenuation : f32,
+    linearAttenuation : f32,
+    //----------------------------------- (16 byte boundary)
+    quadraticAttenuation : f32,
+    //----------------------------------- (16 byte boundary)
+    // Total:                              16 * 7 = 112 bytes
+};
+
+struct Clusters
+{
+    inverseProjection : mat4x4f,
+    //----------------------------------- (16 byte boundary)
+    gridSize : vec4u, // xyz: Number of clusters, w: max lights per cluster.
+    //----------------------------------- (16 byte boundary)
+    screenSize : vec2f,
+    near : f32,
+    far : f32,
+    //----------------------------------- (16 byte boundary)
+    sliceScale : f32,
+    sliceBias : f32,
+    pointLightCount : u32,
+    spotLightCount : u32,
+    //----------------------------------- (16 byte boundary)
+    // Total:                              16 * 7 = 112 bytes
+};
+
+@group(0) @binding(0) var<uniform> clusters : Clusters;
+@group(0) @binding(1) var<storage> pointLights : array<PointLight>;
+@group(0) @binding(2) var<storage> spotLights : array<SpotLight>;
+
+// x: Number of point lights, y: Number of spot lights in each cluster.
+@group(0) @binding(3) var<storage, read_write> clusterLightCounts : array<vec2u>;
+// The point light indices followed by the spot light indices of each cluster.
+@group(0) @binding(4) var<storage, read_write> clusterLightIndices : array<u32>;
+
+// A light does not affect a cluster if its attenuation is below this threshold.
+const LIGHT_CUTOFF = 1.0 / 256.0;
+
+// The distance at which the attenuation of a light drops below the cutoff.
+fn LightRange( c : f32, l : f32, q : f32 ) -> f32
+{
+    // Solve c + l * d + q * d * d = 1 / LIGHT_CUTOFF for d.
+    let k = 1.0 / LIGHT_CUTOFF - c;
+
+    if ( k <= 0.0 )
+    {
+        return 0.0;
+    }
+    if ( q > 0.0 )
+    {
+        return ( -l + sqrt( l * l + 4.0 * q * k ) ) / ( 2.0 * q );
+    }
+    if ( l > 0.0 )
+    {
+        return k / l;
+    }
+
+    // The light is not attenuated.
+    return 3.40282347e+38;
+}
+
+// Convert a screen space position (in pixels) to a view space ray with z = -1.
+fn ScreenToViewRay( screen : vec2f ) -> vec3f
+{
+    let ndc = vec2f( screen.x / clusters.screenSize.x * 2.0 - 1.0, 1.0 - screen.y / clusters.screenSize.y * 2.0 );
+    let p = clusters.inverseProjection * vec4f( ndc, 0.0, 1.0 );
+    let v = p.xyz / p.w;
+
+    return v / -v.z;
+}
+
+// The view space distance to the near plane of a depth slice.
+fn SliceDepth( slice : u32 ) -> f32
+{
+    return clusters.near * pow( clusters.far / clusters.near, f32( slice ) / f32( clusters.gridSize.z ) );
+}
+
+fn SphereIntersectsAABB( center : vec3f, radius : f32, aabbMin : vec3f, aabbMax : vec3f ) -> bool
+{
+    let d = clamp( center, aabbMin, aabbMax ) - center;
+
+    return dot( d, d ) <= radius * radius;
+}
+
+@compute @workgroup_size(4, 4, 4)
+fn main( @builtin(global_invocation_id) id : vec3u )
+{
+    let gridSize = clusters.gridSize.xyz;
+
+    if ( any( id >= gridSize ) )
+    {
+        return;
+    }
+
+    // Compute the view space bounding box of the cluster.
+    let tileSize = clusters.screenSize / vec2f( gridSize.xy );
+    let minRay = ScreenToViewRay( vec2f( id.xy ) * tileSize );
+    let maxRay = ScreenToViewRay( vec2f( id.xy + 1 ) * tileSize );
+    let nearDepth = SliceDepth( id.z );
+    let farDepth = SliceDepth( id.z + 1 );
+
+    let p0 = minRay * nearDepth;
+    let p1 = maxRay * nearDepth;
+    let p2 = minRay * farDepth;
+    let p3 = maxRay * farDepth;
+
+    let aabbMin = min( min( p0, p1 ), min( p2, p3 ) );
+    let aabbMax = max( max( p0, p1 ), max( p2, p3 ) );
+
+    let clusterIndex = id.x + id.y * gridSize.x + id.z * gridSize.x * gridSize.y;
+    let maxLights = clusters.gridSize.w;
+    let offset = clusterIndex * maxLights;
+
+    var lightCount = 0u;
+
+    for ( var i = 0u; i < clusters.pointLightCount && lightCount < maxLights; i++ )
+    {
+        let light = pointLights[i];
+        let range = LightRange( light.constantAttenuation, light.linearAttenuation, light.quadraticAttenuation );
+
+        if ( SphereIntersectsAABB( light.positionVS.xyz, range, aabbMin, aabbMax ) )
+        {
+            clusterLightIndices[offset + lightCount] = i;
+            lightCount++;
+        }
+    }
+
+    let pointLightCount = lightCount;
+
+    // Spot lights are tested with the bounding sphere of the light (not the cone).
+    for ( var i = 0u; i < clusters.spotLightCount && lightCount < maxLights; i++ )
+    {
+        let light = spotLights[i];
+        let range = LightRange( light.constantAttenuation, light.linearAttenuation, light.quadraticAttenuation );
+
+        if ( SphereIntersectsAABB( light.positionVS.xyz, range, aabbMin, aabbMax ) )
+        {
+            clusterLightIndices[offset + lightCount] = i;
+            lightCount++;
+        }
+    }
+
+    clusterLightCounts[clusterIndex] = vec2u( pointLightCount, lightCount - pointLightCount );
+}
+)"
@@ -1,11 +1,27 @@
 #pragma once
 
 #include <glm/mat4x4.hpp>
+#include <glm/vec4.hpp>
 
+// Per-object matrices. These do not depend on the camera,
+// so they can be recorded in a render bundle.
 struct Matrices
 {
     glm::mat4 model;
-    glm::mat4 modelView;
-    glm::mat4 modelViewIT;
-    glm::mat4 modelViewProjection;
+    glm::mat4 modelIT;  // Inverse-transpose
+};
+
+// Per-instance data for instanced draws of the unlit pipeline.
+struct InstanceData
+{
+    glm::mat4 model;
+    glm::vec4 color;
+};
+
+// Per-frame camera matrices.
+struct CameraMatrices
+{
+    glm::mat4 view;
+    glm::mat4 projection;
+    glm::mat4 viewProjection;
 };
\ No newline at end of file
@@ -1,11 +1,11 @@
 #include "TextureLitPipelineState.hpp"
+#include "Clusters.hpp"
 #include "Light.hpp"
 #include "Matrices.hpp"
 
 #include <WebGPUlib/Device.hpp>
 #include <WebGPUlib/GraphicsCommandBuffer.hpp>
 #include <WebGPUlib/Material.hpp>
-#include <WebGPUlib/Surface.hpp>
 #include <WebGPUlib/Vertex.hpp>
 
 #include <glm/mat4x4.hpp>
@@ -18,8 +18,8 @@ TextureLitPipelineState::TextureLitPipelineState()
 #include "TextureLitShader.wgsl"
     };
 
-    WGPUDevice        device        = Device::get().getWGPUDevice();
-    WGPUTextureFormat surfaceFormat = Device::get().getSurface()->getSurfaceFormat();
+    WGPUDevice        device      = Device::get().getWGPUDevice();
+    WGPUTextureFormat colorFormat = Device::get().getColorFormat();
 
     // Load the shader module.
     WGPUShaderModuleWGSLDescriptor shaderCodeDesc {};
@@ -32,19 +32,21 @@ TextureLitPipelineState::TextureLitPipelineState()
     WGPUShaderModule shaderModule      = wgpuDeviceCreateShaderModule( device, &shaderModuleDescriptor );
 
     // Setup the binding layout.
-    WGPUBindGroupLayoutEntry bindGroupLayoutEntries[12] {};
+    WGPUBindGroupLayoutEntry bindGroupLayoutEntries[17] {};
 
-    // @group( 0 ) @binding( 0 ) var<uniform> matrices : Matrices;
-    bindGroupLayoutEntries[0].binding               = 0;
-    bindGroupLayoutEntries[0].visibility            = WGPUShaderStage_Vertex;
-    bindGroupLayoutEntries[0].buffer.type           = WGPUBufferBindingType_Uniform;
-    bindGroupLayoutEntries[0].buffer.minBindingSize = sizeof( Matrices );
+    // @group( 0 ) @binding( 0 ) var<storage, read> instances : array<Matrices>;
+    bindGroupLayoutEntries[0].binding                 = 0;
+    bindGroupLayoutEntries[0].visibility              = WGPUShaderStage_Vertex;
+    bindGroupLayoutEntries[0].buffer.type             = WGPUBufferBindingType_ReadOnlyStorage;
+    bindGroupLayoutEntries[0].buffer.hasDynamicOffset = true;
+    bindGroupLayoutEntries[0].buffer.minBindingSize   = sizeof( Matrices );
 
     // @group( 0 ) @binding( 1 ) var<uniform> material : Material;
-    bindGroupLayoutEntries[1].binding               = 1;
-    bindGroupLayoutEntries[1].visibility            = WGPUShaderStage_Fragment;
-    bindGroupLayoutEntries[1].buffer.type           = WGPUBufferBindingType_Uniform;
-    bindGroupLayoutEntries[1].buffer.minBindingSize = sizeof( MaterialProperties );
+    bindGroupLayoutEntries[1].binding                 = 1;
+    bindGroupLayoutEntries[1].visibility              = WGPUShaderStage_Fragment;
+    bindGroupLayoutEntries[1].buffer.type             = WGPUBufferBindingType_Uniform;
+    bindGroupLayoutEntries[1].buffer.hasDynamicOffset = true;
+    bindGroupLayoutEntries[1].buffer.minBindingSize   = sizeof( MaterialProperties );
 
     // @group( 0 ) @binding( 2 ) var ambientTexture : texture_2d<f32>;
     // @group( 0 ) @binding( 3 ) var emissiveTexture : texture_2d<f32>;
@@ -68,16 +70,39 @@ TextureLitPipelineState::TextureLitPipelineState()
     bindGroupLayoutEntries[10].sampler.type = WGPUSamplerBindingType_Filtering;
 
     // @group( 0 ) @binding( 11 ) var<storage> pointLights : array<PointLight>;
-    bindGroupLayoutEntries[11].binding               = 11;
-    bindGroupLayoutEntries[11].visibility            = WGPUShaderStage_Fragment;
-    bindGroupLayoutEntries[11].buffer.type           = WGPUBufferBindingType_ReadOnlyStorage;
-    bindGroupLayoutEntries[11].buffer.minBindingSize = 0; //sizeof(PointLight);
-
-    // @group( 0 ) @binding( 12 ) var<storage> spotLights : array<SpotLight>;
-    //bindGroupLayoutEntries[12].binding               = 12;
-    //bindGroupLayoutEntries[12].visibility            = WGPUShaderStage_Fragment;
-    //bindGroupLayoutEntries[12].buffer.type           = WGPUBufferBindingType_ReadOnlyStorage;
-    //bindGroupLayoutEntries[12].buffer.minBindingSize = 0; // sizeof(SpotLight);
+    bindGroupLayoutEntries[11].binding                 = 11;
+    bindGroupLayoutEntries[11].visibility              = WGPUShaderStage_Fragment;
+    bindGroupLayoutEntries[11].buffer.type             = WGPUBufferBindingType_ReadOnlyStorage;
+    bindGroupLayoutEntries[11].buffer.hasDynamicOffset = false;
+    bindGroupLayoutEntries[11].buffer.minBindingSize   = 0; //sizeof(PointLight);
+
+    // @group( 0 ) @binding( 12 ) var<uniform> camera : CameraMatrices;
+    bindGroupLayoutEntries[12].binding               = 12;
+    bindGroupLayoutEntries[12].visibility            = WGPUShaderStage_Vertex;
+    bindGroupLayoutEntries[12].buffer.type           = WGPUBufferBindingType_Uniform;
+    bindGroupLayoutEntries[12].buffer.minBindingSize = sizeof( CameraMatrices );
+
+    // @group( 0 ) @binding( 13 ) var<storage> spotLights : array<SpotLight>;
+    bindGroupLayoutEntries[13].binding               = 13;
+    bindGroupLayoutEntries[13].visibility            = WGPUShaderStage_Fragment;
+    bindGroupLayoutEntries[13].buffer.type           = WGPUBufferBindingType_ReadOnlyStorage;
+    bindGroupLayoutEntries[13].buffer.minBindingSize = 0; // sizeof(SpotLight);
+
+    // @group( 0 ) @binding( 14 ) var<uniform> clusters : Clusters;
+    bindGroupLayoutEntries[14].binding               = 14;
+    bindGroupLayoutEntries[14].visibility            = WGPUShaderStage_Fragment;
+    bindGroupLayoutEntries[14].buffer.type           = WGPUBufferBindingType_Uniform;
+    bindGroupLayoutEntries[14].buffer.minBindingSize = sizeof( ClusterParameters );
+
+    // @group( 0 ) @binding( 15 ) var<storage> clusterLightCounts : array<vec2u>;
+    // @group( 0 ) @binding( 16 ) var<storage> clusterLightIndices : array<u32>;
+    for ( int binding = 15; binding <= 16; ++binding )
+    {
+        bindGroupLayoutEntries[binding].binding               = binding;
+        bindGroupLayoutEntries[binding].visibility            = WGPUShaderStage_Fragment;
+        bindGroupLayoutEntries[binding].buffer.type           = WGPUBufferBindingType_ReadOnlyStorage;
+        bindGroupLayoutEntries[binding].buffer.minBindingSize = 0;
+    }
 
     // Setup the binding group.
     WGPUBindGroupLayoutDescriptor bindGroupLayoutDescriptor {};
@@ -91,44 +116,16 @@ TextureLitPipelineState::TextureLitPipelineState()
     pipelineLayoutDescriptor.bindGroupLayouts     = &bindGroupLayout;
     WGPUPipelineLayout pipelineLayout             = wgpuDeviceCreatePipelineLayout( device, &pipelineLayoutDescriptor );
 
-    // Setup the vertex layout.
+    // Setup the vertex layout (see VertexPositionPackedNormalTangentTexture).
     // @location(0) position : vec3f,
-    // @location(1) normal   : vec3f,
-    // @location(2) tangent  : vec3f,
-    // @location(3) bitangent: vec3f,
-    // @location(4) uv       : vec3f,
-
-    WGPUVertexAttribute vertexAttributes[5] {};
-    // glm::vec3 position;
-    vertexAttributes[0].format         = WGPUVertexFormat_Float32x3;
-    vertexAttributes[0].offset         = offsetof( VertexPositionNormalTangentBitangentTexture, position );
-    vertexAttributes[0].shaderLocation = 0;
-
-    // glm::vec3 normal;
-    vertexAttributes[1].format         = WGPUVertexFormat_Float32x3;
-    vertexAttributes[1].offset         = offsetof( VertexPositionNormalTangentBitangentTexture, normal );
-    vertexAttributes[1].shaderLocation = 1;
-
-    // glm::vec3 tangent;
-    vertexAttributes[2].format         = WGPUVertexFormat_Float32x3;
-    vertexAttributes[2].offset         = offsetof( VertexPositionNormalTangentBitangentTexture, tangent );
-    vertexAttributes[2].shaderLocation = 2;
-
-    // glm::vec3 bitangent;
-    vertexAttributes[3].format         = WGPUVertexFormat_Float32x3;
-    vertexAttributes[3].offset         = offsetof( VertexPositionNormalTangentBitangentTexture, bitangent );
-    vertexAttributes[3].shaderLocation = 3;
-
-    // glm::vec3 texCoord;
-    vertexAttributes[4].format         = WGPUVertexFormat_Float32x3;
-    vertexAttributes[4].offset         = offsetof( VertexPositionNormalTangentBitangentTexture, texCoord );
-    vertexAttributes[4].shaderLocation = 4;
-
+    // @location(1) normal   : vec2f, (octahedral encoded)
+    // @location(2) tangent  : vec4f, (w is the handedness of the bitangent)
+    // @location(3) uv       : vec2f,
     WGPUVertexBufferLayout vertexBufferLayout {};
-    vertexBufferLayout.arrayStride    = sizeof( VertexPositionNormalTangentBitangentTexture );
+    vertexBufferLayout.arrayStride    = sizeof( VertexPositionPackedNormalTangentTexture );
     vertexBufferLayout.stepMode       = WGPUVertexStepMode_Vertex;
-    vertexBufferLayout.attributeCount = std::size( vertexAttributes );
-    vertexBufferLayout.attributes     = vertexAttributes;
+    vertexBufferLayout.attributeCount = std::size( VertexPositionPackedNormalTangentTexture::attributes );
+    vertexBufferLayout.attributes     = VertexPositionPackedNormalTangentTexture::attributes;
 
     WGPUPrimitiveState primitiveState {};
     primitiveState.topology         = WGPUPrimitiveTopology_TriangleList;
@@ -147,7 +144,7 @@ TextureLitPipelineState::TextureLitPipelineState()
     vertexState.buffers       = &vertexBufferLayout;
 
     WGPUColorTargetState colorTargetState {};
-    colorTargetState.format    = surfaceFormat;
+    colorTargetState.format    = colorFormat;
     colorTargetState.blend     = nullptr;
     colorTargetState.writeMask = WGPUColorWriteMask_All;
 
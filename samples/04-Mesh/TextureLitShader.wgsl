@@ -2,10 +2,9 @@ R"(
 struct VertexIn
 {
     @location(0) position : vec3f,
-    @location(1) normal   : vec3f,
-    @location(2) tangent  : vec3f,
-    @location(3) bitangent: vec3f,
-    @location(4) uv       : vec3f,
+    @location(1) normal   : vec2f,  // Octahedral encoded.
+    @location(2) tangent  : vec4f,  // w is the handedness of the bitangent.
+    @location(3) uv       : vec2f,
 };
 
 struct VertexOut
@@ -25,14 +24,20 @@ struct FragmentIn
     @location(2) tangentVS  : vec3f,
     @location(3) bitangentVS: vec3f,
     @location(4) uv         : vec2f,
+    @builtin(position) position : vec4f,
 };
 
 struct Matrices
 {
-    model               : mat4x4f,
-    modelView           : mat4x4f,
-    modelViewIT         : mat4x4f, // Inverse-transpose
-    modelViewProjection : mat4x4f,
+    model   : mat4x4f,
+    modelIT : mat4x4f, // Inverse-transpose
+};
+
+struct CameraMatrices
+{
+    view           : mat4x4f,
+    projection     : mat4x4f,
+    viewProjection : mat4x4f,
 };
 
 struct Material
@@ -103,6 +108,24 @@ struct SpotLight
     // Total:                              16 * 7 = 112 bytes
 };
 
+struct Clusters
+{
+    inverseProjection : mat4x4f,
+    //----------------------------------- (16 byte boundary)
+    gridSize : vec4u, // xyz: Number of clusters, w: max lights per cluster.
+    //----------------------------------- (16 byte boundary)
+    screenSize : vec2f,
+    near : f32,
+    far : f32,
+    //----------------------------------- (16 byte boundary)
+    sliceScale : f32,
+    sliceBias : f32,
+    pointLightCount : u32,
+    spotLightCount : u32,
+    //----------------------------------- (16 byte boundary)
+    // Total:                              16 * 7 = 112 bytes
+};
+
 struct LightResult
 {
     diffuse : vec4f,
@@ -111,7 +134,9 @@ struct LightResult
 };
 
 // Constants
-@group(0) @binding(0) var<uniform> matrices : Matrices;
+// The matrices of the instances of a draw, indexed by the instance index.
+// Written by the instance culling compute shader when the scene is culled on the GPU.
+@group(0) @binding(0) var<storage, read> instances : array<Matrices>;
 @group(0) @binding(1) var<uniform> material : Material;
 
 // Textures
@@ -129,24 +154,52 @@ struct LightResult
 
 // Lights
 @group(0) @binding(11) var<storage> pointLights : array<PointLight>;
-// @group(0) @binding(12) var<storage> spotLights : array<SpotLight>;
+@group(0) @binding(13) var<storage> spotLights : array<SpotLight>;
+
+// Camera
+@group(0) @binding(12) var<uniform> camera : CameraMatrices;
+
+// Light clusters (written by the light culling compute shader).
+@group(0) @binding(14) var<uniform> clusters : Clusters;
+@group(0) @binding(15) var<storage> clusterLightCounts : array<vec2u>;
+@group(0) @binding(16) var<storage> clusterLightIndices : array<u32>;
 
 fn toMat3x3( m : mat4x4f ) -> mat3x3f
 {
     return mat3x3( m[0].xyz, m[1].xyz, m[2].xyz );
 }
 
+// Decode an octahedral encoded unit vector.
+fn OctahedralDecode( e : vec2f ) -> vec3f
+{
+    var n = vec3f( e, 1.0f - abs( e.x ) - abs( e.y ) );
+    let t = max( -n.z, 0.0f );
+    n.x += select( t, -t, n.x >= 0.0f );
+    n.y += select( t, -t, n.y >= 0.0f );
+    return normalize( n );
+}
+
 @vertex
-fn vs_main(in: VertexIn) -> VertexOut
+fn vs_main(in: VertexIn, @builtin(instance_index) instanceIndex: u32) -> VertexOut
 {
+    let matrices = instances[instanceIndex];
+
     var out: VertexOut;
     
-    out.positionVS =  (matrices.modelView * vec4f(in.position, 1.0)).xyz;
-    out.normalVS = toMat3x3(matrices.modelViewIT) * in.normal;
-    out.tangentVS = toMat3x3(matrices.modelViewIT) * in.tangent;
-    out.bitangentVS = toMat3x3(matrices.modelViewIT) * in.bitangent;
-    out.uv = in.uv.xy;
-    out.position = matrices.modelViewProjection * vec4f(in.position, 1.0);
+    // The view matrix is a rigid transform, so its inverse-transpose is the view matrix itself.
+    let modelView = camera.view * matrices.model;
+    let modelViewIT = toMat3x3(camera.view) * toMat3x3(matrices.modelIT);
+
+    let normal    = OctahedralDecode( in.normal );
+    let tangent   = normalize( in.tangent.xyz );
+    let bitangent = cross( normal, tangent ) * in.tangent.w;
+
+    out.positionVS =  (modelView * vec4f(in.position, 1.0)).xyz;
+    out.normalVS = modelViewIT * normal;
+    out.tangentVS = modelViewIT * tangent;
+    out.bitangentVS = modelViewIT * bitangent;
+    out.uv = in.uv;
+    out.position = camera.viewProjection * matrices.model * vec4f(in.position, 1.0);
 
     return out;
 }
@@ -218,17 +271,33 @@ fn DoSpotLight( light : SpotLight, V : vec3f, P : vec3f, N : vec3f, specularPowe
     return result;
 }
 
-fn DoLighting( P : vec3f, N : vec3f, specularPower : f32 ) -> LightResult
+// Get the index of the cluster that contains the fragment.
+fn GetClusterIndex( fragCoord : vec2f, depth : f32 ) -> u32
+{
+    let gridSize = clusters.gridSize.xyz;
+    let tile = vec2u( fragCoord / clusters.screenSize * vec2f( gridSize.xy ) );
+    let slice = u32( max( log( depth ) * clusters.sliceScale + clusters.sliceBias, 0.0 ) );
+    let cluster = min( vec3u( tile, slice ), gridSize - 1 );
+
+    return cluster.x + cluster.y * gridSize.x + cluster.z * gridSize.x * gridSize.y;
+}
+
+fn DoLighting( P : vec3f, N : vec3f, specularPower : f32, fragCoord : vec2f ) -> LightResult
 {
     // Lighting is computed in view space.
     let V = normalize( -P );
 
     var totalResult : LightResult; // is this 0 initialized?
 
+    // Only the lights that affect the cluster of the fragment are evaluated.
+    let clusterIndex = GetClusterIndex( fragCoord, -P.z );
+    let lightCounts = clusterLightCounts[clusterIndex];
+    let offset = clusterIndex * clusters.gridSize.w;
+
     // Iterate point lights
-    for( var i : u32 = 0; i < arrayLength(&pointLights); i++ )
+    for( var i : u32 = 0; i < lightCounts.x; i++ )
     {
-        let result = DoPointLight( pointLights[i], V, P, N, specularPower );
+        let result = DoPointLight( pointLights[clusterLightIndices[offset + i]], V, P, N, specularPower );
 
         totalResult.diffuse += result.diffuse;
         totalResult.specular += result.specular;
@@ -236,16 +305,14 @@ fn DoLighting( P : vec3f, N : vec3f, specularPower : f32 ) -> LightResult
     }
 
     // Iterate spot lights
-    /*
-    for( var i : u32 = 0; i < arrayLength(&spotLights); i++ )
+    for( var i : u32 = 0; i < lightCounts.y; i++ )
     {
-        let result = DoSpotLight( spotLights[i], V, P, N, specularPower );
+        let result = DoSpotLight( spotLights[clusterLightIndices[offset + lightCounts.x + i]], V, P, N, specularPower );
 
         totalResult.diffuse += result.diffuse;
         totalResult.specular += result.specular;
         totalResult.ambient += result.ambient;
     }
-    */
 
     totalResult.diffuse = saturate(totalResult.diffuse);
     totalResult.specular = saturate(totalResult.specular);
@@ -254,9 +321,11 @@ fn DoLighting( P : vec3f, N : vec3f, specularPower : f32 ) -> LightResult
     return totalResult;
 }
 
+// Normal maps may be compressed to two channels (BC5), so the z component is reconstructed from x and y.
 fn ExpandNormal( n : vec3f ) -> vec3f
 {
-    return n * 2.0f - 1.0f;
+    let xy = n.xy * 2.0f - 1.0f;
+    return vec3f( xy, sqrt( saturate( 1.0f - dot( xy, xy ) ) ) );
 }
 
 fn DoNormalMapping( TBN : mat3x3f, tex : texture_2d<f32>, uv : vec2f ) -> vec3f
@@ -353,7 +422,7 @@ fn fs_main(in: FragmentIn) -> @location(0) vec4f {
         N = DoBumpMapping(TBN, bumpTexture, in.uv, material.bumpIntensity);
     }
 
-    let lighting = DoLighting( in.positionVS, N, specularPower );
+    let lighting = DoLighting( in.positionVS, N, specularPower, in.position.xy );
 
     ambient *= lighting.ambient;
     diffuse *= lighting.diffuse;
@@ -1,8 +1,9 @@
 #include "TextureUnlitPipelineState.hpp"
 
+#include "Matrices.hpp"
+
 #include <WebGPUlib/Device.hpp>
 #include <WebGPUlib/GraphicsCommandBuffer.hpp>
-#include <WebGPUlib/Surface.hpp>
 #include <WebGPUlib/Vertex.hpp>
 
 #include <glm/mat4x4.hpp>
@@ -15,8 +16,8 @@ TextureUnlitPipelineState::TextureUnlitPipelineState()
 #include "TextureUnlitShader.wgsl"
     };
 
-    WGPUDevice        device        = Device::get().getWGPUDevice();
-    WGPUTextureFormat surfaceFormat = Device::get().getSurface()->getSurfaceFormat();
+    WGPUDevice        device      = Device::get().getWGPUDevice();
+    WGPUTextureFormat colorFormat = Device::get().getColorFormat();
 
     // Load the shader module.
     WGPUShaderModuleWGSLDescriptor shaderCodeDesc {};
@@ -29,20 +30,22 @@ TextureUnlitPipelineState::TextureUnlitPipelineState()
     WGPUShaderModule shaderModule      = wgpuDeviceCreateShaderModule( device, &shaderModuleDescriptor );
 
     // Setup the binding layout.
-    // @group( 0 ) @binding( 0 ) var<uniform> mvp : mat4x4f;
-    // @group( 0 ) @binding( 1 ) var<uniform> color : vec4f;
-    // @group( 0 ) @binding( 2 ) var          albedoTexture : texture_2d<f32>;
-    // @group( 0 ) @binding( 3 ) var          linearRepeatSampler : sampler;
+    // @group( 0 ) @binding( 0 ) var<uniform>       camera : CameraMatrices;
+    // @group( 0 ) @binding( 1 ) var<storage, read> instances : array<Instance>;
+    // @group( 0 ) @binding( 2 ) var                albedoTexture : texture_2d<f32>;
+    // @group( 0 ) @binding( 3 ) var                linearRepeatSampler : sampler;
     WGPUBindGroupLayoutEntry               bindGroupLayoutEntries[4] {};
     bindGroupLayoutEntries[0].binding               = 0;
     bindGroupLayoutEntries[0].visibility            = WGPUShaderStage_Vertex;
     bindGroupLayoutEntries[0].buffer.type           = WGPUBufferBindingType_Uniform;
-    bindGroupLayoutEntries[0].buffer.minBindingSize = sizeof( glm::mat4 );
+    bindGroupLayoutEntries[0].buffer.minBindingSize = sizeof( CameraMatrices );
 
-    bindGroupLayoutEntries[1].binding               = 1;
-    bindGroupLayoutEntries[1].visibility            = WGPUShaderStage_Fragment;
-    bindGroupLayoutEntries[1].buffer.type           = WGPUBufferBindingType_Uniform;
-    bindGroupLayoutEntries[1].buffer.minBindingSize = sizeof( glm::vec4 );
+    // The instance data is uploaded with each instanced draw.
+    bindGroupLayoutEntries[1].binding                 = 1;
+    bindGroupLayoutEntries[1].visibility              = WGPUShaderStage_Vertex;
+    bindGroupLayoutEntries[1].buffer.type             = WGPUBufferBindingType_ReadOnlyStorage;
+    bindGroupLayoutEntries[1].buffer.hasDynamicOffset = true;
+    bindGroupLayoutEntries[1].buffer.minBindingSize   = sizeof( InstanceData );
 
     bindGroupLayoutEntries[2].binding               = 2;
     bindGroupLayoutEntries[2].visibility            = WGPUShaderStage_Fragment;
@@ -66,27 +69,20 @@ TextureUnlitPipelineState::TextureUnlitPipelineState()
     WGPUPipelineLayout pipelineLayout             = wgpuDeviceCreatePipelineLayout( device, &pipelineLayoutDescriptor );
 
     // Setup the vertex layout.
-    // glm::vec3 position;
-    // glm::vec3 normal;
-    // glm::vec3 texCoord;
-    WGPUVertexAttribute vertexAttributes[3] {};
+    // The unlit shader only reads the position and the texture coordinates of the packed vertex.
+    WGPUVertexAttribute vertexAttributes[2] {};
     // glm::vec3 position;
     vertexAttributes[0].format         = WGPUVertexFormat_Float32x3;
-    vertexAttributes[0].offset         = offsetof( VertexPositionNormalTangentBitangentTexture, position );
+    vertexAttributes[0].offset         = offsetof( VertexPositionPackedNormalTangentTexture, position );
     vertexAttributes[0].shaderLocation = 0;
 
-    // glm::vec3 normal;
-    vertexAttributes[1].format         = WGPUVertexFormat_Float32x3;
-    vertexAttributes[1].offset         = offsetof( VertexPositionNormalTangentBitangentTexture, normal );
+    // Float16x2 texCoord;
+    vertexAttributes[1].format         = WGPUVertexFormat_Float16x2;
+    vertexAttributes[1].offset         = offsetof( VertexPositionPackedNormalTangentTexture, texCoord );
     vertexAttributes[1].shaderLocation = 1;
 
-    // glm::vec3 texCoord;
-    vertexAttributes[2].format         = WGPUVertexFormat_Float32x3;
-    vertexAttributes[2].offset         = offsetof( VertexPositionNormalTangentBitangentTexture, texCoord );
-    vertexAttributes[2].shaderLocation = 2;
-
     WGPUVertexBufferLayout vertexBufferLayout {};
-    vertexBufferLayout.arrayStride    = sizeof( VertexPositionNormalTangentBitangentTexture );
+    vertexBufferLayout.arrayStride    = sizeof( VertexPositionPackedNormalTangentTexture );
     vertexBufferLayout.stepMode       = WGPUVertexStepMode_Vertex;
     vertexBufferLayout.attributeCount = std::size( vertexAttributes );
     vertexBufferLayout.attributes     = vertexAttributes;
@@ -108,7 +104,7 @@ TextureUnlitPipelineState::TextureUnlitPipelineState()
     vertexState.buffers       = &vertexBufferLayout;
 
     WGPUColorTargetState colorTargetState {};
-    colorTargetState.format    = surfaceFormat;
+    colorTargetState.format    = colorFormat;
     colorTargetState.blend     = nullptr;
     colorTargetState.writeMask = WGPUColorWriteMask_All;
 
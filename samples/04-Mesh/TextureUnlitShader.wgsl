@@ -2,38 +2,55 @@ R"(
 struct VertexIn
 {
     @location(0) position : vec3f,
-    @location(1) normal   : vec3f,
-    @location(2) uv       : vec3f,
+    @location(1) uv       : vec2f,
 };
 
 struct VertexOut
 {
     @builtin(position) position: vec4f,
     @location(0) uv: vec2f,
+    @location(1) @interpolate(flat) color: vec4f,
 };
 
 struct FragmentIn
 {
-    @location(0) uv: vec2f
+    @location(0) uv: vec2f,
+    @location(1) @interpolate(flat) color: vec4f,
+};
+
+struct CameraMatrices
+{
+    view           : mat4x4f,
+    projection     : mat4x4f,
+    viewProjection : mat4x4f,
 };
 
-// Model View Projection matrix.
-@group(0) @binding(0) var<uniform> mvp : mat4x4f;
-@group(0) @binding(1) var<uniform> color : vec4f;
+// Per-instance data, indexed by the instance index.
+struct Instance
+{
+    model : mat4x4f,
+    color : vec4f,
+};
+
+@group(0) @binding(0) var<uniform> camera : CameraMatrices;
+@group(0) @binding(1) var<storage, read> instances : array<Instance>;
 @group(0) @binding(2) var albedoTexture : texture_2d<f32>;
 @group(0) @binding(3) var linearRepeatSampler : sampler;
 
 @vertex
-fn vs_main(in: VertexIn) -> VertexOut
+fn vs_main(in: VertexIn, @builtin(instance_index) instanceIndex: u32) -> VertexOut
 {
+    let instance = instances[instanceIndex];
+
     var out: VertexOut;
-    out.position =  mvp * vec4f(in.position, 1.0);
-    out.uv = in.uv.xy;
+    out.position = camera.viewProjection * instance.model * vec4f(in.position, 1.0);
+    out.uv = in.uv;
+    out.color = instance.color;
     return out;
 }
 
 @fragment
 fn fs_main(in: FragmentIn) -> @location(0) vec4f {
-    return textureSample(albedoTexture, linearRepeatSampler, in.uv) * color;
+    return textureSample(albedoTexture, linearRepeatSampler, in.uv) * in.color;
 }
 )"
\ No newline at end of file
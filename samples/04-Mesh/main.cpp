@@ -1,4 +1,6 @@
+#include "Clusters.hpp"
 #include "Light.hpp"
+#include "LightCullingPipelineState.hpp"
 #include "Matrices.hpp"
 #include "TextureLitPipelineState.hpp"
 #include "TextureUnlitPipelineState.hpp"
@@ -7,19 +9,32 @@
 #include <CameraController.hpp>
 #include <Timer.hpp>
 
+#include <WebGPUlib/ComputeCommandBuffer.hpp>
 #include <WebGPUlib/Device.hpp>
+#include <WebGPUlib/Frustum.hpp>
+#include <WebGPUlib/GPUProfiler.hpp>
+#include <WebGPUlib/GPUScene.hpp>
 #include <WebGPUlib/GraphicsCommandBuffer.hpp>
+#include <WebGPUlib/Helpers.hpp>
+#include <WebGPUlib/HiZPyramid.hpp>
 #include <WebGPUlib/Material.hpp>
 #include <WebGPUlib/Mesh.hpp>
 #include <WebGPUlib/Queue.hpp>
+#include <WebGPUlib/RenderBundle.hpp>
+#include <WebGPUlib/RenderBundleCommandBuffer.hpp>
+#include <WebGPUlib/RenderQueue.hpp>
 #include <WebGPUlib/RenderTarget.hpp>
 #include <WebGPUlib/Sampler.hpp>
 #include <WebGPUlib/Scene.hpp>
+#include <WebGPUlib/SceneGraph.hpp>
 #include <WebGPUlib/SceneNode.hpp>
+#include <WebGPUlib/StorageBuffer.hpp>
 #include <WebGPUlib/Surface.hpp>
 #include <WebGPUlib/Texture.hpp>
+#include <WebGPUlib/TextureCache.hpp>
 #include <WebGPUlib/TextureView.hpp>
 #include <WebGPUlib/UniformBuffer.hpp>
+#include <WebGPUlib/UploadPagePool.hpp>
 #include <WebGPUlib/VertexBuffer.hpp>
 
 #ifdef __EMSCRIPTEN__
@@ -30,10 +45,18 @@
 #include <SDL2/SDL.h>
 
 #include <glm/gtc/matrix_transform.hpp>  // For matrix transformations.
+#include <glm/matrix.hpp>
 #include <glm/mat4x4.hpp>
 #include <glm/vec3.hpp>
 
+#include <stb_image_write.h>
+
+#include <algorithm>
+#include <charconv>
+#include <cmath>
+#include <cstring>
 #include <iostream>
+#include <string>
 
 using namespace WebGPUlib;
 
@@ -42,6 +65,9 @@ constexpr int WINDOW_HEIGHT = 720;
 const char*   WINDOW_TITLE  = "04 - Mesh";
 SDL_Window*   window        = nullptr;
 
+constexpr float CAMERA_NEAR = 0.1f;
+constexpr float CAMERA_FAR  = 10000.0f;
+
 Timer                             timer;
 Camera                            camera;
 std::unique_ptr<CameraController> cameraController;
@@ -51,9 +77,22 @@ std::vector<SpotLight>  spotLights;
 
 bool isRunning = true;
 
+// Headless mode renders a fixed number of frames to an offscreen render target
+// and writes the final frame to disk.
+bool        headless             = false;
+bool        forceFallbackAdapter = false;
+uint64_t    headlessFrames       = 100;
+uint64_t    frameCount           = 0;
+const char* headlessOutputFile   = "04-Mesh.png";
+
+// Cull the scene instances in a compute shader and draw them with indirect draws.
+bool gpuCulling = false;
+// Also cull the scene instances that are occluded, using a Hi-Z pyramid built from the depth buffer.
+bool occlusionCulling = false;
+
 std::shared_ptr<Mesh>                      cubeMesh;
 std::shared_ptr<Mesh>                      sphereMesh;
-std::shared_ptr<UniformBuffer>             mvpBuffer;
+glm::mat4                                  cubeTransform { 1 };
 std::shared_ptr<Texture>                   colorTexture;
 std::shared_ptr<TextureView>               colorTextureView;
 std::shared_ptr<Texture>                   depthTexture;
@@ -61,8 +100,45 @@ std::shared_ptr<TextureView>               depthTextureView;
 std::shared_ptr<Texture>                   albedoTexture;
 std::shared_ptr<Sampler>                   linearRepeatSampler;
 std::shared_ptr<Scene>                     scene;
+std::shared_ptr<UniformBuffer>             cameraBuffer;
+std::shared_ptr<StorageBuffer>             pointLightsBuffer;
+std::shared_ptr<StorageBuffer>             spotLightsBuffer;
+ClusterParameters                          clusterParameters {};
+std::shared_ptr<UniformBuffer>             clusterParametersBuffer;
+std::shared_ptr<StorageBuffer>             clusterLightCountsBuffer;
+std::shared_ptr<StorageBuffer>             clusterLightIndicesBuffer;
+std::shared_ptr<RenderBundle>              sceneBundle;
+std::shared_ptr<RenderBundle>              lateSceneBundle;  // The late phase draws of occlusion culling.
+Frustum                                    viewFrustum;
+glm::mat4                                  viewProjectionMatrix { 1 };
+RenderQueue                                renderQueue;
+CommandBuffer::Statistics                  sceneBundleStatistics;      // The state changes of the scene bundle.
+CommandBuffer::Statistics                  lateSceneBundleStatistics;  // The state changes of the late scene bundle.
+
+// Without GPU culling, the meshes of the scene are divided into the cells of a coarse grid over the scene bounds.
+// Each cell records its meshes into its own render bundle, and frustum culling only selects the cells to draw,
+// so a cell bundle is only recorded again when its transforms, materials, or pipelines change, not when the
+// camera moves.
+struct SceneCell
+{
+    BoundingBox                   bounds;
+    std::vector<VisibleMesh>      meshes;
+    std::shared_ptr<RenderBundle> bundle;
+    CommandBuffer::Statistics     statistics;  // The state changes of the recorded bundle.
+};
+
+constexpr uint32_t SceneCellGridSize = 4;  // The number of cells along each axis.
+
+std::vector<SceneCell>                     sceneCells;
+const SceneGraph*                          sceneCellsGraph   = nullptr;
+uint64_t                                   sceneCellsVersion = 0;
+std::vector<std::shared_ptr<RenderBundle>> visibleCellBundles;  // The bundles of the cells that passed culling.
+std::vector<SceneCell*>                    visibleCells;
 std::unique_ptr<TextureUnlitPipelineState> textureUnlitPipelineState;
 std::unique_ptr<TextureLitPipelineState>   textureLitPipelineState;
+std::unique_ptr<LightCullingPipelineState> lightCullingPipelineState;
+std::unique_ptr<GPUScene>                  gpuScene;    // Only used with GPU culling.
+std::unique_ptr<HiZPyramid>                hiZPyramid;  // Only used with occlusion culling.
 
 void onResize( uint32_t width, uint32_t height )
 {
@@ -70,10 +146,11 @@ void onResize( uint32_t width, uint32_t height )
     auto& device  = Device::get();
     auto  surface = device.getSurface();
 
-    surface->resize( width, height );
+    if ( surface )
+        surface->resize( width, height );
 
     // Create the MSAA color texture.
-    WGPUTextureFormat colorTextureFormat = surface->getSurfaceFormat();
+    WGPUTextureFormat colorTextureFormat = device.getColorFormat();
 
     WGPUTextureDescriptor colorTextureDescriptor {};
     colorTextureDescriptor.label         = "MSAA color Texture";
@@ -90,12 +167,12 @@ void onResize( uint32_t width, uint32_t height )
     colorTexture     = device.createTexture( colorTextureDescriptor );
     colorTextureView = colorTexture->getView();
 
-    // Create the depth texture.
+    // Create the depth texture. It is also read by the compute shader that builds the Hi-Z pyramid.
     WGPUTextureFormat depthTextureFormat = WGPUTextureFormat_Depth32Float;
 
     WGPUTextureDescriptor depthTextureDescriptor = {};
     depthTextureDescriptor.label                 = "Depth Texture";
-    depthTextureDescriptor.usage                 = WGPUTextureUsage_RenderAttachment;
+    depthTextureDescriptor.usage                 = WGPUTextureUsage_RenderAttachment | WGPUTextureUsage_TextureBinding;
     depthTextureDescriptor.dimension             = WGPUTextureDimension_2D;
     depthTextureDescriptor.size                  = { width, height, 1 };
     depthTextureDescriptor.format                = depthTextureFormat;
@@ -120,32 +197,51 @@ void onResize( uint32_t width, uint32_t height )
     depthTextureView = depthTexture->getView( &depthTextureViewDescriptor );
 
     // Update the camera's projection matrix.
-    camera.setProjection( glm::radians( 45.0f ), static_cast<float>( width ) / static_cast<float>( height ), 0.1f,
-                          10000.0f );
+    camera.setProjection( glm::radians( 45.0f ), static_cast<float>( width ) / static_cast<float>( height ),
+                          CAMERA_NEAR, CAMERA_FAR );
+
+    // Update the cluster grid.
+    const float logDepthRange = std::log( CAMERA_FAR / CAMERA_NEAR );
+
+    clusterParameters.gridSize.x = CLUSTER_GRID_X;
+    clusterParameters.gridSize.y = CLUSTER_GRID_Y;
+    clusterParameters.gridSize.z = CLUSTER_GRID_Z;
+    clusterParameters.gridSize.w = MAX_LIGHTS_PER_CLUSTER;
+    clusterParameters.screenSize = { static_cast<float>( width ), static_cast<float>( height ) };
+    clusterParameters.near       = CAMERA_NEAR;
+    clusterParameters.far        = CAMERA_FAR;
+    clusterParameters.sliceScale = static_cast<float>( CLUSTER_GRID_Z ) / logDepthRange;
+    clusterParameters.sliceBias  = -static_cast<float>( CLUSTER_GRID_Z ) * std::log( CAMERA_NEAR ) / logDepthRange;
 }
 
 void init()
 {
-    SDL_Init( SDL_INIT_VIDEO | SDL_INIT_GAMECONTROLLER );
+    if ( headless )
+    {
+        Device::createHeadless( WINDOW_WIDTH, WINDOW_HEIGHT, forceFallbackAdapter );
+    }
+    else
+    {
+        SDL_Init( SDL_INIT_VIDEO | SDL_INIT_GAMECONTROLLER );
 
-    // Enable polling game controllers.s
-    SDL_GameControllerEventState( SDL_ENABLE );
+        // Enable polling game controllers.s
+        SDL_GameControllerEventState( SDL_ENABLE );
 
-    window = SDL_CreateWindow( WINDOW_TITLE, SDL_WINDOWPOS_CENTERED, SDL_WINDOWPOS_CENTERED, WINDOW_WIDTH,
-                               WINDOW_HEIGHT, SDL_WINDOW_RESIZABLE );
+        window = SDL_CreateWindow( WINDOW_TITLE, SDL_WINDOWPOS_CENTERED, SDL_WINDOWPOS_CENTERED, WINDOW_WIDTH,
+                                   WINDOW_HEIGHT, SDL_WINDOW_RESIZABLE );
 
-    if ( !window )
-    {
-        std::cerr << "Failed to create window." << std::endl;
-        return;
-    }
+        if ( !window )
+        {
+            std::cerr << "Failed to create window." << std::endl;
+            return;
+        }
 
-    Device::create( window );
+        Device::create( window );
+    }
 
-    // Create a uniform buffer large enough to hold a single 4x4 matrix.
-    mvpBuffer                 = Device::get().createUniformBuffer( nullptr, sizeof( glm::mat4 ) );
     textureUnlitPipelineState = std::make_unique<TextureUnlitPipelineState>();
     textureLitPipelineState   = std::make_unique<TextureLitPipelineState>();
+    lightCullingPipelineState = std::make_unique<LightCullingPipelineState>();
 
     cameraController = std::make_unique<CameraController>( camera, glm::vec3 { 38.5, 14, 0 }, glm::vec3 { 0, 90, 0 } );
 
@@ -153,13 +249,39 @@ void init()
     onResize( WINDOW_WIDTH, WINDOW_HEIGHT );
 
     albedoTexture = Device::get().loadTexture( "assets/textures/webgpu.png" );
-    cubeMesh      = Device::get().createCube( 5.0f );
-    sphereMesh    = Device::get().createSphere( 0.5f );
-    scene         = Device::get().loadScene( "assets/crytek-sponza/sponza_nobanner.obj" );
+    cubeMesh      = Device::get().createCube( 5.0f, false, VertexLayout::PositionPackedNormalTangentTexture );
+    sphereMesh    = Device::get().createSphere( 0.5f, 16, false, VertexLayout::PositionPackedNormalTangentTexture );
+
+    // Block compress the scene textures to reduce the memory footprint of the scene.
+    TextureLoadOptions sceneTextureOptions {};
+    sceneTextureOptions.compress = true;
+    scene = Device::get().loadScene( "assets/crytek-sponza/sponza_nobanner.obj", sceneTextureOptions,
+                                     VertexLayout::PositionPackedNormalTangentTexture );
 
     // Scale the root node
     scene->getRootNode()->setLocalTransform( glm::scale( glm::mat4 { 1 }, glm::vec3 { 0.1f } ) );
 
+    if ( gpuCulling )
+        gpuScene = std::make_unique<GPUScene>();
+
+    if ( occlusionCulling )
+        hiZPyramid = std::make_unique<HiZPyramid>();
+
+    // The camera and light buffers are updated every frame, so the scene can be recorded in a render bundle.
+    pointLights.resize( 5 );
+    cameraBuffer      = Device::get().createUniformBuffer( CameraMatrices {} );
+    pointLightsBuffer = Device::get().createStorageBuffer( pointLights );
+
+    // Storage buffer bindings can't be empty, so there is always room for at least one spot light.
+    spotLightsBuffer = Device::get().createStorageBuffer( nullptr, std::max<size_t>( spotLights.size(), 1 ),
+                                                          sizeof( SpotLight ) );
+
+    // The light culling compute shader writes the lights of each cluster to these buffers.
+    clusterParametersBuffer   = Device::get().createUniformBuffer( clusterParameters );
+    clusterLightCountsBuffer  = Device::get().createStorageBuffer( nullptr, CLUSTER_COUNT, sizeof( uint32_t ) * 2 );
+    clusterLightIndicesBuffer = Device::get().createStorageBuffer( nullptr, CLUSTER_COUNT * MAX_LIGHTS_PER_CLUSTER,
+                                                                   sizeof( uint32_t ) );
+
     // Setup the texture sampler.
     WGPUSamplerDescriptor linearRepeatSamplerDesc {};
     linearRepeatSamplerDesc.label         = "Linear Repeat Sampler";
@@ -177,110 +299,367 @@ void init()
     linearRepeatSampler = Device::get().createSampler( linearRepeatSamplerDesc );
 }
 
-void bindTexture( std::shared_ptr<GraphicsCommandBuffer> commandBuffer, int groupIndex, int binding,
+void bindTexture( std::shared_ptr<CommandBuffer> commandBuffer, int groupIndex, int binding,
                   std::shared_ptr<Texture> texture )
 {
     const auto view = texture ? texture->getView() : Device::get().getDefaultWhiteTexture()->getView();
     commandBuffer->bindTexture( groupIndex, binding, *( view ) );
 }
 
-void renderNode( std::shared_ptr<GraphicsCommandBuffer> commandBuffer, std::shared_ptr<SceneNode> node )
+void bindTextureSet( std::shared_ptr<CommandBuffer> commandBuffer, const RenderQueue::TextureSet& textureSet )
 {
-    auto worldMatrix      = node->getWorldTransform();
-    auto viewMatrix       = camera.getViewMatrix();
-    auto projectionMatrix = camera.getProjectionMatrix();
-
-    Matrices matrices;
-    matrices.model               = worldMatrix;
-    matrices.modelView           = viewMatrix * worldMatrix;
-    matrices.modelViewIT         = transpose( inverse( matrices.modelView ) );
-    matrices.modelViewProjection = projectionMatrix * viewMatrix * worldMatrix;
+    auto texture = [&textureSet]( TextureSlot slot ) { return textureSet[static_cast<std::size_t>( slot )]; };
+
+    bindTexture( commandBuffer, 0, 2, texture( TextureSlot::Ambient ) );
+    bindTexture( commandBuffer, 0, 3, texture( TextureSlot::Emissive ) );
+    bindTexture( commandBuffer, 0, 4, texture( TextureSlot::Diffuse ) );
+    bindTexture( commandBuffer, 0, 5, texture( TextureSlot::Specular ) );
+    bindTexture( commandBuffer, 0, 6, texture( TextureSlot::SpecularPower ) );
+    bindTexture( commandBuffer, 0, 7, texture( TextureSlot::Normal ) );
+    bindTexture( commandBuffer, 0, 8, texture( TextureSlot::Bump ) );
+    bindTexture( commandBuffer, 0, 9, texture( TextureSlot::Opacity ) );
+}
 
-    commandBuffer->bindDynamicUniformBuffer( 0, 0, matrices );
+// Bind the camera, lights, and sampler that are shared by all draws of the scene.
+void bindSceneParameters( std::shared_ptr<CommandBuffer> commandBuffer )
+{
+    commandBuffer->bindBuffer( 0, 11, *pointLightsBuffer );
+    commandBuffer->bindBuffer( 0, 12, *cameraBuffer );
+    commandBuffer->bindBuffer( 0, 13, *spotLightsBuffer );
+    commandBuffer->bindBuffer( 0, 14, *clusterParametersBuffer );
+    commandBuffer->bindBuffer( 0, 15, *clusterLightCountsBuffer );
+    commandBuffer->bindBuffer( 0, 16, *clusterLightIndicesBuffer );
     commandBuffer->bindSampler( 0, 10, *linearRepeatSampler );
+}
+
+// Record the meshes of a scene cell into a render bundle. The bundle only needs to be recorded
+// again if a transform, material, or pipeline that it uses changes.
+std::shared_ptr<RenderBundle> recordScene( const RenderTarget& renderTarget, SceneCell& cell )
+{
+    const auto commandBuffer = Device::get().getQueue()->createRenderBundleCommandBuffer( renderTarget );
+
+    commandBuffer->setGraphicsPipeline( *textureLitPipelineState );
 
-    for ( auto& mesh: node->getMeshes() )
+    bindSceneParameters( commandBuffer );
+
+    // Sort the visible meshes by texture set and material (then front to back), so the
+    // textures, material properties, and matrices are only bound when they change.
+    renderQueue.clear( camera.getViewMatrix() );
+    for ( const auto& visibleMesh: cell.meshes )
+        renderQueue.add( visibleMesh );
+
+    renderQueue.sort();
+
+    const SceneNode* currentNode       = nullptr;
+    uint32_t         currentMaterial   = ~0u;
+    uint32_t         currentTextureSet = ~0u;
+
+    for ( const auto& packet: renderQueue.getDrawPackets() )
     {
-        const auto material = mesh->getMaterial();
+        if ( packet.node != currentNode )
+        {
+            currentNode = packet.node;
+
+            Matrices matrices;
+            matrices.model   = currentNode->getWorldTransform();
+            matrices.modelIT = transpose( currentNode->getInverseWorldTransform() );
+
+            commandBuffer->addDependency( currentNode->shared_from_this() );
+            commandBuffer->bindDynamicStorageBuffer( 0, 0, &matrices, 1, sizeof( Matrices ) );
+        }
+
+        if ( packet.material != currentMaterial )
+        {
+            currentMaterial = packet.material;
+
+            const auto& material = renderQueue.getMaterial( currentMaterial );
+            commandBuffer->addDependency( material );
+            commandBuffer->bindDynamicUniformBuffer( 0, 1, material->getProperties() );
+        }
+
+        if ( packet.textureSet != currentTextureSet )
+        {
+            currentTextureSet = packet.textureSet;
+            bindTextureSet( commandBuffer, renderQueue.getTextureSet( currentTextureSet ) );
+        }
+
+        commandBuffer->draw( *packet.mesh );
+    }
+
+    cell.statistics = commandBuffer->getStatistics();
+
+    return commandBuffer->finishBundle();
+}
+
+// Add the meshes of a node and its children to the cells of the scene grid.
+void addToSceneCells( const SceneNode& node, const BoundingBox& sceneBounds, std::vector<SceneCell>& cells )
+{
+    const glm::vec3 sceneSize = sceneBounds.max - sceneBounds.min;
 
-        commandBuffer->bindDynamicUniformBuffer( 0, 1, material->getProperties() );
+    for ( const auto& mesh: node.getMeshes() )
+    {
+        const BoundingBox bounds = mesh->getBoundingBox().transform( node.getWorldTransform() );
+        const glm::vec3   center = bounds.getCenter();
 
-        bindTexture( commandBuffer, 0, 2, material->getTexture( TextureSlot::Ambient ) );
-        bindTexture( commandBuffer, 0, 3, material->getTexture( TextureSlot::Emissive ) );
-        bindTexture( commandBuffer, 0, 4, material->getTexture( TextureSlot::Diffuse ) );
-        bindTexture( commandBuffer, 0, 5, material->getTexture( TextureSlot::Specular ) );
-        bindTexture( commandBuffer, 0, 6, material->getTexture( TextureSlot::SpecularPower ) );
-        bindTexture( commandBuffer, 0, 7, material->getTexture( TextureSlot::Normal ) );
-        bindTexture( commandBuffer, 0, 8, material->getTexture( TextureSlot::Bump ) );
-        bindTexture( commandBuffer, 0, 9, material->getTexture( TextureSlot::Opacity ) );
+        // The mesh is assigned to the cell that contains the center of its bounds.
+        uint32_t cell = 0;
+        for ( int axis = 3; axis-- > 0; )
+        {
+            const float position = sceneSize[axis] > 0.0f ? ( center[axis] - sceneBounds.min[axis] ) / sceneSize[axis]
+                                                           : 0.0f;
+            const auto  c = static_cast<uint32_t>( std::clamp( position * static_cast<float>( SceneCellGridSize ),
+                                                               0.0f, static_cast<float>( SceneCellGridSize - 1 ) ) );
+            cell          = cell * SceneCellGridSize + c;
+        }
 
-        commandBuffer->draw( *mesh );
+        cells[cell].bounds.merge( bounds );
+        cells[cell].meshes.push_back( { node.shared_from_this(), mesh } );
     }
 
-    for ( auto& child: node->getChildren() )
+    for ( const auto& child: node.getChildren() )
+        addToSceneCells( *child, sceneBounds, cells );
+}
+
+// Divide the meshes of the scene into the cells of the scene grid. Empty cells are removed.
+void buildSceneCells()
+{
+    const auto& root = *scene->getRootNode();
+
+    sceneCells.clear();
+    sceneCells.resize( SceneCellGridSize * SceneCellGridSize * SceneCellGridSize );
+    addToSceneCells( root, root.getWorldBounds(), sceneCells );
+
+    sceneCells.erase( std::remove_if( sceneCells.begin(), sceneCells.end(),
+                                      []( const SceneCell& cell ) { return cell.meshes.empty(); } ),
+                      sceneCells.end() );
+
+    sceneCellsGraph   = root.getSceneGraph().get();
+    sceneCellsVersion = sceneCellsGraph->getVersion();
+}
+
+// Record the indirect draws of a culling phase of the GPU scene into a render bundle. The culling pass writes
+// the instance counts and the matrices of the visible instances every frame, so the bundle only needs to be
+// recorded again when the draws of the GPU scene change.
+std::shared_ptr<RenderBundle> recordGPUScene( const RenderTarget& renderTarget, CullPhase phase )
+{
+    const auto commandBuffer = Device::get().getQueue()->createRenderBundleCommandBuffer( renderTarget );
+
+    commandBuffer->setGraphicsPipeline( *textureLitPipelineState );
+
+    bindSceneParameters( commandBuffer );
+
+    // The draws are sorted by material.
+    const Material* currentMaterial = nullptr;
+
+    for ( const auto& draw: gpuScene->getDraws() )
     {
-        renderNode( commandBuffer, node );
+        const auto material = draw.mesh->getMaterial();
+        if ( material.get() != currentMaterial )
+        {
+            currentMaterial = material.get();
+
+            RenderQueue::TextureSet textureSet;
+            for ( std::size_t slot = 0; slot < textureSet.size(); ++slot )
+                textureSet[slot] = material->getTexture( static_cast<TextureSlot>( slot ) );
+
+            commandBuffer->addDependency( material );
+            commandBuffer->bindDynamicUniformBuffer( 0, 1, material->getProperties() );
+            bindTextureSet( commandBuffer, textureSet );
+        }
+
+        // The vertex shader reads the visible instances of the draw with the instance index.
+        commandBuffer->bindBufferDynamic( 0, 0, *gpuScene->getVisibleInstanceBuffer( phase ), draw.instanceOffset,
+                                          gpuScene->getInstanceBindingSize() );
+        commandBuffer->drawIndirect( *draw.mesh, *gpuScene->getIndirectBuffer( phase ), draw.indirectOffset );
     }
+
+    auto& statistics = phase == CullPhase::Late ? lateSceneBundleStatistics : sceneBundleStatistics;
+    statistics       = commandBuffer->getStatistics();
+
+    return commandBuffer->finishBundle();
+}
+
+size_t countMeshes( const SceneNode& node )
+{
+    size_t count = node.getMeshes().size();
+    for ( auto& child: node.getChildren() )
+        count += countMeshes( *child );
+
+    return count;
+}
+
+void printStatistics( const char* name, const CommandBuffer::Statistics& statistics )
+{
+    std::cout << name << ": " << statistics.drawCount << " draws, set/skipped: " << statistics.pipelinesSet << "/"
+              << statistics.pipelinesSkipped << " pipelines, " << statistics.bindGroupsSet << "/"
+              << statistics.bindGroupsSkipped << " bind groups, " << statistics.vertexBuffersSet << "/"
+              << statistics.vertexBuffersSkipped << " vertex buffers, " << statistics.indexBuffersSet << "/"
+              << statistics.indexBuffersSkipped << " index buffers" << std::endl;
+}
+
+void addStatistics( CommandBuffer::Statistics& statistics, const CommandBuffer::Statistics& other )
+{
+    statistics.pipelinesSet += other.pipelinesSet;
+    statistics.pipelinesSkipped += other.pipelinesSkipped;
+    statistics.bindGroupsSet += other.bindGroupsSet;
+    statistics.bindGroupsSkipped += other.bindGroupsSkipped;
+    statistics.vertexBuffersSet += other.vertexBuffersSet;
+    statistics.vertexBuffersSkipped += other.vertexBuffersSkipped;
+    statistics.indexBuffersSet += other.indexBuffersSet;
+    statistics.indexBuffersSkipped += other.indexBuffersSkipped;
+    statistics.drawCount += other.drawCount;
+}
+
+void saveOffscreenImage()
+{
+    auto colorTexture = Device::get().getOffscreenColorTexture();
+    auto desc         = colorTexture->getWGPUTextureDescriptor();
+    auto pixels       = Device::get().getQueue()->readTexture( *colorTexture );
+
+    if ( pixels.empty() )
+        return;
+
+    const int width  = static_cast<int>( desc.size.width );
+    const int height = static_cast<int>( desc.size.height );
+
+    if ( stbi_write_png( headlessOutputFile, width, height, 4, pixels.data(), width * 4 ) )
+        std::cout << "Saved frame " << frameCount << " to " << headlessOutputFile << std::endl;
+    else
+        std::cerr << "Failed to write " << headlessOutputFile << std::endl;
+}
+
+// Assign the lights to the clusters of the view frustum.
+void cullLights()
+{
+    const auto queue         = Device::get().getQueue();
+    const auto commandBuffer = queue->createComputeCommandBuffer( "Light Culling" );
+
+    commandBuffer->setComputePipeline( *lightCullingPipelineState );
+
+    commandBuffer->bindBuffer( 0, 0, *clusterParametersBuffer );
+    commandBuffer->bindBuffer( 0, 1, *pointLightsBuffer );
+    commandBuffer->bindBuffer( 0, 2, *spotLightsBuffer );
+    commandBuffer->bindBuffer( 0, 3, *clusterLightCountsBuffer );
+    commandBuffer->bindBuffer( 0, 4, *clusterLightIndicesBuffer );
+
+    commandBuffer->dispatch( DivideByMultiple( CLUSTER_GRID_X, LIGHT_CULLING_GROUP_SIZE ),
+                             DivideByMultiple( CLUSTER_GRID_Y, LIGHT_CULLING_GROUP_SIZE ),
+                             DivideByMultiple( CLUSTER_GRID_Z, LIGHT_CULLING_GROUP_SIZE ) );
+
+    queue->submit( *commandBuffer );
 }
 
 void render()
 {
+    cullLights();
+
+    // With occlusion culling, only the instances that were visible in the previous frame are drawn first.
+    if ( gpuScene && hiZPyramid )
+        gpuScene->cullEarly( viewFrustum );
+    else if ( gpuScene )
+        gpuScene->cull( viewFrustum );
+
     auto surface = Device::get().getSurface();
 
+    // In headless mode, resolve into the device's offscreen color texture instead of the surface.
+    auto resolveTarget =
+        surface ? surface->getNextTextureView() : Device::get().getOffscreenColorTexture()->getView();
+
     RenderTarget renderTarget;
-    renderTarget.attachTexture( AttachmentPoint::Color0, colorTextureView, surface->getNextTextureView() );
+    renderTarget.attachTexture( AttachmentPoint::Color0, colorTextureView, resolveTarget );
     renderTarget.attachTexture( AttachmentPoint::DepthStencil, depthTextureView );
 
     const auto queue = Device::get().getQueue();
 
     const auto commandBuffer = queue->createGraphicsCommandBuffer( renderTarget, ClearFlags::Color | ClearFlags::Depth,
-                                                                   { 0.4f, 0.6f, 0.9f, 1.0f }, 1.0f );
+                                                                   { 0.4f, 0.6f, 0.9f, 1.0f }, 1.0f, 0, "Scene" );
 
     // Set the pipeline state.
     commandBuffer->setGraphicsPipeline( *textureUnlitPipelineState );
 
     // Bind parameters.
-    commandBuffer->bindBuffer( 0, 0, *mvpBuffer );
-    commandBuffer->bindDynamicUniformBuffer( 0, 1, glm::vec4 { 1 } );
+    commandBuffer->bindBuffer( 0, 0, *cameraBuffer );
     commandBuffer->bindTexture( 0, 2, *albedoTexture->getView() );
     commandBuffer->bindSampler( 0, 3, *linearRepeatSampler );
 
-    commandBuffer->draw( *cubeMesh );
-
-    glm::mat4 viewMatrix = camera.getViewMatrix();
-    glm::mat4 projectionMatrix = camera.getProjectionMatrix();
+    std::vector<InstanceData> instances { { cubeTransform, glm::vec4 { 1 } } };
+    commandBuffer->drawInstanced( *cubeMesh, 0, 1, instances );
 
     commandBuffer->bindTexture( 0, 2, *( Device::get().getDefaultWhiteTexture()->getView() ) );
 
-    // Draw a sphere for each point light.
-    for (auto& p : pointLights)
+    // Draw the spheres for all visible point lights with a single instanced draw.
+    instances.clear();
+    for ( auto& p: pointLights )
     {
-        
         glm::mat4 worldMatrix = glm::translate( glm::mat4 { 1.0f }, glm::vec3 { p.positionWS } );
-        glm::mat4 mvp         = projectionMatrix * viewMatrix * worldMatrix;
 
-        commandBuffer->bindDynamicUniformBuffer( 0, 0, mvp );
-        commandBuffer->bindDynamicUniformBuffer( 0, 1, p.color );
-
-        commandBuffer->draw( *sphereMesh );
+        if ( viewFrustum.intersects( sphereMesh->getBoundingBox().transform( worldMatrix ) ) )
+            instances.push_back( { worldMatrix, p.color } );
     }
 
-    commandBuffer->setGraphicsPipeline( *textureLitPipelineState );
-
-    commandBuffer->bindDynamicStorageBuffer( 0, 11, pointLights );
-    //commandBuffer->bindDynamicStorageBuffer( 0, 12, spotLights );
+    commandBuffer->drawInstanced( *sphereMesh, 0, 1, instances );
 
     // Render the scene.
-    renderNode( commandBuffer, scene->getRootNode() );
+    if ( gpuScene )
+    {
+        if ( !sceneBundle || !sceneBundle->isValid() )
+            sceneBundle = recordGPUScene( renderTarget, CullPhase::Early );
+
+        commandBuffer->executeBundle( *sceneBundle );
+    }
+    else
+    {
+        visibleCellBundles.clear();
+        for ( auto cell: visibleCells )
+        {
+            if ( !cell->bundle || !cell->bundle->isValid() )
+                cell->bundle = recordScene( renderTarget, *cell );
+
+            visibleCellBundles.push_back( cell->bundle );
+        }
+
+        commandBuffer->executeBundles( visibleCellBundles );
+    }
 
     queue->submit( *commandBuffer );
 
-    surface->present();
+    if ( hiZPyramid )
+    {
+        // Build the Hi-Z pyramid from the depth of the instances that were visible in the previous frame,
+        // then draw the instances that are no longer occluded in a second pass, so they don't pop in a frame late.
+        hiZPyramid->build( *depthTexture );
+        gpuScene->cullLate( viewFrustum, viewProjectionMatrix, *hiZPyramid );
+
+        if ( !lateSceneBundle || !lateSceneBundle->isValid() )
+            lateSceneBundle = recordGPUScene( renderTarget, CullPhase::Late );
+
+        const auto lateCommandBuffer = queue->createGraphicsCommandBuffer( renderTarget, ClearFlags::None, {}, 1.0f, 0,
+                                                                           "Scene (Late)" );
+        lateCommandBuffer->executeBundle( *lateSceneBundle );
+
+        queue->submit( *lateCommandBuffer );
+    }
+
+    if ( surface )
+        surface->present();
+
+    Device::get().endFrame();
 
     // Poll the device to make sure work is done.
     Device::get().poll();
 }
 
+// Print the GPU time of the passes. The timings lag a few frames behind.
+void printGPUTimings()
+{
+    const auto& profiler = Device::get().getGPUProfiler();
+    if ( !profiler.isEnabled() )
+        return;
+
+    for ( const auto& pass: profiler.getPassTimings() )
+        std::cout << "GPU " << pass.name << ": " << pass.milliseconds << " ms" << std::endl;
+}
+
 void pollEvents()
 {
     SDL_Event event;
@@ -320,7 +699,8 @@ void pollEvents()
 void update( void* userdata = nullptr )
 {
     // Handle input.
-    pollEvents();
+    if ( !headless )
+        pollEvents();
 
     timer.tick();
 
@@ -334,6 +714,7 @@ void update( void* userdata = nullptr )
     if ( totalTime > 1.0 )
     {
         std::cout << "FPS: " << frames << std::endl;
+        printGPUTimings();
         totalTime -= 1.0;
         frames = 0;
     }
@@ -346,13 +727,16 @@ void update( void* userdata = nullptr )
     glm::mat4 modelMatrix      = t * r;
     glm::mat4 viewMatrix       = camera.getViewMatrix();
     glm::mat4 projectionMatrix = camera.getProjectionMatrix();
-    glm::mat4 mvpMatrix        = projectionMatrix * viewMatrix * modelMatrix;
 
-    const auto queue = Device::get().getQueue();
-    queue->writeBuffer( *mvpBuffer, mvpMatrix );
+    cubeTransform = modelMatrix;
+
+    CameraMatrices cameraMatrices;
+    cameraMatrices.view           = viewMatrix;
+    cameraMatrices.projection     = projectionMatrix;
+    cameraMatrices.viewProjection = projectionMatrix * viewMatrix;
+    Device::get().getQueue()->writeBuffer( *cameraBuffer, cameraMatrices );
 
     // Update the lights.
-    pointLights.resize( 5 );
 
     glm::vec4 lightPositions[] = {
         { 48.426f, 13.654f, -21.662f, 1.0f },
@@ -391,17 +775,156 @@ void update( void* userdata = nullptr )
         p.positionVS   = viewMatrix * p.positionWS;
     }
 
+    Device::get().getQueue()->writeBuffer( *pointLightsBuffer, pointLights.data(),
+                                           pointLights.size() * sizeof( PointLight ) );
+
+    for ( auto& s: spotLights )
+    {
+        s.positionVS  = viewMatrix * s.positionWS;
+        s.directionVS = viewMatrix * s.directionWS;
+    }
+
+    if ( !spotLights.empty() )
+    {
+        Device::get().getQueue()->writeBuffer( *spotLightsBuffer, spotLights.data(),
+                                               spotLights.size() * sizeof( SpotLight ) );
+    }
+
+    clusterParameters.inverseProjection = glm::inverse( projectionMatrix );
+    clusterParameters.pointLightCount   = static_cast<uint32_t>( pointLights.size() );
+    clusterParameters.spotLightCount    = static_cast<uint32_t>( spotLights.size() );
+    Device::get().getQueue()->writeBuffer( *clusterParametersBuffer, clusterParameters );
+
+    // Update the world transforms of the scene nodes that have changed.
+    scene->getRootNode()->updateWorldTransforms();
+
+    // Cull the scene against the view frustum.
+    viewFrustum          = Frustum { cameraMatrices.viewProjection };
+    viewProjectionMatrix = cameraMatrices.viewProjection;
+
+    if ( gpuScene )
+    {
+        // The instances are culled on the GPU, so the scene bundle is only recorded again if the draws have changed.
+        if ( gpuScene->update( *scene->getRootNode() ) )
+        {
+            sceneBundle.reset();
+            lateSceneBundle.reset();
+        }
+    }
+    else
+    {
+        // The cells are only built again if the scene graph has changed.
+        const auto& sceneGraph = scene->getRootNode()->getSceneGraph();
+        if ( sceneCellsGraph != sceneGraph.get() || sceneCellsVersion != sceneGraph->getVersion() )
+            buildSceneCells();
+
+        visibleCells.clear();
+        for ( auto& cell: sceneCells )
+        {
+            if ( viewFrustum.intersects( cell.bounds ) )
+                visibleCells.push_back( &cell );
+        }
+    }
+
 
     render();
+
+    if ( headless && ++frameCount >= headlessFrames )
+    {
+        std::cout << "Rendered " << frameCount << " frames in " << timer.totalSeconds() << " s ("
+                  << timer.totalSeconds() * 1000.0 / static_cast<double>( frameCount ) << " ms/frame)" << std::endl;
+
+        auto& uploadStatistics = Device::get().getUploadPagePool().getFrameStatistics();
+        std::cout << "Uploaded " << uploadStatistics.allocationCount << " allocations with "
+                  << uploadStatistics.queueWriteCount << " queue writes (" << uploadStatistics.bytesWritten
+                  << " bytes) in the last frame" << std::endl;
+        if ( gpuScene )
+        {
+            std::cout << "Culled " << gpuScene->getInstanceCount() << " instances with "
+                      << gpuScene->getDraws().size() << " indirect draws on the GPU" << std::endl;
+        }
+        else
+        {
+            std::size_t               meshCount = 0;
+            CommandBuffer::Statistics statistics;
+            for ( auto cell: visibleCells )
+            {
+                meshCount += cell->meshes.size();
+                addStatistics( statistics, cell->statistics );
+            }
+
+            std::cout << "Rendered " << meshCount << " of " << countMeshes( *scene->getRootNode() ) << " meshes in "
+                      << visibleCells.size() << " of " << sceneCells.size() << " scene cells in the last frame"
+                      << std::endl;
+            sceneBundleStatistics = statistics;
+        }
+        printStatistics( "Scene bundle", sceneBundleStatistics );
+        if ( hiZPyramid )
+            printStatistics( "Scene bundle (late)", lateSceneBundleStatistics );
+        printGPUTimings();
+
+        saveOffscreenImage();
+        isRunning = false;
+    }
 }
 
 void destroy()
 {
+    sceneBundle.reset();
+    lateSceneBundle.reset();
+    visibleCellBundles.clear();
+    visibleCells.clear();
+    sceneCells.clear();
+    renderQueue.clear( glm::mat4 { 1 } );
+    gpuScene.reset();
+    hiZPyramid.reset();
+
     Device::destroy();
 }
 
-int main()
+int main( int argc, char* argv[] )
 {
+    // Usage: 04-Mesh [--headless [frames]] [--fallback-adapter] [--output file.png] [--gpu-culling]
+    //               [--occlusion-culling]
+    for ( int i = 1; i < argc; ++i )
+    {
+        if ( std::strcmp( argv[i], "--headless" ) == 0 )
+        {
+            headless = true;
+
+            // The frame count is optional, so the next argument is only consumed if it is a number.
+            if ( i + 1 < argc )
+            {
+                const char* first = argv[i + 1];
+                const char* last  = first + std::strlen( first );
+                uint64_t    frames;
+                if ( auto [ptr, ec] = std::from_chars( first, last, frames ); ec == std::errc {} && ptr == last )
+                {
+                    headlessFrames = frames;
+                    ++i;
+                }
+            }
+        }
+        else if ( std::strcmp( argv[i], "--fallback-adapter" ) == 0 )
+        {
+            forceFallbackAdapter = true;
+        }
+        else if ( std::strcmp( argv[i], "--output" ) == 0 && i + 1 < argc )
+        {
+            headlessOutputFile = argv[++i];
+        }
+        else if ( std::strcmp( argv[i], "--gpu-culling" ) == 0 )
+        {
+            gpuCulling = true;
+        }
+        else if ( std::strcmp( argv[i], "--occlusion-culling" ) == 0 )
+        {
+            // Occlusion culling is part of the GPU culling pass.
+            gpuCulling       = true;
+            occlusionCulling = true;
+        }
+    }
+
     init();
 
 #ifdef __EMSCRIPTEN__
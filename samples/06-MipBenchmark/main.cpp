@@ -0,0 +1,159 @@
+// Compares the multi-pass mip generator (up to 4 mips per dispatch) against the
+// single pass downsampler (the full mip chain in one dispatch) for different texture sizes.
+//
+// Usage: 06-MipBenchmark [--iterations N] [--textures N] [--fallback-adapter]
+
+#include <Timer.hpp>
+
+#include <WebGPUlib/Device.hpp>
+#include <WebGPUlib/GPUProfiler.hpp>
+#include <WebGPUlib/Texture.hpp>
+
+#include <algorithm>
+#include <cmath>
+#include <cstring>
+#include <functional>
+#include <iomanip>
+#include <iostream>
+#include <memory>
+#include <string>
+#include <vector>
+
+using namespace WebGPUlib;
+
+constexpr uint32_t TEXTURE_SIZES[] = { 256, 512, 1024, 2048, 4096 };
+
+uint32_t iterations           = 20;
+uint32_t textureCount         = 8;
+bool     forceFallbackAdapter = false;
+
+struct BenchmarkResult
+{
+    double cpuMilliseconds = 0.0;  // Recording, submitting and waiting for the GPU to finish.
+    double gpuMilliseconds = 0.0;  // The GPU time of the passes (if timestamp queries are supported).
+};
+
+std::vector<std::shared_ptr<Texture>> createTextures( uint32_t size, uint32_t count )
+{
+    auto& device = Device::get();
+
+    WGPUTextureDescriptor textureDesc {};
+    textureDesc.label         = "Benchmark Texture";
+    textureDesc.dimension     = WGPUTextureDimension_2D;
+    textureDesc.format        = WGPUTextureFormat_RGBA8Unorm;
+    textureDesc.size          = { size, size, 1 };
+    textureDesc.sampleCount   = 1;
+    textureDesc.mipLevelCount = static_cast<uint32_t>( std::log2( size ) ) + 1;
+    textureDesc.usage = WGPUTextureUsage_TextureBinding | WGPUTextureUsage_StorageBinding | WGPUTextureUsage_CopyDst;
+
+    std::vector<std::shared_ptr<Texture>> textures;
+    for ( uint32_t i = 0; i < count; ++i )
+    {
+        textures.push_back( device.createTexture( textureDesc ) );
+    }
+
+    return textures;
+}
+
+BenchmarkResult runBenchmark( const std::function<void()>& generateMips )
+{
+    auto& device   = Device::get();
+    auto& profiler = device.getGPUProfiler();
+
+    // Warm up (creates the pipelines, bind groups, and texture views).
+    generateMips();
+    device.endFrame();
+    device.waitIdle();
+
+    BenchmarkResult result;
+    Timer           timer;
+
+    for ( uint32_t i = 0; i < iterations; ++i )
+    {
+        timer.reset();
+
+        generateMips();
+        device.endFrame();
+        device.waitIdle();
+
+        timer.tick();
+        result.cpuMilliseconds += timer.totalMilliseconds();
+
+        // Wait for the pass timings of this iteration.
+        while ( profiler.hasPendingReadbacks() )
+        {
+            device.poll( true );
+        }
+
+        for ( auto& passTiming: profiler.getPassTimings() )
+        {
+            result.gpuMilliseconds += passTiming.milliseconds;
+        }
+    }
+
+    result.cpuMilliseconds /= iterations;
+    result.gpuMilliseconds /= iterations;
+
+    return result;
+}
+
+int main( int argc, char* argv[] )
+{
+    for ( int i = 1; i < argc; ++i )
+    {
+        if ( std::strcmp( argv[i], "--iterations" ) == 0 && i + 1 < argc )
+        {
+            iterations = std::max( 1, std::stoi( argv[++i] ) );
+        }
+        else if ( std::strcmp( argv[i], "--textures" ) == 0 && i + 1 < argc )
+        {
+            textureCount = std::max( 1, std::stoi( argv[++i] ) );
+        }
+        else if ( std::strcmp( argv[i], "--fallback-adapter" ) == 0 )
+        {
+            forceFallbackAdapter = true;
+        }
+    }
+
+    Device::createHeadless( 64, 64, forceFallbackAdapter );
+
+    auto& device = Device::get();
+
+    if ( !device.isSinglePassMipsSupported() )
+        std::cout << "WARNING: The device does not support enough storage textures per shader stage. "
+                     "The single pass downsampler falls back to the multi-pass path."
+                  << std::endl;
+
+    if ( !device.getGPUProfiler().isEnabled() )
+        std::cout << "WARNING: Timestamp queries are not supported. Only CPU times are reported." << std::endl;
+
+    std::cout << "Generating mips for " << textureCount << " textures, averaged over " << iterations
+              << " iterations." << std::endl;
+    std::cout << std::setw( 10 ) << "Size" << std::setw( 22 ) << "Multi-pass CPU (ms)" << std::setw( 22 )
+              << "Multi-pass GPU (ms)" << std::setw( 24 ) << "Single pass CPU (ms)" << std::setw( 24 )
+              << "Single pass GPU (ms)" << std::endl;
+
+    std::cout << std::fixed << std::setprecision( 3 );
+
+    for ( uint32_t size: TEXTURE_SIZES )
+    {
+        auto textures = createTextures( size, textureCount );
+
+        std::vector<Texture*> texturePointers;
+        for ( auto& texture: textures )
+        {
+            texturePointers.push_back( texture.get() );
+        }
+
+        auto multiPass  = runBenchmark( [&] { device.generateMips( texturePointers ); } );
+        auto singlePass = runBenchmark( [&] { device.generateMipsSinglePass( texturePointers ); } );
+
+        std::cout << std::setw( 10 ) << ( std::to_string( size ) + "^2" ) << std::setw( 22 )
+                  << multiPass.cpuMilliseconds << std::setw( 22 ) << multiPass.gpuMilliseconds << std::setw( 24 )
+                  << singlePass.cpuMilliseconds << std::setw( 24 ) << singlePass.gpuMilliseconds << std::endl;
+    }
+
+    Device::destroy();
+
+    return 0;
+}